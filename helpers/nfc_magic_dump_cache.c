@@ -0,0 +1,246 @@
+#include "nfc_magic_dump_cache.h"
+
+#include <furi.h>
+#include <toolbox/path.h>
+#include <nfc/protocols/mf_classic/mf_classic.h>
+#include <nfc/protocols/mf_ultralight/mf_ultralight.h>
+
+#include "../magic/protocols/nfc_magic_resume.h"
+
+#define TAG "NfcMagicDumpCache"
+
+#define NFC_MAGIC_DUMP_CACHE_MAGIC (0x434D464EU)
+#define NFC_MAGIC_DUMP_CACHE_VERSION (3)
+#define NFC_MAGIC_DUMP_CACHE_EXTENSION ".cache"
+#define NFC_MAGIC_DUMP_CACHE_HASH_CHUNK_SIZE (256U)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t protocol;
+    uint32_t source_timestamp;
+    uint64_t source_size;
+    // Timestamps only have a 2 s resolution on FAT, an edit within that window is caught here
+    uint32_t source_hash;
+    // Raw structs are stored, so a firmware with another layout must not pick them up
+    uint32_t iso3_data_size;
+    uint32_t data_size;
+    // Binary body as written, a torn or corrupted cache must not be taken for the dump
+    uint32_t body_hash;
+} FURI_PACKED NfcMagicDumpCacheHeader;
+
+static void nfc_magic_dump_cache_get_path(const char* path, FuriString* cache_path) {
+    FuriString* file_name = furi_string_alloc();
+
+    path_extract_dirname(path, cache_path);
+    path_extract_filename(path, file_name, false);
+    furi_string_cat_printf(
+        cache_path, "/.%s%s", furi_string_get_cstr(file_name), NFC_MAGIC_DUMP_CACHE_EXTENSION);
+
+    furi_string_free(file_name);
+}
+
+static bool
+    nfc_magic_dump_cache_get_source_hash(Storage* storage, const char* path, uint32_t* hash) {
+    bool hashed = false;
+    File* file = storage_file_alloc(storage);
+    uint8_t* chunk = malloc(NFC_MAGIC_DUMP_CACHE_HASH_CHUNK_SIZE);
+
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        // Reading the text is cheap next to parsing it, which is what the cache saves
+        *hash = NFC_MAGIC_RESUME_HASH_INIT;
+        size_t read = 0;
+        do {
+            read = storage_file_read(file, chunk, NFC_MAGIC_DUMP_CACHE_HASH_CHUNK_SIZE);
+            *hash = nfc_magic_resume_hash(*hash, chunk, read);
+        } while(read == NFC_MAGIC_DUMP_CACHE_HASH_CHUNK_SIZE);
+        hashed = (storage_file_get_error(file) == FSE_OK);
+    }
+
+    free(chunk);
+    storage_file_free(file);
+
+    return hashed;
+}
+
+static uint32_t nfc_magic_dump_cache_get_body_hash(
+    const Iso14443_3aData* iso3_data,
+    const NfcDeviceData* data,
+    const NfcMagicDumpCacheHeader* header) {
+    uint32_t hash = NFC_MAGIC_RESUME_HASH_INIT;
+
+    hash = nfc_magic_resume_hash(hash, iso3_data, header->iso3_data_size);
+    hash = nfc_magic_resume_hash(hash, data, header->data_size);
+
+    return hash;
+}
+
+static size_t nfc_magic_dump_cache_get_data_size(NfcProtocol protocol) {
+    size_t data_size = 0;
+
+    if(protocol == NfcProtocolMfClassic) {
+        data_size = sizeof(MfClassicData);
+    } else if(protocol == NfcProtocolMfUltralight) {
+        data_size = sizeof(MfUltralightData);
+    }
+
+    return data_size;
+}
+
+static bool nfc_magic_dump_cache_fill_header(
+    Storage* storage,
+    const char* path,
+    NfcProtocol protocol,
+    NfcMagicDumpCacheHeader* header) {
+    bool filled = false;
+
+    do {
+        size_t data_size = nfc_magic_dump_cache_get_data_size(protocol);
+        if(data_size == 0) break;
+
+        FileInfo file_info = {};
+        if(storage_common_stat(storage, path, &file_info) != FSE_OK) break;
+        uint32_t timestamp = 0;
+        if(storage_common_timestamp(storage, path, &timestamp) != FSE_OK) break;
+        uint32_t hash = 0;
+        if(!nfc_magic_dump_cache_get_source_hash(storage, path, &hash)) break;
+
+        header->magic = NFC_MAGIC_DUMP_CACHE_MAGIC;
+        header->version = NFC_MAGIC_DUMP_CACHE_VERSION;
+        header->protocol = protocol;
+        header->source_timestamp = timestamp;
+        header->source_size = file_info.size;
+        header->source_hash = hash;
+        header->iso3_data_size = sizeof(Iso14443_3aData);
+        header->data_size = data_size;
+        filled = true;
+    } while(false);
+
+    return filled;
+}
+
+static void nfc_magic_dump_cache_reset_device(NfcDevice* device, NfcProtocol protocol) {
+    // Only an empty record is copied here, it is freed before the cache is read
+    if(protocol == NfcProtocolMfClassic) {
+        MfClassicData* mfc_data = mf_classic_alloc();
+        nfc_device_set_data(device, protocol, mfc_data);
+        mf_classic_free(mfc_data);
+    } else {
+        MfUltralightData* mfu_data = mf_ultralight_alloc();
+        nfc_device_set_data(device, protocol, mfu_data);
+        mf_ultralight_free(mfu_data);
+    }
+}
+
+bool nfc_magic_dump_cache_load(Storage* storage, const char* path, NfcDevice* device) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(device);
+
+    bool loaded = false;
+    FuriString* cache_path = furi_string_alloc();
+    File* file = storage_file_alloc(storage);
+
+    do {
+        nfc_magic_dump_cache_get_path(path, cache_path);
+        if(!storage_file_open(
+               file, furi_string_get_cstr(cache_path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+
+        NfcMagicDumpCacheHeader header = {};
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+
+        NfcMagicDumpCacheHeader expected = {};
+        if(!nfc_magic_dump_cache_fill_header(storage, path, header.protocol, &expected)) break;
+        // Checked against the body once it is read
+        expected.body_hash = header.body_hash;
+        if(memcmp(&header, &expected, sizeof(header)) != 0) {
+            FURI_LOG_D(TAG, "Cache is stale");
+            break;
+        }
+
+        // Read straight into the data the device holds, the record is not copied again
+        if(nfc_device_get_protocol(device) != header.protocol) {
+            nfc_magic_dump_cache_reset_device(device, header.protocol);
+        }
+        NfcDeviceData* data = (NfcDeviceData*)nfc_device_get_data(device, header.protocol);
+        Iso14443_3aData* iso3_data = NULL;
+        if(header.protocol == NfcProtocolMfClassic) {
+            iso3_data = ((MfClassicData*)data)->iso14443_3a_data;
+        } else {
+            iso3_data = ((MfUltralightData*)data)->iso14443_3a_data;
+        }
+
+        loaded = (storage_file_read(file, iso3_data, header.iso3_data_size) ==
+                  header.iso3_data_size) &&
+                 (storage_file_read(file, data, header.data_size) == header.data_size);
+        if(!loaded) {
+            FURI_LOG_E(TAG, "Cache is truncated");
+        } else if(
+            nfc_magic_dump_cache_get_body_hash(iso3_data, data, &header) != header.body_hash) {
+            FURI_LOG_E(TAG, "Cache is corrupted");
+            loaded = false;
+        }
+
+        // The raw struct carries the pointer of the process that saved it
+        if(header.protocol == NfcProtocolMfClassic) {
+            ((MfClassicData*)data)->iso14443_3a_data = iso3_data;
+        } else {
+            ((MfUltralightData*)data)->iso14443_3a_data = iso3_data;
+        }
+
+        // The caller parses the text instead and writes a fresh cache
+        if(!loaded) {
+            nfc_device_clear(device);
+        }
+    } while(false);
+
+    storage_file_free(file);
+    furi_string_free(cache_path);
+
+    return loaded;
+}
+
+void nfc_magic_dump_cache_save(Storage* storage, const char* path, const NfcDevice* device) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(device);
+
+    FuriString* cache_path = furi_string_alloc();
+    File* file = storage_file_alloc(storage);
+
+    do {
+        NfcProtocol protocol = nfc_device_get_protocol(device);
+        NfcMagicDumpCacheHeader header = {};
+        if(!nfc_magic_dump_cache_fill_header(storage, path, protocol, &header)) break;
+
+        const NfcDeviceData* data = nfc_device_get_data(device, protocol);
+        const Iso14443_3aData* iso3_data = NULL;
+        if(protocol == NfcProtocolMfClassic) {
+            iso3_data = ((const MfClassicData*)data)->iso14443_3a_data;
+        } else {
+            iso3_data = ((const MfUltralightData*)data)->iso14443_3a_data;
+        }
+        header.body_hash = nfc_magic_dump_cache_get_body_hash(iso3_data, data, &header);
+
+        nfc_magic_dump_cache_get_path(path, cache_path);
+        const char* cache_path_cstr = furi_string_get_cstr(cache_path);
+        if(!storage_file_open(file, cache_path_cstr, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+
+        bool saved = (storage_file_write(file, &header, sizeof(header)) == sizeof(header)) &&
+                     (storage_file_write(file, iso3_data, header.iso3_data_size) ==
+                      header.iso3_data_size) &&
+                     (storage_file_write(file, data, header.data_size) == header.data_size);
+        storage_file_close(file);
+
+        // A truncated cache would only be rejected later, drop it right away
+        if(!saved) {
+            FURI_LOG_E(TAG, "Failed to save cache");
+            storage_simply_remove(storage, cache_path_cstr);
+        }
+    } while(false);
+
+    storage_file_free(file);
+    furi_string_free(cache_path);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <storage/storage.h>
+#include <nfc/nfc_device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary copy of a parsed MIFARE Classic / Ultralight dump, stored as a hidden file next to it.
+// Valid while the dump keeps the modification time, size and content hash it had when the cache
+// was written. The hash covers edits that land within the 2 s timestamp resolution of FAT.
+// A body that does not match its own hash is rejected as well and the dump is parsed again.
+
+bool nfc_magic_dump_cache_load(Storage* storage, const char* path, NfcDevice* device);
+
+void nfc_magic_dump_cache_save(Storage* storage, const char* path, const NfcDevice* device);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#include "nfc_magic_heap_report.h"
+
+#include <furi.h>
+
+#define TAG "NfcMagicHeap"
+
+void nfc_magic_heap_report(const char* scene_name, const char* stage, size_t free_before) {
+    size_t free_after = memmgr_get_free_heap();
+
+    FURI_LOG_D(
+        TAG,
+        "%s %s: %+d bytes, free %zu, max block %zu, low watermark %zu",
+        scene_name,
+        stage,
+        (int)free_before - (int)free_after,
+        free_after,
+        memmgr_heap_get_max_free_block(),
+        memmgr_get_minimum_free_heap());
+}
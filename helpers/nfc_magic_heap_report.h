@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Log heap usage around a scene transition.
+ *
+ * @param scene_name Scene id as a string.
+ * @param stage "enter" or "exit".
+ * @param free_before Free heap sampled right before the transition.
+ */
+void nfc_magic_heap_report(const char* scene_name, const char* stage, size_t free_before);
+
+#ifdef __cplusplus
+}
+#endif
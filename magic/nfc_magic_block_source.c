@@ -0,0 +1,508 @@
+#include "nfc_magic_block_source.h"
+#include "protocols/nfc_magic_resume.h"
+
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+
+#define TAG "NfcMagicBlockSource"
+
+#define NFC_MAGIC_BLOCK_SOURCE_SECTOR_BLOCKS_MAX (16)
+// Same 256 bytes as the largest MIFARE Classic sector
+#define NFC_MAGIC_BLOCK_SOURCE_WINDOW_PAGES_MAX (64)
+
+struct NfcMagicBlockSource {
+    FlipperFormat* ff;
+    FuriString* key;
+    FuriString* str;
+    bool is_open;
+
+    NfcProtocol protocol;
+    Iso14443_3aData iso3_data;
+    MfClassicType type;
+    MfUltralightType mfu_type;
+    uint16_t pages_read;
+    MfUltralightSignature signature;
+    MfUltralightVersion version;
+
+    // Resident window: the sector of the last block or the pages around the last page
+    union {
+        MfClassicBlock sector[NFC_MAGIC_BLOCK_SOURCE_SECTOR_BLOCKS_MAX];
+        MfUltralightPage pages[NFC_MAGIC_BLOCK_SOURCE_WINDOW_PAGES_MAX];
+    };
+    // Blocks of the resident sector that have no unread bytes
+    uint16_t sector_read_mask;
+    uint16_t window_first;
+    uint16_t window_size;
+    bool window_loaded;
+    // Keys are only searched forward, going back to an earlier block or page needs a rewind
+    uint16_t next_unit;
+
+    uint32_t hash;
+    bool hash_valid;
+};
+
+// Names nfc_device_save writes for the "NTAG/Ultralight type" key
+static const char* const nfc_magic_block_source_mfu_type_names[] = {
+    [MfUltralightTypeOrigin] = "Mifare Ultralight",
+    [MfUltralightTypeNTAG203] = "NTAG203",
+    [MfUltralightTypeMfulC] = "Mifare Ultralight C",
+    [MfUltralightTypeUL11] = "Mifare Ultralight 11",
+    [MfUltralightTypeUL21] = "Mifare Ultralight 21",
+    [MfUltralightTypeNTAG213] = "NTAG213",
+    [MfUltralightTypeNTAG215] = "NTAG215",
+    [MfUltralightTypeNTAG216] = "NTAG216",
+    [MfUltralightTypeNTAGI2C1K] = "NTAG I2C 1K",
+    [MfUltralightTypeNTAGI2C2K] = "NTAG I2C 2K",
+    [MfUltralightTypeNTAGI2CPlus1K] = "NTAG I2C Plus 1K",
+    [MfUltralightTypeNTAGI2CPlus2K] = "NTAG I2C Plus 2K",
+};
+
+NfcMagicBlockSource* nfc_magic_block_source_alloc(Storage* storage) {
+    furi_assert(storage);
+
+    NfcMagicBlockSource* instance = malloc(sizeof(NfcMagicBlockSource));
+    instance->ff = flipper_format_file_alloc(storage);
+    instance->key = furi_string_alloc();
+    instance->str = furi_string_alloc();
+    instance->protocol = NfcProtocolInvalid;
+
+    return instance;
+}
+
+void nfc_magic_block_source_free(NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+
+    nfc_magic_block_source_close(instance);
+    flipper_format_free(instance->ff);
+    furi_string_free(instance->key);
+    furi_string_free(instance->str);
+    free(instance);
+}
+
+static bool nfc_magic_block_source_parse_type(const FuriString* str, MfClassicType* type) {
+    bool parsed = true;
+
+    if(furi_string_equal_str(str, "MINI")) {
+        *type = MfClassicTypeMini;
+    } else if(furi_string_equal_str(str, "1K")) {
+        *type = MfClassicType1k;
+    } else if(furi_string_equal_str(str, "4K")) {
+        *type = MfClassicType4k;
+    } else {
+        parsed = false;
+    }
+
+    return parsed;
+}
+
+static bool
+    nfc_magic_block_source_parse_mfu_type(const FuriString* str, MfUltralightType* mfu_type) {
+    bool parsed = false;
+
+    for(size_t i = 0; i < COUNT_OF(nfc_magic_block_source_mfu_type_names); i++) {
+        const char* name = nfc_magic_block_source_mfu_type_names[i];
+        if(name && furi_string_equal_str(str, name)) {
+            *mfu_type = i;
+            parsed = true;
+            break;
+        }
+    }
+
+    return parsed;
+}
+
+static bool nfc_magic_block_source_open_mf_classic(NfcMagicBlockSource* instance) {
+    bool opened = false;
+
+    do {
+        if(!flipper_format_read_string(instance->ff, "Mifare Classic type", instance->str)) {
+            break;
+        }
+        if(!nfc_magic_block_source_parse_type(instance->str, &instance->type)) break;
+
+        opened = true;
+    } while(false);
+
+    return opened;
+}
+
+static bool nfc_magic_block_source_open_mf_ultralight(NfcMagicBlockSource* instance) {
+    bool opened = false;
+
+    do {
+        // Older formats name the type differently, the full parse still handles those
+        if(!flipper_format_read_string(instance->ff, "NTAG/Ultralight type", instance->str)) {
+            break;
+        }
+        if(!nfc_magic_block_source_parse_mfu_type(instance->str, &instance->mfu_type)) break;
+        if(!flipper_format_read_hex(
+               instance->ff,
+               "Signature",
+               instance->signature.data,
+               sizeof(MfUltralightSignature))) {
+            break;
+        }
+        if(!flipper_format_read_hex(
+               instance->ff,
+               "Mifare version",
+               (uint8_t*)&instance->version,
+               sizeof(MfUltralightVersion))) {
+            break;
+        }
+
+        uint32_t pages_total = 0;
+        uint32_t pages_read = 0;
+        if(!flipper_format_read_uint32(instance->ff, "Pages total", &pages_total, 1)) break;
+        if(!flipper_format_read_uint32(instance->ff, "Pages read", &pages_read, 1)) break;
+        if((pages_read > pages_total) || (pages_total > MF_ULTRALIGHT_MAX_PAGE_NUM)) break;
+        instance->pages_read = pages_read;
+
+        opened = true;
+    } while(false);
+
+    return opened;
+}
+
+bool nfc_magic_block_source_open(NfcMagicBlockSource* instance, const char* path) {
+    furi_assert(instance);
+    furi_assert(path);
+
+    nfc_magic_block_source_close(instance);
+
+    bool opened = false;
+    do {
+        if(!flipper_format_file_open_existing(instance->ff, path)) break;
+
+        uint32_t version = 0;
+        if(!flipper_format_read_header(instance->ff, instance->str, &version)) break;
+        if(!flipper_format_read_string(instance->ff, "Device type", instance->str)) break;
+        if(furi_string_equal_str(instance->str, "Mifare Classic")) {
+            instance->protocol = NfcProtocolMfClassic;
+        } else if(furi_string_equal_str(instance->str, "NTAG/Ultralight")) {
+            instance->protocol = NfcProtocolMfUltralight;
+        } else {
+            break;
+        }
+
+        uint32_t uid_len = 0;
+        if(!flipper_format_get_value_count(instance->ff, "UID", &uid_len)) break;
+        if(uid_len > ISO14443_3A_MAX_UID_SIZE) break;
+        if(!flipper_format_read_hex(instance->ff, "UID", instance->iso3_data.uid, uid_len)) {
+            break;
+        }
+        instance->iso3_data.uid_len = uid_len;
+        if(!flipper_format_read_hex(instance->ff, "ATQA", instance->iso3_data.atqa, 2)) break;
+        if(!flipper_format_read_hex(instance->ff, "SAK", &instance->iso3_data.sak, 1)) break;
+
+        if(instance->protocol == NfcProtocolMfClassic) {
+            if(!nfc_magic_block_source_open_mf_classic(instance)) break;
+        } else {
+            if(!nfc_magic_block_source_open_mf_ultralight(instance)) break;
+        }
+
+        instance->window_loaded = false;
+        instance->next_unit = 0;
+        instance->hash_valid = false;
+        instance->is_open = true;
+        opened = true;
+    } while(false);
+
+    if(!opened) {
+        FURI_LOG_D(TAG, "Can't stream %s", path);
+        instance->protocol = NfcProtocolInvalid;
+        flipper_format_file_close(instance->ff);
+    }
+
+    return opened;
+}
+
+void nfc_magic_block_source_close(NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+
+    if(instance->is_open) {
+        flipper_format_file_close(instance->ff);
+        instance->is_open = false;
+    }
+    instance->protocol = NfcProtocolInvalid;
+    instance->window_loaded = false;
+    instance->hash_valid = false;
+}
+
+bool nfc_magic_block_source_is_open(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+
+    return instance->is_open;
+}
+
+NfcProtocol nfc_magic_block_source_get_protocol(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+
+    return instance->protocol;
+}
+
+const Iso14443_3aData*
+    nfc_magic_block_source_get_iso14443_3a_data(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+
+    return &instance->iso3_data;
+}
+
+MfClassicType nfc_magic_block_source_get_type(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+    furi_assert(instance->protocol == NfcProtocolMfClassic);
+
+    return instance->type;
+}
+
+MfUltralightType nfc_magic_block_source_get_mfu_type(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+    furi_assert(instance->protocol == NfcProtocolMfUltralight);
+
+    return instance->mfu_type;
+}
+
+uint16_t nfc_magic_block_source_get_pages_read(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+    furi_assert(instance->protocol == NfcProtocolMfUltralight);
+
+    return instance->pages_read;
+}
+
+const MfUltralightSignature*
+    nfc_magic_block_source_get_mfu_signature(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+    furi_assert(instance->protocol == NfcProtocolMfUltralight);
+
+    return &instance->signature;
+}
+
+const MfUltralightVersion*
+    nfc_magic_block_source_get_mfu_version(const NfcMagicBlockSource* instance) {
+    furi_assert(instance);
+    furi_assert(instance->protocol == NfcProtocolMfUltralight);
+
+    return &instance->version;
+}
+
+static uint8_t nfc_magic_block_source_hex_nibble(char c) {
+    uint8_t nibble = 0;
+
+    if(c >= '0' && c <= '9') {
+        nibble = c - '0';
+    } else if(c >= 'A' && c <= 'F') {
+        nibble = c - 'A' + 10;
+    } else if(c >= 'a' && c <= 'f') {
+        nibble = c - 'a' + 10;
+    }
+
+    return nibble;
+}
+
+// Unread bytes are stored as "??" and load as zeros, same as nfc_device_load does.
+// Bit i of unread_mask is set when byte i was unread.
+static bool nfc_magic_block_source_parse_hex(
+    const FuriString* str,
+    uint8_t* data,
+    size_t size,
+    uint16_t* unread_mask) {
+    const char* str_data = furi_string_get_cstr(str);
+    size_t len = furi_string_size(str);
+    size_t pos = 0;
+
+    *unread_mask = 0;
+    for(size_t i = 0; i < size; i++) {
+        while((pos < len) && (str_data[pos] == ' ')) {
+            pos++;
+        }
+        if(pos + 2 > len) return false;
+
+        if(str_data[pos] == '?') {
+            data[i] = 0;
+            *unread_mask |= 1U << i;
+        } else {
+            data[i] = (nfc_magic_block_source_hex_nibble(str_data[pos]) << 4) |
+                      nfc_magic_block_source_hex_nibble(str_data[pos + 1]);
+        }
+        pos += 2;
+    }
+
+    return true;
+}
+
+static bool nfc_magic_block_source_is_unit_read(uint16_t unit, uint16_t unread_mask) {
+    // Keys are tracked apart from the trailer, the trailer counts as read with its access bits
+    const uint16_t access_bits_mask = 0x000F << 6;
+
+    return mf_classic_is_sector_trailer(unit) ? ((unread_mask & access_bits_mask) == 0) :
+                                                (unread_mask == 0);
+}
+
+// Loads count blocks or pages starting from first into the resident window
+static bool nfc_magic_block_source_load_window(
+    NfcMagicBlockSource* instance,
+    uint16_t first,
+    uint16_t count) {
+    bool is_mfc = (instance->protocol == NfcProtocolMfClassic);
+    const char* key_prefix = is_mfc ? "Block" : "Page";
+    size_t unit_size = is_mfc ? MF_CLASSIC_BLOCK_SIZE : MF_ULTRALIGHT_PAGE_SIZE;
+    bool loaded = true;
+
+    instance->window_loaded = false;
+    instance->sector_read_mask = 0;
+    if(first < instance->next_unit) {
+        flipper_format_rewind(instance->ff);
+    }
+
+    for(uint16_t i = 0; i < count; i++) {
+        uint8_t* data = is_mfc ? instance->sector[i].data : instance->pages[i].data;
+        uint16_t unread_mask = 0;
+        furi_string_printf(instance->key, "%s %d", key_prefix, first + i);
+        const char* key = furi_string_get_cstr(instance->key);
+        loaded = flipper_format_read_string(instance->ff, key, instance->str) &&
+                 nfc_magic_block_source_parse_hex(instance->str, data, unit_size, &unread_mask);
+        if(!loaded) {
+            FURI_LOG_E(TAG, "Failed to read %s", key);
+            break;
+        }
+        if(is_mfc && nfc_magic_block_source_is_unit_read(first + i, unread_mask)) {
+            instance->sector_read_mask |= 1U << i;
+        }
+    }
+
+    if(loaded) {
+        instance->window_first = first;
+        instance->window_size = count;
+        instance->window_loaded = true;
+        instance->next_unit = first + count;
+    } else {
+        // Position in the file is unknown now
+        instance->next_unit = UINT16_MAX;
+    }
+
+    return loaded;
+}
+
+// Makes the block or page resident, returns its index in the window
+static bool
+    nfc_magic_block_source_load_unit(NfcMagicBlockSource* instance, uint16_t unit, size_t* index) {
+    bool loaded = false;
+
+    do {
+        if(!instance->is_open) break;
+
+        bool is_resident = instance->window_loaded && (unit >= instance->window_first) &&
+                           (unit - instance->window_first < instance->window_size);
+        if(!is_resident) {
+            uint16_t first = 0;
+            uint16_t count = 0;
+            if(instance->protocol == NfcProtocolMfClassic) {
+                if(unit >= mf_classic_get_total_block_num(instance->type)) break;
+                uint8_t sector = mf_classic_get_sector_by_block(unit);
+                first = mf_classic_get_first_block_num_of_sector(sector);
+                count = mf_classic_get_blocks_num_in_sector(sector);
+            } else {
+                if(unit >= instance->pages_read) break;
+                first = unit - (unit % NFC_MAGIC_BLOCK_SOURCE_WINDOW_PAGES_MAX);
+                count = MIN(NFC_MAGIC_BLOCK_SOURCE_WINDOW_PAGES_MAX, instance->pages_read - first);
+            }
+            if(!nfc_magic_block_source_load_window(instance, first, count)) break;
+        }
+
+        *index = unit - instance->window_first;
+        loaded = true;
+    } while(false);
+
+    return loaded;
+}
+
+bool nfc_magic_block_source_read_block(
+    NfcMagicBlockSource* instance,
+    uint16_t block_num,
+    MfClassicBlock* block) {
+    furi_assert(instance);
+    furi_assert(block);
+    furi_assert(instance->protocol == NfcProtocolMfClassic);
+
+    size_t index = 0;
+    bool read = nfc_magic_block_source_load_unit(instance, block_num, &index);
+    if(read) {
+        *block = instance->sector[index];
+    }
+
+    return read;
+}
+
+bool nfc_magic_block_source_is_block_read(NfcMagicBlockSource* instance, uint16_t block_num) {
+    furi_assert(instance);
+    furi_assert(instance->protocol == NfcProtocolMfClassic);
+
+    size_t index = 0;
+    return nfc_magic_block_source_load_unit(instance, block_num, &index) &&
+           (instance->sector_read_mask & (1U << index));
+}
+
+bool nfc_magic_block_source_read_page(
+    NfcMagicBlockSource* instance,
+    uint16_t page_num,
+    MfUltralightPage* page) {
+    furi_assert(instance);
+    furi_assert(page);
+    furi_assert(instance->protocol == NfcProtocolMfUltralight);
+
+    size_t index = 0;
+    bool read = nfc_magic_block_source_load_unit(instance, page_num, &index);
+    if(read) {
+        *page = instance->pages[index];
+    }
+
+    return read;
+}
+
+bool nfc_magic_block_source_get_hash(NfcMagicBlockSource* instance, uint32_t* hash) {
+    furi_assert(instance);
+    furi_assert(hash);
+
+    bool is_mfc = (instance->protocol == NfcProtocolMfClassic);
+    uint32_t value = NFC_MAGIC_RESUME_HASH_INIT;
+    bool hashed = instance->hash_valid;
+
+    if(!hashed && instance->is_open) {
+        value = nfc_magic_resume_hash(value, instance->iso3_data.uid, instance->iso3_data.uid_len);
+        uint16_t units_total = 0;
+        if(is_mfc) {
+            value = nfc_magic_resume_hash(value, &instance->type, sizeof(instance->type));
+            units_total = mf_classic_get_total_block_num(instance->type);
+        } else {
+            value = nfc_magic_resume_hash(value, &instance->mfu_type, sizeof(instance->mfu_type));
+            value =
+                nfc_magic_resume_hash(value, &instance->signature, sizeof(instance->signature));
+            value = nfc_magic_resume_hash(value, &instance->version, sizeof(instance->version));
+            units_total = instance->pages_read;
+        }
+
+        // One window at a time, the same as a write goes through the file
+        hashed = true;
+        uint16_t unit = 0;
+        while(unit < units_total) {
+            size_t index = 0;
+            if(!nfc_magic_block_source_load_unit(instance, unit, &index)) {
+                hashed = false;
+                break;
+            }
+            const void* window = is_mfc ? (const void*)instance->sector :
+                                          (const void*)instance->pages;
+            size_t unit_size = is_mfc ? MF_CLASSIC_BLOCK_SIZE : MF_ULTRALIGHT_PAGE_SIZE;
+            value = nfc_magic_resume_hash(value, window, instance->window_size * unit_size);
+            unit = instance->window_first + instance->window_size;
+        }
+
+        instance->hash = value;
+        instance->hash_valid = hashed;
+    }
+
+    if(hashed) {
+        *hash = instance->hash;
+    }
+
+    return hashed;
+}
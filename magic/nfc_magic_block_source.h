@@ -0,0 +1,72 @@
+#pragma once
+
+#include <storage/storage.h>
+#include <nfc/protocols/nfc_protocol.h>
+#include <nfc/protocols/iso14443_3a/iso14443_3a.h>
+#include <nfc/protocols/mf_classic/mf_classic.h>
+#include <nfc/protocols/mf_ultralight/mf_ultralight.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reads MIFARE Classic blocks or Ultralight/NTAG pages straight from a .nfc/.shd file.
+// Opening parses the header only. Only the sector of the last requested block, or a
+// window of pages of the same size, is kept in RAM.
+typedef struct NfcMagicBlockSource NfcMagicBlockSource;
+
+NfcMagicBlockSource* nfc_magic_block_source_alloc(Storage* storage);
+
+void nfc_magic_block_source_free(NfcMagicBlockSource* instance);
+
+bool nfc_magic_block_source_open(NfcMagicBlockSource* instance, const char* path);
+
+void nfc_magic_block_source_close(NfcMagicBlockSource* instance);
+
+bool nfc_magic_block_source_is_open(const NfcMagicBlockSource* instance);
+
+// NfcProtocolMfClassic or NfcProtocolMfUltralight
+NfcProtocol nfc_magic_block_source_get_protocol(const NfcMagicBlockSource* instance);
+
+const Iso14443_3aData*
+    nfc_magic_block_source_get_iso14443_3a_data(const NfcMagicBlockSource* instance);
+
+/**
+ * @brief Hash of the header and of every block or page, same image gives the same hash.
+ *
+ * Streams through the whole file on the first call, later calls return the kept value.
+ */
+bool nfc_magic_block_source_get_hash(NfcMagicBlockSource* instance, uint32_t* hash);
+
+// MIFARE Classic sources
+
+MfClassicType nfc_magic_block_source_get_type(const NfcMagicBlockSource* instance);
+
+bool nfc_magic_block_source_read_block(
+    NfcMagicBlockSource* instance,
+    uint16_t block_num,
+    MfClassicBlock* block);
+
+// Same as mf_classic_is_block_read: no "??" bytes, the access bits only for a sector trailer
+bool nfc_magic_block_source_is_block_read(NfcMagicBlockSource* instance, uint16_t block_num);
+
+// MIFARE Ultralight/NTAG sources
+
+MfUltralightType nfc_magic_block_source_get_mfu_type(const NfcMagicBlockSource* instance);
+
+uint16_t nfc_magic_block_source_get_pages_read(const NfcMagicBlockSource* instance);
+
+const MfUltralightSignature*
+    nfc_magic_block_source_get_mfu_signature(const NfcMagicBlockSource* instance);
+
+const MfUltralightVersion*
+    nfc_magic_block_source_get_mfu_version(const NfcMagicBlockSource* instance);
+
+bool nfc_magic_block_source_read_page(
+    NfcMagicBlockSource* instance,
+    uint16_t page_num,
+    MfUltralightPage* page);
+
+#ifdef __cplusplus
+}
+#endif
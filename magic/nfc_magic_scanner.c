@@ -7,6 +7,7 @@
 #include "protocols/gen2/gen2_poller.h"
 #include "protocols/gen4/gen4_poller.h"
 #include "protocols/slix/slix_poller.h"
+#include "protocols/nfc_magic_detect.h"
 #include <nfc/nfc_poller.h>
 
 #include <furi/furi.h>
@@ -19,12 +20,16 @@ typedef enum {
 
 struct NfcMagicScanner {
     Nfc* nfc;
+    NfcMagicDetectContext* detect_ctx;
     NfcMagicScannerSessionState session_state;
     NfcMagicProtocol current_protocol;
 
+    Gen4PasswordList gen4_passwords;
+    // Password the detected Gen4 card answered to
     Gen4Password gen4_password;
     Gen4* gen4_data;
     SlixData* slix_data;
+    NfcMagicFingerprint fingerprint;
     bool magic_protocol_detected;
 
     NfcMagicScannerCallback callback;
@@ -49,8 +54,10 @@ NfcMagicScanner* nfc_magic_scanner_alloc(Nfc* nfc) {
 
     NfcMagicScanner* instance = malloc(sizeof(NfcMagicScanner));
     instance->nfc = nfc;
+    instance->detect_ctx = nfc_magic_detect_context_alloc(nfc);
     instance->gen4_data = gen4_alloc();
     instance->slix_data = slix_alloc();
+    nfc_magic_fingerprint_reset(&instance->fingerprint);
 
     return instance;
 }
@@ -60,13 +67,17 @@ void nfc_magic_scanner_free(NfcMagicScanner* instance) {
 
     gen4_free(instance->gen4_data);
     slix_free(instance->slix_data);
+    nfc_magic_detect_context_free(instance->detect_ctx);
     free(instance);
 }
 
-void nfc_magic_scanner_set_gen4_password(NfcMagicScanner* instance, Gen4Password password) {
+void nfc_magic_scanner_set_gen4_passwords(
+    NfcMagicScanner* instance,
+    const Gen4PasswordList* passwords) {
     furi_assert(instance);
+    furi_assert(passwords);
 
-    instance->gen4_password = password;
+    instance->gen4_passwords = *passwords;
 }
 
 static int32_t nfc_magic_scanner_worker(void* context) {
@@ -76,24 +87,29 @@ static int32_t nfc_magic_scanner_worker(void* context) {
     furi_assert(instance->session_state == NfcMagicScannerSessionStateActive);
 
     while(instance->session_state == NfcMagicScannerSessionStateActive) {
+        // Detectors that don't go through the context leave an empty fingerprint
+        nfc_magic_detect_context_reset(instance->detect_ctx);
         do {
             if(instance->current_protocol == NfcMagicProtocolGen1) {
-                instance->magic_protocol_detected = gen1a_poller_detect(instance->nfc);
+                instance->magic_protocol_detected = gen1a_poller_detect(instance->detect_ctx);
                 if(instance->magic_protocol_detected) {
                     break;
                 }
             } else if(instance->current_protocol == NfcMagicProtocolGen4) {
                 gen4_reset(instance->gen4_data);
                 Gen4 gen4_data;
-                Gen4PollerError error =
-                    gen4_poller_detect(instance->nfc, instance->gen4_password, &gen4_data);
+                Gen4PollerError error = gen4_poller_detect(
+                    instance->detect_ctx,
+                    &instance->gen4_passwords,
+                    &gen4_data,
+                    &instance->gen4_password);
                 instance->magic_protocol_detected = (error == Gen4PollerErrorNone);
                 if(instance->magic_protocol_detected) {
                     gen4_copy(instance->gen4_data, &gen4_data);
                     break;
                 }
             } else if(instance->current_protocol == NfcMagicProtocolGen2) {
-                Gen2PollerError error = gen2_poller_detect(instance->nfc);
+                Gen2PollerError error = gen2_poller_detect(instance->detect_ctx);
                 instance->magic_protocol_detected = (error == Gen2PollerErrorNone);
                 if(instance->magic_protocol_detected) {
                     break;
@@ -101,7 +117,7 @@ static int32_t nfc_magic_scanner_worker(void* context) {
             } else if(instance->current_protocol == NfcMagicProtocolSlix) {
                 slix_reset(instance->slix_data);
                 instance->magic_protocol_detected =
-                    slix_poller_detect(instance->nfc, instance->slix_data);
+                    slix_poller_detect(instance->detect_ctx, instance->slix_data);
                 if(instance->magic_protocol_detected) {
                     break;
                 }
@@ -116,6 +132,8 @@ static int32_t nfc_magic_scanner_worker(void* context) {
         } while(false);
 
         if(instance->magic_protocol_detected) {
+            instance->fingerprint = instance->detect_ctx->fingerprint;
+            instance->fingerprint.protocol = instance->current_protocol;
             NfcMagicScannerEvent event = {
                 .type = NfcMagicScannerEventTypeDetected,
                 .data.protocol = instance->current_protocol,
@@ -190,6 +208,18 @@ const Gen4* nfc_magic_scanner_get_gen4_data(NfcMagicScanner* instance) {
     return instance->gen4_data;
 }
 
+const Gen4Password* nfc_magic_scanner_get_gen4_password(NfcMagicScanner* instance) {
+    furi_assert(instance);
+
+    return &instance->gen4_password;
+}
+
+const NfcMagicFingerprint* nfc_magic_scanner_get_fingerprint(NfcMagicScanner* instance) {
+    furi_assert(instance);
+
+    return &instance->fingerprint;
+}
+
 const SlixData* nfc_magic_scanner_get_slix_data(NfcMagicScanner* instance) {
     furi_assert(instance);
 
@@ -4,6 +4,7 @@
 #include "protocols/slix/slix.h"
 #include <nfc/nfc.h>
 #include "protocols/nfc_magic_protocols.h"
+#include "protocols/nfc_magic_fingerprint.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,7 +33,10 @@ NfcMagicScanner* nfc_magic_scanner_alloc(Nfc* nfc);
 
 void nfc_magic_scanner_free(NfcMagicScanner* instance);
 
-void nfc_magic_scanner_set_gen4_password(NfcMagicScanner* instance, Gen4Password password);
+// Passwords tried on Gen4 cards, set before starting the scanner
+void nfc_magic_scanner_set_gen4_passwords(
+    NfcMagicScanner* instance,
+    const Gen4PasswordList* passwords);
 
 void nfc_magic_scanner_start(
     NfcMagicScanner* instance,
@@ -43,8 +47,14 @@ void nfc_magic_scanner_stop(NfcMagicScanner* instance);
 
 const Gen4* nfc_magic_scanner_get_gen4_data(NfcMagicScanner* instance);
 
+// Valid after a Gen4 card was detected
+const Gen4Password* nfc_magic_scanner_get_gen4_password(NfcMagicScanner* instance);
+
 const SlixData* nfc_magic_scanner_get_slix_data(NfcMagicScanner* instance);
 
+// Valid after a card was detected, for handing to the operation pollers
+const NfcMagicFingerprint* nfc_magic_scanner_get_fingerprint(NfcMagicScanner* instance);
+
 #ifdef __cplusplus
 }
 #endif
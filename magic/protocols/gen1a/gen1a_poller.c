@@ -1,12 +1,15 @@
 #include "gen1a_poller_i.h"
 #include <nfc/protocols/iso14443_3a/iso14443_3a.h>
 #include <nfc/protocols/iso14443_3a/iso14443_3a_poller.h>
-#include <nfc/helpers/nfc_data_generator.h>
 
 #include <furi/furi.h>
 
+#define TAG "GEN1A_POLLER"
+
 #define GEN1A_POLLER_THREAD_FLAG_DETECTED (1U << 0)
 
+#define GEN1A_POLLER_DEFAULT_UID_LEN (4)
+
 typedef NfcCommand (*Gen1aPollerStateHandler)(Gen1aPoller* instance);
 
 typedef struct {
@@ -17,6 +20,56 @@ typedef struct {
     bool detected;
 } Gen1aPollerDetectContext;
 
+// A retry only costs the backdoor unlock, two short frames, before the block is written again
+static const NfcMagicRetryPolicy gen1a_poller_retry_policy = {
+    .block_retries = 3,
+    .backoff_resets_min = 1,
+    .backoff_resets_max = 4,
+};
+
+// Wipe image, a 1K card with UID 01 02 03 04 and transport keys
+static const MfClassicBlock gen1a_poller_default_block_0 = {
+    .data =
+        {0x01,
+         0x02,
+         0x03,
+         0x04,
+         0x04, // BCC
+         0x08, // SAK
+         0x04, // ATQA0
+         0x00, // ATQA1
+         0x00,
+         0x00,
+         0x00,
+         0x00,
+         0x00,
+         0x00,
+         0x00,
+         0x00},
+};
+
+static const MfClassicBlock gen1a_poller_default_empty_block = {0};
+
+static const MfClassicBlock gen1a_poller_default_sector_trailer_block = {
+    .data =
+        {0xFF,
+         0xFF,
+         0xFF,
+         0xFF,
+         0xFF,
+         0xFF,
+         0xFF,
+         0x07,
+         0x80,
+         0x69,
+         0xFF,
+         0xFF,
+         0xFF,
+         0xFF,
+         0xFF,
+         0xFF},
+};
+
 Gen1aPollerError gen1a_poller_parse_block0(MfClassicBlock* block, MfClassicData* mf_data) {
     furi_assert(mf_data);
     furi_assert(block);
@@ -49,7 +102,8 @@ Gen1aPoller* gen1a_poller_alloc(Nfc* nfc) {
     instance->tx_buffer = bit_buffer_alloc(GEN1A_POLLER_MAX_BUFFER_SIZE);
     instance->rx_buffer = bit_buffer_alloc(GEN1A_POLLER_MAX_BUFFER_SIZE);
 
-    instance->mfc_device = nfc_device_alloc();
+    nfc_magic_resume_reset(&instance->resume);
+    nfc_magic_retry_init(&instance->retry, &gen1a_poller_retry_policy);
 
     instance->gen1a_event.data = &instance->gen1a_event_data;
 
@@ -62,11 +116,22 @@ void gen1a_poller_free(Gen1aPoller* instance) {
     bit_buffer_free(instance->tx_buffer);
     bit_buffer_free(instance->rx_buffer);
 
-    nfc_device_free(instance->mfc_device);
-
     free(instance);
 }
 
+void gen1a_poller_set_skip_unchanged(Gen1aPoller* instance, bool skip_unchanged) {
+    furi_assert(instance);
+
+    instance->skip_unchanged = skip_unchanged;
+}
+
+void gen1a_poller_set_retry_policy(Gen1aPoller* instance, const NfcMagicRetryPolicy* policy) {
+    furi_assert(instance);
+    furi_assert(policy);
+
+    nfc_magic_retry_init(&instance->retry, policy);
+}
+
 NfcCommand gen1a_poller_detect_callback(NfcEvent event, void* context) {
     furi_assert(context);
 
@@ -96,8 +161,11 @@ NfcCommand gen1a_poller_detect_callback(NfcEvent event, void* context) {
     return command;
 }
 
-bool gen1a_poller_detect(Nfc* nfc) {
-    furi_assert(nfc);
+bool gen1a_poller_detect(NfcMagicDetectContext* detect_ctx) {
+    furi_assert(detect_ctx);
+
+    Nfc* nfc = detect_ctx->nfc;
+    nfc_magic_detect_context_reset(detect_ctx);
 
     nfc_config(nfc, NfcModePoller, NfcTechIso14443a);
     nfc_set_guard_time_us(nfc, ISO14443_3A_GUARD_TIME_US);
@@ -106,8 +174,8 @@ bool gen1a_poller_detect(Nfc* nfc) {
 
     Gen1aPollerDetectContext gen1a_poller_detect_ctx = {};
     gen1a_poller_detect_ctx.nfc = nfc;
-    gen1a_poller_detect_ctx.tx_buffer = bit_buffer_alloc(GEN1A_POLLER_MAX_BUFFER_SIZE);
-    gen1a_poller_detect_ctx.rx_buffer = bit_buffer_alloc(GEN1A_POLLER_MAX_BUFFER_SIZE);
+    gen1a_poller_detect_ctx.tx_buffer = detect_ctx->tx_buffer;
+    gen1a_poller_detect_ctx.rx_buffer = detect_ctx->rx_buffer;
     gen1a_poller_detect_ctx.thread_id = furi_thread_get_current_id();
     gen1a_poller_detect_ctx.detected = false;
 
@@ -119,15 +187,11 @@ bool gen1a_poller_detect(Nfc* nfc) {
     }
     nfc_stop(nfc);
 
-    bit_buffer_free(gen1a_poller_detect_ctx.tx_buffer);
-    bit_buffer_free(gen1a_poller_detect_ctx.rx_buffer);
-
     return gen1a_poller_detect_ctx.detected;
 }
 
 static void gen1a_poller_reset(Gen1aPoller* instance) {
-    instance->current_block = 0;
-    nfc_data_generator_fill_data(NfcDataGeneratorTypeMfClassic1k_4b, instance->mfc_device);
+    instance->is_unlocked = false;
 }
 
 NfcCommand gen1a_poller_idle_handler(Gen1aPoller* instance) {
@@ -160,77 +224,182 @@ NfcCommand gen1a_poller_request_mode_handler(Gen1aPoller* instance) {
     return command;
 }
 
-NfcCommand gen1a_poller_wipe_handler(Gen1aPoller* instance) {
-    NfcCommand command = NfcCommandContinue;
-    Gen1aPollerError error = Gen1aPollerErrorNone;
+// Block to write, the wipe image has no file behind it
+static bool gen1a_poller_get_image_block(
+    NfcMagicBlockSource* source,
+    uint8_t block_num,
+    MfClassicBlock* block) {
+    bool read = true;
+
+    if(source) {
+        read = nfc_magic_block_source_read_block(source, block_num, block);
+    } else if(block_num == 0) {
+        *block = gen1a_poller_default_block_0;
+    } else if(mf_classic_is_sector_trailer(block_num)) {
+        *block = gen1a_poller_default_sector_trailer_block;
+    } else {
+        *block = gen1a_poller_default_empty_block;
+    }
+
+    return read;
+}
 
-    const MfClassicData* mfc_data =
-        nfc_device_get_data(instance->mfc_device, NfcProtocolMfClassic);
-    uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
+static bool gen1a_poller_get_image_hash(NfcMagicBlockSource* source, uint32_t* hash) {
+    bool hashed = true;
 
-    if(instance->current_block == total_block_num) {
-        instance->state = Gen1aPollerStateSuccess;
+    if(source) {
+        hashed = nfc_magic_block_source_get_hash(source, hash);
     } else {
-        do {
-            if(instance->current_block == 0) {
-                error = gen1a_poller_data_access(instance);
-                if(error != Gen1aPollerErrorNone) {
-                    instance->state = Gen1aPollerStateFail;
-                    break;
-                }
-            }
-            error = gen1a_poller_write_block(
-                instance, instance->current_block, &mfc_data->block[instance->current_block]);
+        *hash = nfc_magic_resume_hash(
+            NFC_MAGIC_RESUME_HASH_INIT,
+            &gen1a_poller_default_block_0,
+            sizeof(gen1a_poller_default_block_0));
+        *hash = nfc_magic_resume_hash(
+            *hash,
+            &gen1a_poller_default_sector_trailer_block,
+            sizeof(gen1a_poller_default_sector_trailer_block));
+    }
+
+    return hashed;
+}
+
+static Gen1aPollerError gen1a_poller_begin_write(
+    Gen1aPoller* instance,
+    NfcMagicBlockSource* source,
+    size_t uid_len) {
+    Gen1aPollerError error = Gen1aPollerErrorNone;
+
+    do {
+        error = gen1a_poller_data_access(instance);
+        if(error != Gen1aPollerErrorNone) break;
+
+        uint32_t source_hash = 0;
+        if(!gen1a_poller_get_image_hash(source, &source_hash)) {
+            FURI_LOG_E(TAG, "Failed to read the image to write");
+            error = Gen1aPollerErrorProtocol;
+            break;
+        }
+
+        // Gen1a wakes up without anticollision, block 0 tells which card came back
+        MfClassicBlock block = {};
+        const uint8_t* uid = NULL;
+        if(nfc_magic_resume_is_pending(&instance->resume, source_hash)) {
+            error = gen1a_poller_read_block(instance, 0, &block);
+            if(error != Gen1aPollerErrorNone) break;
+            uid = block.data;
+        }
+        instance->current_block =
+            nfc_magic_resume_bind(&instance->resume, uid, uid_len, source_hash);
+        instance->is_unlocked = true;
+    } while(false);
+
+    return error;
+}
+
+// source is NULL for the wipe image
+static NfcCommand gen1a_poller_write_image(Gen1aPoller* instance, NfcMagicBlockSource* source) {
+    NfcCommand command = NfcCommandContinue;
+    Gen1aPollerError error = Gen1aPollerErrorNone;
+    MfClassicType type = source ? nfc_magic_block_source_get_type(source) : MfClassicType1k;
+    uint16_t total_block_num = mf_classic_get_total_block_num(type);
+    size_t uid_len = source ? nfc_magic_block_source_get_iso14443_3a_data(source)->uid_len :
+                              GEN1A_POLLER_DEFAULT_UID_LEN;
+
+    do {
+        if(!instance->is_unlocked) {
+            error = gen1a_poller_begin_write(instance, source, uid_len);
             if(error != Gen1aPollerErrorNone) {
                 instance->state = Gen1aPollerStateFail;
                 break;
             }
-            instance->current_block++;
-        } while(false);
-    }
+            // A retried block is not news to the scene
+            if((instance->current_block > 0) && !nfc_magic_retry_is_pending(&instance->retry)) {
+                instance->gen1a_event.type = Gen1aPollerEventTypeResumed;
+                instance->gen1a_event_data.resumed.block = instance->current_block;
+                command = instance->callback(instance->gen1a_event, instance->context);
+            }
+        }
+
+        if(instance->current_block == total_block_num) {
+            instance->state = Gen1aPollerStateSuccess;
+            break;
+        }
+
+        MfClassicBlock block = {};
+        if(!gen1a_poller_get_image_block(source, instance->current_block, &block)) {
+            FURI_LOG_E(TAG, "Failed to read %d block", instance->current_block);
+            instance->state = Gen1aPollerStateFail;
+            break;
+        }
+
+        // A read is one frame against two for a write, blocks already in place are left alone
+        bool is_unchanged = false;
+        if(instance->skip_unchanged) {
+            MfClassicBlock card_block = {};
+            is_unchanged =
+                (gen1a_poller_read_block(instance, instance->current_block, &card_block) ==
+                 Gen1aPollerErrorNone) &&
+                (memcmp(card_block.data, block.data, sizeof(MfClassicBlock)) == 0);
+        }
+        if(!is_unchanged) {
+            error = gen1a_poller_write_block(instance, instance->current_block, &block);
+        }
+        if(error != Gen1aPollerErrorNone) {
+            bool is_transient = (error != Gen1aPollerErrorProtocol);
+            if(is_transient && nfc_magic_retry_schedule(&instance->retry)) {
+                // Power the card down for a while, then unlock it again and redo the block
+                instance->state = Gen1aPollerStateIdle;
+                instance->gen1a_event.type = Gen1aPollerEventTypeRetry;
+                instance->gen1a_event_data.retry.block = instance->current_block;
+                instance->gen1a_event_data.retry.stats = instance->retry.stats;
+                command = instance->callback(instance->gen1a_event, instance->context);
+            } else if(is_transient && nfc_magic_resume_has_progress(&instance->resume)) {
+                // Card left the field mid-write, pick up where it stopped once it's back
+                nfc_magic_retry_end_block(&instance->retry, false);
+                instance->state = Gen1aPollerStateIdle;
+                instance->gen1a_event.type = Gen1aPollerEventTypeCardLost;
+                command = instance->callback(instance->gen1a_event, instance->context);
+            } else {
+                instance->state = Gen1aPollerStateFail;
+            }
+            break;
+        }
+        if(instance->current_block == 0) {
+            nfc_magic_resume_set_uid(&instance->resume, block.data, uid_len);
+        }
+        instance->current_block++;
+        nfc_magic_resume_advance(&instance->resume, instance->current_block);
+        nfc_magic_retry_end_block(&instance->retry, true);
+    } while(false);
 
     return command;
 }
 
+NfcCommand gen1a_poller_wipe_handler(Gen1aPoller* instance) {
+    return gen1a_poller_write_image(instance, NULL);
+}
+
 NfcCommand gen1a_poller_write_data_request_handler(Gen1aPoller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     instance->gen1a_event.type = Gen1aPollerEventTypeRequestDataToWrite;
+    instance->gen1a_event_data.data_to_write.block_source = NULL;
     command = instance->callback(instance->gen1a_event, instance->context);
-    instance->state = Gen1aPollerStateWrite;
+    // Kept apart, later events reuse the event data
+    instance->block_source = instance->gen1a_event_data.data_to_write.block_source;
+    if(instance->block_source &&
+       (nfc_magic_block_source_get_protocol(instance->block_source) == NfcProtocolMfClassic)) {
+        instance->state = Gen1aPollerStateWrite;
+    } else {
+        FURI_LOG_E(TAG, "No MIFARE Classic image to write");
+        instance->state = Gen1aPollerStateFail;
+    }
 
     return command;
 }
 
 NfcCommand gen1a_poller_write_handler(Gen1aPoller* instance) {
-    NfcCommand command = NfcCommandContinue;
-    Gen1aPollerError error = Gen1aPollerErrorNone;
-
-    const MfClassicData* mfc_data = instance->gen1a_event_data.data_to_write.mfc_data;
-    uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
-
-    if(instance->current_block == total_block_num) {
-        instance->state = Gen1aPollerStateSuccess;
-    } else {
-        do {
-            if(instance->current_block == 0) {
-                error = gen1a_poller_data_access(instance);
-                if(error != Gen1aPollerErrorNone) {
-                    instance->state = Gen1aPollerStateFail;
-                    break;
-                }
-            }
-            error = gen1a_poller_write_block(
-                instance, instance->current_block, &mfc_data->block[instance->current_block]);
-            if(error != Gen1aPollerErrorNone) {
-                instance->state = Gen1aPollerStateFail;
-                break;
-            }
-            instance->current_block++;
-        } while(false);
-    }
-
-    return command;
+    return gen1a_poller_write_image(instance, instance->block_source);
 }
 
 NfcCommand gen1a_poller_dump_data_request_handler(Gen1aPoller* instance) {
@@ -238,6 +407,7 @@ NfcCommand gen1a_poller_dump_data_request_handler(Gen1aPoller* instance) {
 
     instance->gen1a_event.type = Gen1aPollerEventTypeRequestDataToDump;
     command = instance->callback(instance->gen1a_event, instance->context);
+    instance->current_block = 0;
     instance->state = Gen1aPollerStateDump;
 
     return command;
@@ -298,6 +468,8 @@ NfcCommand gen1a_poller_success_handler(Gen1aPoller* instance) {
 
     instance->gen1a_event.type = Gen1aPollerEventTypeSuccess;
     command = instance->callback(instance->gen1a_event, instance->context);
+    nfc_magic_resume_reset(&instance->resume);
+    nfc_magic_retry_reset(&instance->retry);
     instance->state = Gen1aPollerStateIdle;
 
     return command;
@@ -308,6 +480,8 @@ NfcCommand gen1a_poller_fail_handler(Gen1aPoller* instance) {
 
     instance->gen1a_event.type = Gen1aPollerEventTypeFail;
     command = instance->callback(instance->gen1a_event, instance->context);
+    nfc_magic_resume_reset(&instance->resume);
+    nfc_magic_retry_reset(&instance->retry);
     instance->state = Gen1aPollerStateIdle;
 
     return command;
@@ -331,7 +505,12 @@ NfcCommand gen1a_poller_run(NfcEvent event, void* context) {
     Gen1aPoller* instance = context;
 
     if(event.type == NfcEventTypePollerReady) {
-        command = gen1a_poller_state_handlers[instance->state](instance);
+        if(nfc_magic_retry_backoff(&instance->retry)) {
+            // Keep the card powered down, the idle state wakes it up again
+            command = NfcCommandReset;
+        } else {
+            command = gen1a_poller_state_handlers[instance->state](instance);
+        }
     }
 
     if(instance->session_state == Gen1aPollerSessionStateStopRequest) {
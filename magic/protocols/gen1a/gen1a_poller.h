@@ -3,6 +3,9 @@
 #include <nfc/nfc.h>
 #include <nfc/protocols/nfc_generic_event.h>
 #include <nfc/protocols/mf_classic/mf_classic.h>
+#include "../nfc_magic_detect.h"
+#include "../../nfc_magic_block_source.h"
+#include "../nfc_magic_retry.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,6 +16,9 @@ typedef enum {
     Gen1aPollerEventTypeRequestMode,
     Gen1aPollerEventTypeRequestDataToWrite,
     Gen1aPollerEventTypeRequestDataToDump,
+    Gen1aPollerEventTypeCardLost,
+    Gen1aPollerEventTypeResumed,
+    Gen1aPollerEventTypeRetry,
 
     Gen1aPollerEventTypeSuccess,
     Gen1aPollerEventTypeFail,
@@ -29,17 +35,29 @@ typedef struct {
 } Gen1aPollerEventDataRequestMode;
 
 typedef struct {
-    const MfClassicData* mfc_data;
+    // Blocks are pulled from the file one sector at a time during the write
+    NfcMagicBlockSource* block_source;
 } Gen1aPollerEventDataRequestDataToWrite;
 
 typedef struct {
     MfClassicData* mfc_data;
 } Gen1aPollerEventDataRequestDataToDump;
 
+typedef struct {
+    uint16_t block;
+} Gen1aPollerEventDataResumed;
+
+typedef struct {
+    uint16_t block;
+    NfcMagicRetryStats stats;
+} Gen1aPollerEventDataRetry;
+
 typedef union {
     Gen1aPollerEventDataRequestMode request_mode;
     Gen1aPollerEventDataRequestDataToWrite data_to_write;
     Gen1aPollerEventDataRequestDataToDump data_to_dump;
+    Gen1aPollerEventDataResumed resumed;
+    Gen1aPollerEventDataRetry retry;
 } Gen1aPollerEventData;
 
 typedef struct {
@@ -51,12 +69,18 @@ typedef NfcCommand (*Gen1aPollerCallback)(Gen1aPollerEvent event, void* context)
 
 typedef struct Gen1aPoller Gen1aPoller;
 
-bool gen1a_poller_detect(Nfc* nfc);
+bool gen1a_poller_detect(NfcMagicDetectContext* detect_ctx);
 
 Gen1aPoller* gen1a_poller_alloc(Nfc* nfc);
 
 void gen1a_poller_free(Gen1aPoller* instance);
 
+// Read every block before writing it and skip the ones that already match
+void gen1a_poller_set_skip_unchanged(Gen1aPoller* instance, bool skip_unchanged);
+
+// Replaces the built-in retry budget, the policy must outlive the poller
+void gen1a_poller_set_retry_policy(Gen1aPoller* instance, const NfcMagicRetryPolicy* policy);
+
 void gen1a_poller_start(Gen1aPoller* instance, Gen1aPollerCallback callback, void* context);
 
 void gen1a_poller_stop(Gen1aPoller* instance);
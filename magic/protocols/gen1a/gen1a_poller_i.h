@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gen1a_poller.h"
+#include "../nfc_magic_resume.h"
 #include <nfc/protocols/nfc_generic_event.h>
 #include <nfc/nfc_device.h>
 #include <nfc/protocols/mf_classic/mf_classic.h>
@@ -45,7 +46,12 @@ struct Gen1aPoller {
     Gen1aPollerSessionState session_state;
 
     uint16_t current_block;
-    NfcDevice* mfc_device;
+    // Borrowed from the caller for the write, NULL writes the wipe image
+    NfcMagicBlockSource* block_source;
+    NfcMagicResume resume;
+    NfcMagicRetry retry;
+    bool is_unlocked;
+    bool skip_unchanged;
 
     BitBuffer* tx_buffer;
     BitBuffer* rx_buffer;
@@ -13,6 +13,10 @@
 
 #define BEBIT(x, n) FURI_BIT(x, (n) ^ 24)
 
+// LF_POLY_ODD and LF_POLY_EVEN taps as LFSR bit ages
+static const uint8_t crypto1_batch_taps[] =
+    {4, 5, 6, 8, 12, 18, 20, 22, 23, 28, 30, 32, 33, 35, 37, 38, 42, 47};
+
 Crypto1* crypto1_alloc() {
     Crypto1* instance = malloc(sizeof(Crypto1));
 
@@ -51,19 +55,40 @@ static uint32_t crypto1_filter(uint32_t in) {
     return FURI_BIT(0xEC57E80A, out);
 }
 
+static inline void crypto1_shift(Crypto1* crypto1, uint32_t feed) {
+    feed ^= LF_POLY_ODD & crypto1->odd;
+    feed ^= LF_POLY_EVEN & crypto1->even;
+    crypto1->even = crypto1->even << 1 | (nfc_util_even_parity32(feed));
+
+    FURI_SWAP(crypto1->odd, crypto1->even);
+}
+
 uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
     uint8_t out = crypto1_filter(crypto1->odd);
     uint32_t feed = out & (!!is_encrypted);
     feed ^= !!in;
-    feed ^= LF_POLY_ODD & crypto1->odd;
-    feed ^= LF_POLY_EVEN & crypto1->even;
-    crypto1->even = crypto1->even << 1 | (nfc_util_even_parity32(feed));
+    crypto1_shift(crypto1, feed);
 
-    FURI_SWAP(crypto1->odd, crypto1->even);
     return out;
 }
 
+// Encrypts plain with its parity bit, evaluating the filter once per LFSR step.
+// ks holds the keystream bit of the current state and is carried on to the next byte,
+// the bit after the byte is exactly the one that encrypts its parity.
+static uint8_t
+    crypto1_encrypt_byte(Crypto1* crypto1, uint8_t in, uint8_t plain, uint8_t* ks, bool* parity) {
+    uint8_t out = 0;
+    for(uint8_t i = 0; i < 8; i++) {
+        out |= *ks << i;
+        crypto1_shift(crypto1, FURI_BIT(in, i));
+        *ks = crypto1_filter(crypto1->odd);
+    }
+    *parity = (*ks ^ nfc_util_odd_parity8(plain)) & 0x01;
+
+    return out ^ plain;
+}
+
 uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
     uint8_t out = 0;
@@ -82,6 +107,206 @@ uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
     return out;
 }
 
+uint32_t crypto1_decrypt_nested_nt(uint64_t key, uint32_t cuid, uint32_t nt_enc) {
+    Crypto1 crypto;
+    crypto1_init(&crypto, key);
+
+    return crypto1_word(&crypto, nt_enc ^ cuid, 1) ^ nt_enc;
+}
+
+// A lane is handled as 64 bit words, the 32 bit lane of the device as the low half of one
+#define CRYPTO1_BATCH_WORDS ((CRYPTO1_BATCH_WIDTH + 63) / 64)
+
+static inline uint64_t crypto1_batch_lane_get_word(Crypto1BatchLane lane, size_t word) {
+#if CRYPTO1_BATCH_LANE_BITS == 256
+    return lane[word];
+#else
+    UNUSED(word);
+    return lane;
+#endif
+}
+
+static inline Crypto1BatchLane crypto1_batch_lane_from_words(const uint64_t* words) {
+#if CRYPTO1_BATCH_LANE_BITS == 256
+    return (Crypto1BatchLane){words[0], words[1], words[2], words[3]};
+#else
+    return (Crypto1BatchLane)words[0];
+#endif
+}
+
+bool crypto1_batch_lane_get(Crypto1BatchLane lane, size_t index) {
+    furi_assert(index < CRYPTO1_BATCH_WIDTH);
+
+    return FURI_BIT(crypto1_batch_lane_get_word(lane, index / 64), index % 64);
+}
+
+bool crypto1_batch_lane_is_empty(Crypto1BatchLane lane) {
+    uint64_t bits = 0;
+    for(size_t i = 0; i < CRYPTO1_BATCH_WORDS; i++) {
+        bits |= crypto1_batch_lane_get_word(lane, i);
+    }
+
+    return bits == 0;
+}
+
+Crypto1BatchLane crypto1_batch_lane_mask(size_t keys_num) {
+    furi_assert(keys_num <= CRYPTO1_BATCH_WIDTH);
+
+    uint64_t words[CRYPTO1_BATCH_WORDS];
+    for(size_t i = 0; i < CRYPTO1_BATCH_WORDS; i++) {
+        size_t bits = (keys_num > 64 * i) ? keys_num - 64 * i : 0;
+        words[i] = (bits < 64) ? ((uint64_t)1 << bits) - 1 : UINT64_MAX;
+    }
+
+    return crypto1_batch_lane_from_words(words);
+}
+
+// Row i bit j moves to row j bit i, swapping ever smaller blocks across the diagonal
+static void crypto1_batch_transpose(uint64_t* rows) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for(size_t width = 32; width; width >>= 1, mask ^= mask << width) {
+        for(size_t i = 0; i < 64; i = (i + width + 1) & ~width) {
+            uint64_t swap = ((rows[i] >> width) ^ rows[i + width]) & mask;
+            rows[i] ^= swap << width;
+            rows[i + width] ^= swap;
+        }
+    }
+}
+
+void crypto1_batch_init(Crypto1Batch* batch, const uint64_t* keys, size_t keys_num) {
+    furi_assert(batch);
+    furi_assert(keys);
+    furi_assert(keys_num <= CRYPTO1_BATCH_WIDTH);
+
+    // Key bit n of 64 keys at a time, transposing costs a fraction of gathering bit by bit
+    uint64_t rows[CRYPTO1_BATCH_WORDS][64];
+    for(size_t word = 0; word < CRYPTO1_BATCH_WORDS; word++) {
+        for(size_t i = 0; i < 64; i++) {
+            size_t key_index = word * 64 + i;
+            rows[word][i] = (key_index < keys_num) ? keys[key_index] : 0;
+        }
+        crypto1_batch_transpose(rows[word]);
+    }
+
+    batch->head = 0;
+    for(size_t age = 0; age < CRYPTO1_BATCH_LFSR_SIZE; age++) {
+        uint64_t words[CRYPTO1_BATCH_WORDS];
+        for(size_t word = 0; word < CRYPTO1_BATCH_WORDS; word++) {
+            words[word] = rows[word][age ^ 7];
+        }
+        Crypto1BatchLane lane = crypto1_batch_lane_from_words(words);
+        batch->lfsr[age] = lane;
+        batch->lfsr[age + CRYPTO1_BATCH_LFSR_SIZE] = lane;
+    }
+}
+
+// Boolean forms of the nibble tables in crypto1_filter
+static inline Crypto1BatchLane crypto1_batch_fa(
+    Crypto1BatchLane y0,
+    Crypto1BatchLane y1,
+    Crypto1BatchLane y2,
+    Crypto1BatchLane y3) {
+    return ((y0 | y1) ^ (y0 & y3)) ^ (y2 & ((y0 ^ y1) | y3));
+}
+
+static inline Crypto1BatchLane crypto1_batch_fb(
+    Crypto1BatchLane y0,
+    Crypto1BatchLane y1,
+    Crypto1BatchLane y2,
+    Crypto1BatchLane y3) {
+    return ((y0 & y1) | y2) ^ ((y0 ^ y1) & (y2 | y3));
+}
+
+static inline Crypto1BatchLane crypto1_batch_fc(
+    Crypto1BatchLane y0,
+    Crypto1BatchLane y1,
+    Crypto1BatchLane y2,
+    Crypto1BatchLane y3,
+    Crypto1BatchLane y4) {
+    return (y0 | ((y1 | y4) & (y3 ^ y4))) ^ ((y0 ^ (y1 & y3)) & ((y2 ^ y3) | (y1 & y4)));
+}
+
+static Crypto1BatchLane crypto1_batch_filter(const Crypto1Batch* batch) {
+    // Odd register bit n is the LFSR bit of age 2n
+    const Crypto1BatchLane* lfsr = &batch->lfsr[batch->head];
+    Crypto1BatchLane n0 = crypto1_batch_fb(lfsr[6], lfsr[4], lfsr[2], lfsr[0]);
+    Crypto1BatchLane n1 = crypto1_batch_fa(lfsr[14], lfsr[12], lfsr[10], lfsr[8]);
+    Crypto1BatchLane n2 = crypto1_batch_fb(lfsr[22], lfsr[20], lfsr[18], lfsr[16]);
+    Crypto1BatchLane n3 = crypto1_batch_fb(lfsr[30], lfsr[28], lfsr[26], lfsr[24]);
+    Crypto1BatchLane n4 = crypto1_batch_fa(lfsr[38], lfsr[36], lfsr[34], lfsr[32]);
+
+    return crypto1_batch_fc(n4, n3, n2, n1, n0);
+}
+
+Crypto1BatchLane crypto1_batch_bit(Crypto1Batch* batch, Crypto1BatchLane in, bool is_encrypted) {
+    furi_assert(batch);
+
+    Crypto1BatchLane out = crypto1_batch_filter(batch);
+    Crypto1BatchLane feed = in;
+    if(is_encrypted) {
+        feed ^= out;
+    }
+    for(size_t i = 0; i < COUNT_OF(crypto1_batch_taps); i++) {
+        feed ^= batch->lfsr[batch->head + crypto1_batch_taps[i]];
+    }
+
+    batch->head = (batch->head + CRYPTO1_BATCH_LFSR_SIZE - 1) % CRYPTO1_BATCH_LFSR_SIZE;
+    batch->lfsr[batch->head] = feed;
+    batch->lfsr[batch->head + CRYPTO1_BATCH_LFSR_SIZE] = feed;
+
+    return out;
+}
+
+void crypto1_batch_word(
+    Crypto1Batch* batch,
+    uint32_t in,
+    bool is_encrypted,
+    Crypto1BatchLane* keystream) {
+    furi_assert(batch);
+    furi_assert(keystream);
+
+    // Keystream bit i is in keystream[i], in the same bit order as crypto1_word
+    for(uint8_t i = 0; i < 32; i++) {
+        keystream[i] = crypto1_batch_bit(batch, CRYPTO1_BATCH_LANE(BEBIT(in, i)), is_encrypted);
+    }
+}
+
+Crypto1BatchLane crypto1_batch_check_nested_nt(
+    const uint64_t* keys,
+    size_t keys_num,
+    uint32_t cuid,
+    uint32_t nt_enc,
+    uint8_t nt_enc_parity) {
+    furi_assert(keys);
+
+    Crypto1Batch batch;
+    crypto1_batch_init(&batch, keys, keys_num);
+
+    // Same checks as crypto1_check_nested_nt, a lane stays set while its key passes them
+    Crypto1BatchLane ks[33];
+    crypto1_batch_word(&batch, nt_enc ^ cuid, true, ks);
+    ks[32] = crypto1_batch_bit(&batch, CRYPTO1_BATCH_LANE(0), false);
+
+    Crypto1BatchLane nt[32];
+    for(uint8_t i = 0; i < 32; i++) {
+        nt[i] = ks[i] ^ CRYPTO1_BATCH_LANE(BEBIT(nt_enc, i));
+    }
+
+    Crypto1BatchLane mismatch = CRYPTO1_BATCH_LANE(0);
+    for(uint8_t i = 0; i < 4; i++) {
+        Crypto1BatchLane parity = CRYPTO1_BATCH_LANE(FURI_BIT(nt_enc_parity, i)) ^ ~ks[8 * i + 8];
+        for(uint8_t j = 0; j < 8; j++) {
+            parity ^= nt[8 * i + j];
+        }
+        mismatch |= parity;
+    }
+    for(uint8_t i = 0; i < 16; i++) {
+        mismatch |= nt[i + 16] ^ nt[i] ^ nt[i + 2] ^ nt[i + 3] ^ nt[i + 5];
+    }
+
+    return ~mismatch & crypto1_batch_lane_mask(keys_num);
+}
+
 uint32_t prng_successor(uint32_t x, uint32_t n) {
     SWAPENDIAN(x);
     while(n--) x = x >> 1 | (x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) << 31;
@@ -89,6 +314,35 @@ uint32_t prng_successor(uint32_t x, uint32_t n) {
     return SWAPENDIAN(x);
 }
 
+static bool crypto1_is_prng_nonce(uint32_t nt) {
+    // The tag PRNG is a 16 bit LFSR, so the low half of its output follows from the high half
+    SWAPENDIAN(nt);
+    return ((nt ^ nt >> 2 ^ nt >> 3 ^ nt >> 5) & 0xffff) == nt >> 16;
+}
+
+bool crypto1_check_nested_nt(uint64_t key, uint32_t cuid, uint32_t nt_enc, uint8_t nt_enc_parity) {
+    Crypto1 crypto;
+    crypto1_init(&crypto, key);
+
+    // Recover nt the same way the reader side of a nested auth does
+    uint32_t ks = crypto1_word(&crypto, nt_enc ^ cuid, 1);
+    uint32_t nt = ks ^ nt_enc;
+    uint8_t ks_next = crypto1_bit(&crypto, 0, 0);
+
+    // Parity of each byte is encrypted with the keystream bit that follows it
+    bool is_valid = true;
+    for(size_t i = 0; i < 4; i++) {
+        uint8_t nt_byte = nt >> (24 - 8 * i);
+        uint8_t ks_bit = (i < 3) ? BEBIT(ks, 8 * (i + 1)) : ks_next;
+        if(FURI_BIT(nt_enc_parity, i) != (nfc_util_odd_parity8(nt_byte) ^ ks_bit)) {
+            is_valid = false;
+            break;
+        }
+    }
+
+    return is_valid && crypto1_is_prng_nonce(nt);
+}
+
 void crypto1_decrypt(Crypto1* crypto, const BitBuffer* buff, BitBuffer* out) {
     furi_assert(crypto);
     furi_assert(buff);
@@ -128,11 +382,11 @@ void crypto1_encrypt(Crypto1* crypto, uint8_t* keystream, const BitBuffer* buff,
         }
         bit_buffer_set_byte(out, 0, encrypted_byte);
     } else {
+        uint8_t ks = crypto1_filter(crypto->odd);
         for(size_t i = 0; i < bits / 8; i++) {
-            uint8_t encrypted_byte = crypto1_byte(crypto, keystream ? keystream[i] : 0, 0) ^
-                                     plain_data[i];
-            bool parity_bit =
-                ((crypto1_filter(crypto->odd) ^ nfc_util_odd_parity8(plain_data[i])) & 0x01);
+            bool parity_bit = false;
+            uint8_t encrypted_byte = crypto1_encrypt_byte(
+                crypto, keystream ? keystream[i] : 0, plain_data[i], &ks, &parity_bit);
             bit_buffer_set_byte_with_parity(out, i, encrypted_byte, parity_bit);
         }
     }
@@ -161,9 +415,10 @@ void crypto1_encrypt_reader_nonce(
         crypto1_word(crypto, nt_num ^ cuid, 0);
     }
 
+    uint8_t ks = crypto1_filter(crypto->odd);
     for(size_t i = 0; i < 4; i++) {
-        uint8_t byte = crypto1_byte(crypto, nr[i], 0) ^ nr[i];
-        bool parity_bit = ((crypto1_filter(crypto->odd) ^ nfc_util_odd_parity8(nr[i])) & 0x01);
+        bool parity_bit = false;
+        uint8_t byte = crypto1_encrypt_byte(crypto, nr[i], nr[i], &ks, &parity_bit);
         bit_buffer_set_byte_with_parity(out, i, byte, parity_bit);
         nr[i] = byte;
     }
@@ -171,8 +426,8 @@ void crypto1_encrypt_reader_nonce(
     nt_num = prng_successor(nt_num, 32);
     for(size_t i = 4; i < 8; i++) {
         nt_num = prng_successor(nt_num, 8);
-        uint8_t byte = crypto1_byte(crypto, 0, 0) ^ (uint8_t)(nt_num);
-        bool parity_bit = ((crypto1_filter(crypto->odd) ^ nfc_util_odd_parity8(nt_num)) & 0x01);
+        bool parity_bit = false;
+        uint8_t byte = crypto1_encrypt_byte(crypto, 0, (uint8_t)nt_num, &ks, &parity_bit);
         bit_buffer_set_byte_with_parity(out, i, byte, parity_bit);
     }
 }
@@ -11,6 +11,33 @@ typedef struct {
     uint32_t even;
 } Crypto1;
 
+// Bitsliced Crypto1: bit n of every lane belongs to the n-th key of a batch.
+// The device checks 32 keys at once, host builds can set 64 or 256 (a GCC vector, SIMD registers).
+#ifndef CRYPTO1_BATCH_LANE_BITS
+#define CRYPTO1_BATCH_LANE_BITS (32)
+#endif
+
+#if CRYPTO1_BATCH_LANE_BITS == 32
+typedef uint32_t Crypto1BatchLane;
+#elif CRYPTO1_BATCH_LANE_BITS == 64
+typedef uint64_t Crypto1BatchLane;
+#elif CRYPTO1_BATCH_LANE_BITS == 256
+typedef uint64_t Crypto1BatchLane __attribute__((vector_size(32)));
+#else
+#error "CRYPTO1_BATCH_LANE_BITS must be 32, 64 or 256"
+#endif
+
+#define CRYPTO1_BATCH_WIDTH ((size_t)CRYPTO1_BATCH_LANE_BITS)
+// Lane with every key bit set to bit, a vector takes the scalar for each of its elements
+#define CRYPTO1_BATCH_LANE(bit) ((Crypto1BatchLane){0} - ((bit) ? 1U : 0U))
+#define CRYPTO1_BATCH_LFSR_SIZE (48U)
+
+typedef struct {
+    // LFSR bits by age, stored twice so that reading 48 bits from head never wraps
+    Crypto1BatchLane lfsr[CRYPTO1_BATCH_LFSR_SIZE * 2];
+    uint8_t head;
+} Crypto1Batch;
+
 Crypto1* crypto1_alloc();
 
 void crypto1_free(Crypto1* instance);
@@ -38,6 +65,34 @@ void crypto1_encrypt_reader_nonce(
     BitBuffer* out,
     bool is_nested);
 
+bool crypto1_check_nested_nt(uint64_t key, uint32_t cuid, uint32_t nt_enc, uint8_t nt_enc_parity);
+
+uint32_t crypto1_decrypt_nested_nt(uint64_t key, uint32_t cuid, uint32_t nt_enc);
+
+void crypto1_batch_init(Crypto1Batch* batch, const uint64_t* keys, size_t keys_num);
+
+Crypto1BatchLane crypto1_batch_bit(Crypto1Batch* batch, Crypto1BatchLane in, bool is_encrypted);
+
+void crypto1_batch_word(
+    Crypto1Batch* batch,
+    uint32_t in,
+    bool is_encrypted,
+    Crypto1BatchLane* keystream);
+
+bool crypto1_batch_lane_get(Crypto1BatchLane lane, size_t index);
+
+bool crypto1_batch_lane_is_empty(Crypto1BatchLane lane);
+
+// Lane with the bits of the first keys_num keys set
+Crypto1BatchLane crypto1_batch_lane_mask(size_t keys_num);
+
+Crypto1BatchLane crypto1_batch_check_nested_nt(
+    const uint64_t* keys,
+    size_t keys_num,
+    uint32_t cuid,
+    uint32_t nt_enc,
+    uint8_t nt_enc_parity);
+
 uint32_t prng_successor(uint32_t x, uint32_t n);
 
 #ifdef __cplusplus
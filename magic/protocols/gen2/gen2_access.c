@@ -0,0 +1,86 @@
+#include "gen2_access.h"
+
+#include <furi/furi.h>
+
+#define GEN2_ACCESS(action) (1U << (action))
+
+#define GEN2_ACCESS_DATA_RW \
+    (GEN2_ACCESS(MfClassicActionDataRead) | GEN2_ACCESS(MfClassicActionDataWrite))
+#define GEN2_ACCESS_DATA_ALL                                     \
+    (GEN2_ACCESS_DATA_RW | GEN2_ACCESS(MfClassicActionDataInc) | \
+     GEN2_ACCESS(MfClassicActionDataDec))
+#define GEN2_ACCESS_KEYS_WRITE \
+    (GEN2_ACCESS(MfClassicActionKeyAWrite) | GEN2_ACCESS(MfClassicActionKeyBWrite))
+
+// Permissions of data blocks, indexed by [C1C2C3][key type]
+// Same as mf_classic_is_allowed_access_data_block but with sector 0 allowed
+static const uint16_t gen2_access_data_block_table[8][MfClassicKeyTypeB + 1] = {
+    [0x00] = {GEN2_ACCESS_DATA_ALL, GEN2_ACCESS_DATA_ALL},
+    [0x01] =
+        {GEN2_ACCESS(MfClassicActionDataRead) | GEN2_ACCESS(MfClassicActionDataDec),
+         GEN2_ACCESS(MfClassicActionDataRead) | GEN2_ACCESS(MfClassicActionDataDec)},
+    [0x02] = {GEN2_ACCESS(MfClassicActionDataRead), GEN2_ACCESS(MfClassicActionDataRead)},
+    [0x03] = {0, GEN2_ACCESS_DATA_RW},
+    [0x04] = {GEN2_ACCESS(MfClassicActionDataRead), GEN2_ACCESS_DATA_RW},
+    [0x05] = {0, GEN2_ACCESS(MfClassicActionDataRead)},
+    [0x06] =
+        {GEN2_ACCESS(MfClassicActionDataRead) | GEN2_ACCESS(MfClassicActionDataDec),
+         GEN2_ACCESS_DATA_ALL},
+    [0x07] = {0, 0},
+};
+
+// Permissions of sector trailers, indexed by [C1C2C3][key type]
+static const uint16_t gen2_access_trailer_table[8][MfClassicKeyTypeB + 1] = {
+    [0x00] =
+        {GEN2_ACCESS_KEYS_WRITE | GEN2_ACCESS(MfClassicActionKeyBRead) |
+             GEN2_ACCESS(MfClassicActionACRead),
+         GEN2_ACCESS_KEYS_WRITE | GEN2_ACCESS(MfClassicActionKeyBRead) |
+             GEN2_ACCESS(MfClassicActionACRead)},
+    [0x01] =
+        {GEN2_ACCESS_KEYS_WRITE | GEN2_ACCESS(MfClassicActionKeyBRead) |
+             GEN2_ACCESS(MfClassicActionACRead) | GEN2_ACCESS(MfClassicActionACWrite),
+         GEN2_ACCESS_KEYS_WRITE | GEN2_ACCESS(MfClassicActionKeyBRead) |
+             GEN2_ACCESS(MfClassicActionACRead) | GEN2_ACCESS(MfClassicActionACWrite)},
+    [0x02] =
+        {GEN2_ACCESS(MfClassicActionKeyBRead) | GEN2_ACCESS(MfClassicActionACRead),
+         GEN2_ACCESS(MfClassicActionKeyBRead) | GEN2_ACCESS(MfClassicActionACRead)},
+    [0x03] =
+        {GEN2_ACCESS(MfClassicActionACRead),
+         GEN2_ACCESS_KEYS_WRITE | GEN2_ACCESS(MfClassicActionACRead) |
+             GEN2_ACCESS(MfClassicActionACWrite)},
+    [0x04] =
+        {GEN2_ACCESS(MfClassicActionACRead),
+         GEN2_ACCESS_KEYS_WRITE | GEN2_ACCESS(MfClassicActionACRead)},
+    [0x05] =
+        {GEN2_ACCESS(MfClassicActionACRead),
+         GEN2_ACCESS(MfClassicActionACRead) | GEN2_ACCESS(MfClassicActionACWrite)},
+    [0x06] = {GEN2_ACCESS(MfClassicActionACRead), GEN2_ACCESS(MfClassicActionACRead)},
+    [0x07] = {GEN2_ACCESS(MfClassicActionACRead), GEN2_ACCESS(MfClassicActionACRead)},
+};
+
+uint8_t gen2_access_get_conditions(const MfClassicAccessBits* access_bits, uint8_t sector_block) {
+    furi_assert(access_bits);
+    furi_assert(sector_block <= GEN2_ACCESS_TRAILER_INDEX);
+
+    // Byte 7 holds C1 in its high nibble, byte 8 holds C2 low and C3 high
+    const uint8_t* data = access_bits->data;
+    uint8_t c1 = (data[1] >> (4 + sector_block)) & 0x01;
+    uint8_t c2 = (data[2] >> sector_block) & 0x01;
+    uint8_t c3 = (data[2] >> (4 + sector_block)) & 0x01;
+
+    return (c1 << 2) | (c2 << 1) | c3;
+}
+
+bool gen2_access_is_allowed(
+    uint8_t conditions,
+    bool is_trailer,
+    MfClassicKeyType key_type,
+    MfClassicAction action) {
+    furi_assert(conditions < 8);
+    furi_assert(key_type <= MfClassicKeyTypeB);
+
+    const uint16_t(*table)[MfClassicKeyTypeB + 1] =
+        is_trailer ? gen2_access_trailer_table : gen2_access_data_block_table;
+
+    return (table[conditions][key_type] & GEN2_ACCESS(action)) != 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <nfc/protocols/mf_classic/mf_classic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEN2_ACCESS_TRAILER_INDEX (3)
+
+/**
+ * @brief Extract the C1C2C3 access condition triple of one block from the access bits.
+ *
+ * @param access_bits Access bits of the sector trailer.
+ * @param sector_block Index of the block inside the sector group, 3 for the trailer.
+ * @return C1 << 2 | C2 << 1 | C3.
+ */
+uint8_t gen2_access_get_conditions(const MfClassicAccessBits* access_bits, uint8_t sector_block);
+
+/**
+ * @brief Look up whether a key is allowed to perform an action under an AC triple.
+ *
+ * @param conditions C1C2C3 triple as returned by gen2_access_get_conditions().
+ * @param is_trailer Whether the conditions belong to the sector trailer.
+ * @param key_type Key used to authenticate.
+ * @param action Action to check.
+ * @return true if allowed.
+ */
+bool gen2_access_is_allowed(
+    uint8_t conditions,
+    bool is_trailer,
+    MfClassicKeyType key_type,
+    MfClassicAction action);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,78 @@
+#include "gen2_nonce_log.h"
+
+#include <furi.h>
+
+#define TAG "Gen2NonceLog"
+
+// About 900 lines, plenty for a few runs over every sector of a 4K card
+#define GEN2_NONCE_LOG_SIZE_MAX (64 * 1024)
+
+// Moves a full log to <path>.old, dropping the previous one, so at most two are kept
+static void gen2_nonce_log_rotate(Storage* storage, const char* path) {
+    FileInfo file_info = {};
+    if(storage_common_stat(storage, path, &file_info) != FSE_OK) return;
+    if(file_info.size < GEN2_NONCE_LOG_SIZE_MAX) return;
+
+    FuriString* old_path = furi_string_alloc_printf("%s.old", path);
+    storage_common_remove(storage, furi_string_get_cstr(old_path));
+    if(storage_common_rename(storage, path, furi_string_get_cstr(old_path)) != FSE_OK) {
+        FURI_LOG_W(TAG, "Failed to rotate %s, starting over", path);
+        storage_common_remove(storage, path);
+    }
+    furi_string_free(old_path);
+}
+
+bool gen2_nonce_log_save(
+    Storage* storage,
+    const char* path,
+    const Gen2NestedNt* nested_nts,
+    size_t nested_nt_num) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(nested_nts);
+
+    bool saved = true;
+    File* file = storage_file_alloc(storage);
+    FuriString* line = furi_string_alloc();
+
+    do {
+        size_t missing_num = 0;
+        for(size_t i = 0; i < nested_nt_num; i++) {
+            if(!nested_nts[i].key_found) missing_num++;
+        }
+        if(missing_num == 0) break;
+
+        gen2_nonce_log_rotate(storage, path);
+        if(!storage_file_open(file, path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+            FURI_LOG_E(TAG, "Failed to open %s", path);
+            saved = false;
+            break;
+        }
+
+        for(size_t i = 0; (i < nested_nt_num) && saved; i++) {
+            const Gen2NestedNt* nested_nt = &nested_nts[i];
+            if(nested_nt->key_found) continue;
+
+            furi_string_printf(
+                line,
+                "Sec %d key %c cuid %08lx nt0 %08lx nt1 %08lx par1 %x\n",
+                nested_nt->sector,
+                (nested_nt->key_type == MfClassicKeyTypeA) ? 'A' : 'B',
+                nested_nt->cuid,
+                nested_nt->nt_prev,
+                nested_nt->nt_enc,
+                nested_nt->nt_enc_parity);
+            size_t line_len = furi_string_size(line);
+            saved = (storage_file_write(file, furi_string_get_cstr(line), line_len) == line_len);
+        }
+        storage_file_close(file);
+        if(saved) {
+            FURI_LOG_I(TAG, "Saved %zu nonces", missing_num);
+        }
+    } while(false);
+
+    furi_string_free(line);
+    storage_file_free(file);
+
+    return saved;
+}
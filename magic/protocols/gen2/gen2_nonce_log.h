@@ -0,0 +1,23 @@
+#pragma once
+
+#include "gen2_poller.h"
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Appends the nonces whose key wasn't found, one per line:
+// Sec <sector> key <A|B> cuid <cuid> nt0 <nt_prev> nt1 <nt_enc> par1 <nt_enc_parity>
+// Values are hex, parity bit n belongs to byte n of nt1.
+// A log over 64 KiB is moved to <path>.old first. tools/gen2_recover and
+// tools/gen2_dict_check read either file.
+bool gen2_nonce_log_save(
+    Storage* storage,
+    const char* path,
+    const Gen2NestedNt* nested_nts,
+    size_t nested_nt_num);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,6 @@
 #include "gen2_poller_i.h"
 #include <nfc/helpers/nfc_data_generator.h>
+#include <bit_lib/bit_lib.h>
 
 #include <furi/furi.h>
 
@@ -16,8 +17,17 @@ typedef struct {
     FuriThreadId thread_id;
     bool detected;
     Gen2PollerError error;
+    NfcMagicFingerprint* fingerprint;
 } Gen2PollerDetectContext;
 
+// Every block already gets an activation and an auth of its own, so a short backoff is enough
+// and a block that keeps failing through that is more likely refused than lost
+static const NfcMagicRetryPolicy gen2_poller_retry_policy = {
+    .block_retries = 2,
+    .backoff_resets_min = 1,
+    .backoff_resets_max = 2,
+};
+
 // Array of known Gen2 ATS responses
 // 0978009102DABC1910F005 - flavour 2
 // 0978009102DABC1910F005 - flavour 4
@@ -68,7 +78,7 @@ static const MfClassicBlock gen2_poller_default_empty_block = {
          0x00},
 };
 
-static MfClassicBlock gen2_poller_default_sector_trailer_block = {
+static const MfClassicBlock gen2_poller_default_sector_trailer_block = {
     .data =
         {0xFF,
          0xFF,
@@ -88,6 +98,8 @@ static MfClassicBlock gen2_poller_default_sector_trailer_block = {
          0xFF},
 };
 
+static const uint8_t gen2_poller_default_access_bits[] = {0xFF, 0x07, 0x80};
+
 const char* const gen2_problem_strings[] = {
     "UID may be non-\nrewritable. Check data after writing",
     "No data in selected file",
@@ -99,27 +111,24 @@ const char* const gen2_problem_strings[] = {
 Gen2Poller* gen2_poller_alloc(Nfc* nfc) {
     Gen2Poller* instance = malloc(sizeof(Gen2Poller));
     instance->poller = nfc_poller_alloc(nfc, NfcProtocolIso14443_3a);
-    instance->data = mf_classic_alloc();
+    instance->iso3_data = iso14443_3a_alloc();
     instance->crypto = crypto1_alloc();
     instance->tx_plain_buffer = bit_buffer_alloc(GEN2_POLLER_MAX_BUFFER_SIZE);
     instance->tx_encrypted_buffer = bit_buffer_alloc(GEN2_POLLER_MAX_BUFFER_SIZE);
     instance->rx_plain_buffer = bit_buffer_alloc(GEN2_POLLER_MAX_BUFFER_SIZE);
     instance->rx_encrypted_buffer = bit_buffer_alloc(GEN2_POLLER_MAX_BUFFER_SIZE);
     instance->card_state = Gen2CardStateLost;
+    nfc_magic_resume_reset(&instance->mode_ctx.write_ctx.resume);
+    nfc_magic_retry_init(&instance->retry, &gen2_poller_retry_policy);
 
     instance->gen2_event.data = &instance->gen2_event_data;
 
-    instance->mode_ctx.write_ctx.mfc_data_source = malloc(sizeof(MfClassicData));
-    instance->mode_ctx.write_ctx.mfc_data_target = malloc(sizeof(MfClassicData));
-
-    instance->mode_ctx.write_ctx.need_halt_before_write = true;
-
     return instance;
 }
 
 void gen2_poller_free(Gen2Poller* instance) {
     furi_assert(instance);
-    furi_assert(instance->data);
+    furi_assert(instance->iso3_data);
     furi_assert(instance->crypto);
     furi_assert(instance->tx_plain_buffer);
     furi_assert(instance->rx_plain_buffer);
@@ -127,19 +136,26 @@ void gen2_poller_free(Gen2Poller* instance) {
     furi_assert(instance->rx_encrypted_buffer);
 
     nfc_poller_free(instance->poller);
-    mf_classic_free(instance->data);
+    iso14443_3a_free(instance->iso3_data);
+    if(instance->mfc_data) {
+        mf_classic_free(instance->mfc_data);
+    }
     crypto1_free(instance->crypto);
     bit_buffer_free(instance->tx_plain_buffer);
     bit_buffer_free(instance->rx_plain_buffer);
     bit_buffer_free(instance->tx_encrypted_buffer);
     bit_buffer_free(instance->rx_encrypted_buffer);
 
-    free(instance->mode_ctx.write_ctx.mfc_data_source);
-    free(instance->mode_ctx.write_ctx.mfc_data_target);
-
     free(instance);
 }
 
+void gen2_poller_set_retry_policy(Gen2Poller* instance, const NfcMagicRetryPolicy* policy) {
+    furi_assert(instance);
+    furi_assert(policy);
+
+    nfc_magic_retry_init(&instance->retry, policy);
+}
+
 NfcCommand gen2_poller_detect_callback(NfcGenericEvent event, void* context) {
     furi_assert(context);
     furi_assert(event.protocol == NfcProtocolIso14443_3a);
@@ -179,6 +195,14 @@ NfcCommand gen2_poller_detect_callback(NfcGenericEvent event, void* context) {
                         break;
                     }
                 }
+                if(detect_ctx->error == Gen2PollerErrorNone) {
+                    nfc_magic_fingerprint_set_iso14443_3a(
+                        detect_ctx->fingerprint, nfc_poller_get_data(detect_ctx->poller));
+                    nfc_magic_fingerprint_set_ats(
+                        detect_ctx->fingerprint,
+                        bit_buffer_get_data(detect_ctx->rx_buffer),
+                        bit_buffer_get_size_bytes(detect_ctx->rx_buffer));
+                }
             }
         } while(false);
     } else if(iso3_event->type == Iso14443_3aPollerEventTypeError) {
@@ -189,16 +213,19 @@ NfcCommand gen2_poller_detect_callback(NfcGenericEvent event, void* context) {
     return command;
 }
 
-Gen2PollerError gen2_poller_detect(Nfc* nfc) {
-    furi_assert(nfc);
+Gen2PollerError gen2_poller_detect(NfcMagicDetectContext* magic_detect_ctx) {
+    furi_assert(magic_detect_ctx);
+
+    nfc_magic_detect_context_reset(magic_detect_ctx);
 
     Gen2PollerDetectContext detect_ctx = {
-        .poller = nfc_poller_alloc(nfc, NfcProtocolIso14443_3a),
-        .tx_buffer = bit_buffer_alloc(GEN2_POLLER_MAX_BUFFER_SIZE),
-        .rx_buffer = bit_buffer_alloc(GEN2_POLLER_MAX_BUFFER_SIZE),
+        .poller = nfc_poller_alloc(magic_detect_ctx->nfc, NfcProtocolIso14443_3a),
+        .tx_buffer = magic_detect_ctx->tx_buffer,
+        .rx_buffer = magic_detect_ctx->rx_buffer,
         .thread_id = furi_thread_get_current_id(),
         .detected = false,
         .error = Gen2PollerErrorNone,
+        .fingerprint = &magic_detect_ctx->fingerprint,
     };
 
     nfc_poller_start(detect_ctx.poller, gen2_poller_detect_callback, &detect_ctx);
@@ -209,8 +236,6 @@ Gen2PollerError gen2_poller_detect(Nfc* nfc) {
     }
     nfc_poller_stop(detect_ctx.poller);
 
-    bit_buffer_free(detect_ctx.tx_buffer);
-    bit_buffer_free(detect_ctx.rx_buffer);
     nfc_poller_free(detect_ctx.poller);
 
     return detect_ctx.error;
@@ -221,7 +246,6 @@ NfcCommand gen2_poller_idle_handler(Gen2Poller* instance) {
 
     NfcCommand command = NfcCommandContinue;
 
-    instance->mode_ctx.write_ctx.current_block = 0;
     instance->gen2_event.type = Gen2PollerEventTypeDetected;
     command = instance->callback(instance->gen2_event, instance->context);
     instance->state = Gen2PollerStateRequestMode;
@@ -239,6 +263,8 @@ NfcCommand gen2_poller_request_mode_handler(Gen2Poller* instance) {
     instance->mode = instance->gen2_event_data.poller_mode.mode;
     if(instance->gen2_event_data.poller_mode.mode == Gen2PollerModeWipe) {
         instance->state = Gen2PollerStateWriteTargetDataRequest;
+    } else if(instance->gen2_event_data.poller_mode.mode == Gen2PollerModeCheckKeys) {
+        instance->state = Gen2PollerStateKeyCheckDataRequest;
     } else {
         instance->state = Gen2PollerStateWriteSourceDataRequest;
     }
@@ -250,12 +276,16 @@ NfcCommand gen2_poller_write_source_data_request_handler(Gen2Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     instance->gen2_event.type = Gen2PollerEventTypeRequestDataToWrite;
+    instance->gen2_event_data.data_to_write.block_source = NULL;
     command = instance->callback(instance->gen2_event, instance->context);
-    memcpy(
-        instance->mode_ctx.write_ctx.mfc_data_source,
-        instance->gen2_event_data.data_to_write.mfc_data,
-        sizeof(MfClassicData));
-    instance->state = Gen2PollerStateWriteTargetDataRequest;
+    NfcMagicBlockSource* source = instance->gen2_event_data.data_to_write.block_source;
+    instance->mode_ctx.write_ctx.block_source = source;
+    if(source && (nfc_magic_block_source_get_protocol(source) == NfcProtocolMfClassic)) {
+        instance->state = Gen2PollerStateWriteTargetDataRequest;
+    } else {
+        FURI_LOG_E(TAG, "No MIFARE Classic image to write");
+        instance->state = Gen2PollerStateFail;
+    }
 
     return command;
 }
@@ -265,17 +295,95 @@ NfcCommand gen2_poller_write_target_data_request_handler(Gen2Poller* instance) {
 
     instance->gen2_event.type = Gen2PollerEventTypeRequestTargetData;
     command = instance->callback(instance->gen2_event, instance->context);
-    memcpy(
-        instance->mode_ctx.write_ctx.mfc_data_target,
-        instance->gen2_event_data.target_data.mfc_data,
-        sizeof(MfClassicData));
-    if(instance->mode == Gen2PollerModeWipe) {
-        instance->state = Gen2PollerStateWipe;
+    Gen2PollerWriteContext* write_ctx = &instance->mode_ctx.write_ctx;
+    write_ctx->mfc_data_target = instance->gen2_event_data.target_data.mfc_data;
+    write_ctx->need_halt_before_write = true;
+
+    do {
+        uint16_t total_block_num =
+            mf_classic_get_total_block_num(write_ctx->mfc_data_target->type);
+        uint32_t source_hash = nfc_magic_resume_hash(
+            NFC_MAGIC_RESUME_HASH_INIT,
+            write_ctx->mfc_data_target->block,
+            total_block_num * sizeof(MfClassicBlock));
+        if(instance->mode == Gen2PollerModeWrite) {
+            uint32_t image_hash = 0;
+            if(!nfc_magic_block_source_get_hash(write_ctx->block_source, &image_hash)) {
+                FURI_LOG_E(TAG, "Failed to read the image to write");
+                instance->state = Gen2PollerStateFail;
+                break;
+            }
+            source_hash = nfc_magic_resume_hash(source_hash, &image_hash, sizeof(image_hash));
+        }
+        const Iso14443_3aData* iso3_data = nfc_poller_get_data(instance->poller);
+        write_ctx->current_block = nfc_magic_resume_bind(
+            &write_ctx->resume, iso3_data->uid, iso3_data->uid_len, source_hash);
+        write_ctx->is_retry = false;
+        // ACs reset before the card was lost are still reset
+        if(write_ctx->current_block == 0) {
+            memset(write_ctx->access_reset, 0, sizeof(write_ctx->access_reset));
+            memset(write_ctx->access_reset_failed, 0, sizeof(write_ctx->access_reset_failed));
+        }
+        gen2_write_plan_compile(
+            &write_ctx->plan,
+            (instance->mode == Gen2PollerModeWrite) ? write_ctx->block_source : NULL,
+            write_ctx->mfc_data_target);
+        if(instance->mode == Gen2PollerModeWipe) {
+            instance->state = Gen2PollerStateWipe;
+        } else {
+            instance->state = Gen2PollerStateWrite;
+        }
+
+        if(write_ctx->current_block > 0) {
+            instance->gen2_event.type = Gen2PollerEventTypeResumed;
+            instance->gen2_event_data.resumed.block = write_ctx->current_block;
+            command = instance->callback(instance->gen2_event, instance->context);
+        }
+    } while(false);
+
+    return command;
+}
+
+static bool gen2_poller_is_sector_set(const uint8_t* sectors, uint8_t sector_num) {
+    return (sectors[sector_num / 8] & (1U << (sector_num % 8))) != 0;
+}
+
+static void gen2_poller_set_sector(uint8_t* sectors, uint8_t sector_num, bool is_set) {
+    if(is_set) {
+        sectors[sector_num / 8] |= (1U << (sector_num % 8));
     } else {
-        instance->state = Gen2PollerStateWrite;
+        sectors[sector_num / 8] &= ~(1U << (sector_num % 8));
     }
+}
 
-    return command;
+// Target block as it is on the card now: the snapshot plus the ACs reset in this session
+static void gen2_poller_get_target_block(
+    const Gen2PollerWriteContext* write_ctx,
+    uint8_t block_num,
+    MfClassicBlock* block) {
+    *block = write_ctx->mfc_data_target->block[block_num];
+    if(mf_classic_is_sector_trailer(block_num) &&
+       gen2_poller_is_sector_set(
+           write_ctx->access_reset, mf_classic_get_sector_by_block(block_num))) {
+        memcpy(
+            block->data + 6,
+            gen2_poller_default_access_bits,
+            sizeof(gen2_poller_default_access_bits));
+    }
+}
+
+static void gen2_poller_set_auth_key(
+    Gen2PollerWriteContext* write_ctx,
+    uint8_t block_num,
+    MfClassicKeyType key_type) {
+    MfClassicSectorTrailer* sec_tr = mf_classic_get_sector_trailer_by_sector(
+        write_ctx->mfc_data_target, mf_classic_get_sector_by_block(block_num));
+    write_ctx->write_key = key_type;
+    if(key_type == MfClassicKeyTypeA) {
+        write_ctx->auth_key = sec_tr->key_a;
+    } else {
+        write_ctx->auth_key = sec_tr->key_b;
+    }
 }
 
 Gen2PollerError gen2_poller_write_block_handler(
@@ -290,91 +398,143 @@ Gen2PollerError gen2_poller_write_block_handler(
 
     do {
         // Compare the target and source data
-        if(memcmp(block->data, write_ctx->mfc_data_target->block[block_num].data, 16) == 0) {
+        MfClassicBlock target_block;
+        gen2_poller_get_target_block(write_ctx, block_num, &target_block);
+        if(memcmp(block->data, target_block.data, GEN2_POLLER_BLOCK_SIZE) == 0) {
             FURI_LOG_D(TAG, "Block %d is the same, skipping", block_num);
             break;
         }
 
         // Reauth if necessary
         if(write_ctx->need_halt_before_write) {
-            FURI_LOG_D(TAG, "Auth before writing block %d", write_ctx->current_block);
-            error = gen2_poller_auth(
-                instance, write_ctx->current_block, &auth_key, write_ctx->write_key, NULL);
+            FURI_LOG_D(TAG, "Auth before writing block %d", block_num);
+            error = gen2_poller_auth(instance, block_num, &auth_key, write_ctx->write_key, NULL);
             if(error != Gen2PollerErrorNone) {
-                FURI_LOG_D(
-                    TAG, "Failed to auth to block %d for writing", write_ctx->current_block);
+                FURI_LOG_D(TAG, "Failed to auth to block %d for writing", block_num);
                 break;
             }
         }
 
         // Write the block
-        error = gen2_poller_write_block(instance, write_ctx->current_block, block);
+        error = gen2_poller_write_block(instance, block_num, block);
         if(error != Gen2PollerErrorNone) {
-            FURI_LOG_D(TAG, "Failed to write block %d", write_ctx->current_block);
+            FURI_LOG_D(TAG, "Failed to write block %d", block_num);
             break;
         }
     } while(false);
-    FURI_LOG_D(TAG, "Block %d finished, halting", write_ctx->current_block);
+    FURI_LOG_D(TAG, "Block %d finished, halting", block_num);
     gen2_poller_halt(instance);
     return error;
 }
 
-NfcCommand gen2_poller_wipe_handler(Gen2Poller* instance) {
-    NfcCommand command = NfcCommandContinue;
-    Gen2PollerError error = Gen2PollerErrorNone;
+// Follow the write plan for block_num: reset the sector ACs if planned and pick the write key.
+// Returns false if the block is not to be written, error says whether that counts as a failure.
+static bool gen2_poller_prepare_block_write(
+    Gen2Poller* instance,
+    uint8_t block_num,
+    Gen2PollerError* error) {
     Gen2PollerWriteContext* write_ctx = &instance->mode_ctx.write_ctx;
-    uint8_t block_num = write_ctx->current_block;
+    const Gen2WritePlanStep* step = &write_ctx->plan.steps[block_num];
+    uint8_t sector_num = mf_classic_get_sector_by_block(block_num);
+    bool prepared = false;
 
     do {
-        // Check whether the ACs for that block are known in target data
-        if(!mf_classic_is_block_read(
-               write_ctx->mfc_data_target,
-               mf_classic_get_sector_trailer_num_by_block(block_num))) {
-            FURI_LOG_E(TAG, "Sector trailer for block %d not present in target data", block_num);
+        if(step->action == Gen2WritePlanActionSkip) break;
+        if(step->action == Gen2WritePlanActionImpossible) {
+            FURI_LOG_E(TAG, "Block %d cannot be written", block_num);
             break;
         }
 
-        // Check whether ACs need to be reset and whether they can be reset
-        if(!gen2_poller_can_write_block(write_ctx->mfc_data_target, block_num)) {
-            if(!gen2_can_reset_access_conditions(write_ctx->mfc_data_target, block_num)) {
-                FURI_LOG_E(TAG, "Block %d cannot be written", block_num);
+        if(step->action == Gen2WritePlanActionResetAccessAndWrite) {
+            uint8_t sector_tr_num = mf_classic_get_sector_trailer_num_by_block(block_num);
+            FURI_LOG_D(TAG, "Resetting ACs for sector %d", sector_num);
+
+            // Sector trailer with the old keys and default ACs (0xFF, 0x07, 0x80)
+            MfClassicBlock block = write_ctx->mfc_data_target->block[sector_tr_num];
+            memcpy(
+                block.data + 6,
+                gen2_poller_default_access_bits,
+                sizeof(gen2_poller_default_access_bits));
+
+            gen2_poller_set_auth_key(write_ctx, sector_tr_num, step->reset_key);
+            *error = gen2_poller_write_block_handler(instance, sector_tr_num, &block);
+            // Cleared again if a retry of this block gets the reset through
+            gen2_poller_set_sector(
+                write_ctx->access_reset_failed, sector_num, *error != Gen2PollerErrorNone);
+            if(*error != Gen2PollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to reset ACs for sector %d", sector_num);
                 break;
-            } else {
-                FURI_LOG_D(TAG, "Resetting ACs for block %d", block_num);
-                // Generate a block with old keys and default ACs (0xFF, 0x07, 0x80)
-                MfClassicBlock block;
-                memset(&block, 0, sizeof(block));
-                memcpy(block.data, write_ctx->mfc_data_target->block[block_num].data, 16);
-                memcpy(block.data + 6, "\xFF\x07\x80", 3);
-
-                error = gen2_poller_write_block_handler(instance, block_num, &block);
-                if(error != Gen2PollerErrorNone) {
-                    FURI_LOG_E(TAG, "Failed to reset ACs for block %d", block_num);
-                    break;
-                } else {
-                    FURI_LOG_D(TAG, "ACs for block %d reset", block_num);
-                    memcpy(write_ctx->mfc_data_target->block[block_num].data, block.data, 16);
-                }
             }
+            FURI_LOG_D(TAG, "ACs for sector %d reset", sector_num);
+            gen2_poller_set_sector(write_ctx->access_reset, sector_num, true);
+        } else if(gen2_poller_is_sector_set(write_ctx->access_reset_failed, sector_num)) {
+            // The plan picked the key for default ACs, the card still has the old ones
+            FURI_LOG_E(TAG, "Block %d needs the AC reset that failed", block_num);
+            *error = Gen2PollerErrorAccess;
+            break;
         }
 
-        // Figure out which key to use for writing
-        write_ctx->write_key =
-            gen2_poller_get_key_type_to_write(write_ctx->mfc_data_target, block_num);
+        gen2_poller_set_auth_key(write_ctx, block_num, step->write_key);
+        prepared = true;
+    } while(false);
 
-        // Get the key to use for writing from the target data
-        MfClassicSectorTrailer* sec_tr = mf_classic_get_sector_trailer_by_sector(
-            write_ctx->mfc_data_target, mf_classic_get_sector_by_block(block_num));
-        if(write_ctx->write_key == MfClassicKeyTypeA) {
-            write_ctx->auth_key = sec_tr->key_a;
-        } else {
-            write_ctx->auth_key = sec_tr->key_b;
+    return prepared;
+}
+
+// Every block is written in its own activation. A block failing on a transient error
+// is retried after the field was off for a while. Out of retries, a block cut short by
+// card loss is retried once the same card is back, failing a second time skips it.
+static NfcCommand gen2_poller_finish_block(Gen2Poller* instance, Gen2PollerError error) {
+    NfcCommand command = NfcCommandContinue;
+    Gen2PollerWriteContext* write_ctx = &instance->mode_ctx.write_ctx;
+    bool is_lost = (error == Gen2PollerErrorTimeout) || (error == Gen2PollerErrorNotPresent);
+    bool is_transient = is_lost || (error == Gen2PollerErrorCommunication);
+
+    if(is_transient && nfc_magic_retry_schedule(&instance->retry)) {
+        FURI_LOG_D(TAG, "Retrying block %d", write_ctx->current_block);
+        instance->state = Gen2PollerStateWriteResume;
+        instance->gen2_event.type = Gen2PollerEventTypeRetry;
+        instance->gen2_event_data.retry.block = write_ctx->current_block;
+        instance->gen2_event_data.retry.stats = instance->retry.stats;
+        command = instance->callback(instance->gen2_event, instance->context);
+    } else if(
+        is_lost && !write_ctx->is_retry && nfc_magic_resume_has_progress(&write_ctx->resume)) {
+        FURI_LOG_D(TAG, "Block %d lost, waiting for the card", write_ctx->current_block);
+        nfc_magic_retry_end_block(&instance->retry, false);
+        write_ctx->is_retry = true;
+        instance->state = Gen2PollerStateWriteResume;
+        instance->gen2_event.type = Gen2PollerEventTypeCardLost;
+        command = instance->callback(instance->gen2_event, instance->context);
+    } else {
+        if(error != Gen2PollerErrorNone) {
+            FURI_LOG_D(TAG, "Error occurred: %d", error);
         }
+        write_ctx->is_retry = false;
+        nfc_magic_retry_end_block(&instance->retry, error == Gen2PollerErrorNone);
+        write_ctx->current_block++;
+        nfc_magic_resume_advance(&write_ctx->resume, write_ctx->current_block);
+    }
+
+    return command;
+}
+
+NfcCommand gen2_poller_wipe_handler(Gen2Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    Gen2PollerError error = Gen2PollerErrorNone;
+    Gen2PollerWriteContext* write_ctx = &instance->mode_ctx.write_ctx;
+    uint8_t block_num = write_ctx->current_block;
+
+    do {
+        if(!gen2_poller_prepare_block_write(instance, block_num, &error)) break;
 
         // Write the default block depending on the block type
         if(block_num == 0) {
             error =
                 gen2_poller_write_block_handler(instance, block_num, &gen2_poller_default_block_0);
+            if(error == Gen2PollerErrorNone) {
+                // The default block 0 holds a single size UID
+                nfc_magic_resume_set_uid(&write_ctx->resume, gen2_poller_default_block_0.data, 4);
+            }
         } else if(mf_classic_is_sector_trailer(block_num)) {
             error = gen2_poller_write_block_handler(
                 instance, block_num, &gen2_poller_default_sector_trailer_block);
@@ -387,11 +547,7 @@ NfcCommand gen2_poller_wipe_handler(Gen2Poller* instance) {
         }
     } while(false);
 
-    write_ctx->current_block++;
-
-    if(error != Gen2PollerErrorNone) {
-        FURI_LOG_D(TAG, "Error occurred: %d", error);
-    }
+    command = gen2_poller_finish_block(instance, error);
 
     if(write_ctx->current_block ==
        mf_classic_get_total_block_num(write_ctx->mfc_data_target->type)) {
@@ -405,74 +561,300 @@ NfcCommand gen2_poller_write_handler(Gen2Poller* instance) {
     NfcCommand command = NfcCommandContinue;
     Gen2PollerError error = Gen2PollerErrorNone;
     Gen2PollerWriteContext* write_ctx = &instance->mode_ctx.write_ctx;
+    NfcMagicBlockSource* source = write_ctx->block_source;
     uint8_t block_num = write_ctx->current_block;
 
-    do {
-        // Check whether the block is present in the source data
-        if(!mf_classic_is_block_read(write_ctx->mfc_data_source, block_num)) {
-            // FURI_LOG_E(TAG, "Block %d not present in source data", block_num);
-            break;
+    // Blocks are requested in order, the source keeps only the current sector
+    MfClassicBlock block = {};
+    if(!nfc_magic_block_source_read_block(source, block_num, &block)) {
+        FURI_LOG_E(TAG, "Failed to read %d block", block_num);
+        instance->state = Gen2PollerStateFail;
+    } else {
+        do {
+            if(!gen2_poller_prepare_block_write(instance, block_num, &error)) break;
+
+            // Write the block
+            error = gen2_poller_write_block_handler(instance, block_num, &block);
+            if(error != Gen2PollerErrorNone) {
+                FURI_LOG_E(TAG, "Couldn't write block %d", block_num);
+            } else if(block_num == 0) {
+                // The card answers with the new UID from now on
+                nfc_magic_resume_set_uid(
+                    &write_ctx->resume,
+                    block.data,
+                    nfc_magic_block_source_get_iso14443_3a_data(source)->uid_len);
+            }
+        } while(false);
+
+        command = gen2_poller_finish_block(instance, error);
+
+        if(write_ctx->current_block ==
+           mf_classic_get_total_block_num(nfc_magic_block_source_get_type(source))) {
+            instance->state = Gen2PollerStateSuccess;
+        }
+    }
+
+    return command;
+}
+
+NfcCommand gen2_poller_write_resume_handler(Gen2Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    Gen2PollerWriteContext* write_ctx = &instance->mode_ctx.write_ctx;
+    const Iso14443_3aData* iso3_data = nfc_poller_get_data(instance->poller);
+
+    if(nfc_magic_resume_is_same_card(&write_ctx->resume, iso3_data->uid, iso3_data->uid_len)) {
+        FURI_LOG_D(TAG, "Card is back, resuming at block %d", write_ctx->current_block);
+        // A retried block is not news to the scene
+        if(!nfc_magic_retry_is_pending(&instance->retry)) {
+            instance->gen2_event.type = Gen2PollerEventTypeResumed;
+            instance->gen2_event_data.resumed.block = write_ctx->current_block;
+            command = instance->callback(instance->gen2_event, instance->context);
         }
+        instance->state = (instance->mode == Gen2PollerModeWipe) ? Gen2PollerStateWipe :
+                                                                    Gen2PollerStateWrite;
+    } else {
+        // Not the card being written, leave it alone
+        iso14443_3a_poller_halt(instance->iso3_poller);
+    }
+
+    return command;
+}
 
-        // Check whether the ACs for that block are known in target data
-        if(!mf_classic_is_block_read(
-               write_ctx->mfc_data_target,
-               mf_classic_get_sector_trailer_num_by_block(block_num))) {
-            FURI_LOG_E(TAG, "Sector trailer for block %d not present in target data", block_num);
+static bool gen2_poller_find_known_key(Gen2Poller* instance) {
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    const MfClassicData* mfc_data = instance->mfc_data;
+    uint8_t total_sectors = mf_classic_get_total_sectors_num(mfc_data->type);
+    bool found = false;
+
+    for(uint8_t sector = 0; sector < total_sectors; sector++) {
+        MfClassicSectorTrailer* sec_tr = mf_classic_get_sector_trailer_by_sector(mfc_data, sector);
+        if(mf_classic_is_key_found(mfc_data, sector, MfClassicKeyTypeA)) {
+            key_check_ctx->known_key = sec_tr->key_a;
+            key_check_ctx->known_key_type = MfClassicKeyTypeA;
+            found = true;
+        } else if(mf_classic_is_key_found(mfc_data, sector, MfClassicKeyTypeB)) {
+            key_check_ctx->known_key = sec_tr->key_b;
+            key_check_ctx->known_key_type = MfClassicKeyTypeB;
+            found = true;
+        }
+        if(found) {
+            key_check_ctx->known_sector = sector;
             break;
         }
+    }
 
-        // Check whether ACs need to be reset and whether they can be reset
-        if(!gen2_poller_can_write_block(write_ctx->mfc_data_target, block_num)) {
-            if(!gen2_can_reset_access_conditions(write_ctx->mfc_data_target, block_num)) {
-                FURI_LOG_E(TAG, "Block %d cannot be written", block_num);
-                break;
+    return found;
+}
+
+NfcCommand gen2_poller_key_check_data_request_handler(Gen2Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+
+    instance->gen2_event.type = Gen2PollerEventTypeRequestKeys;
+    command = instance->callback(instance->gen2_event, instance->context);
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    memset(key_check_ctx, 0, sizeof(Gen2PollerKeyCheckContext));
+    key_check_ctx->dict = instance->gen2_event_data.request_keys.dict;
+
+    if(!instance->mfc_data) {
+        instance->mfc_data = mf_classic_alloc();
+    }
+    mf_classic_copy(instance->mfc_data, instance->gen2_event_data.request_keys.mfc_data);
+
+    if(gen2_poller_find_known_key(instance)) {
+        instance->state = Gen2PollerStateCheckKeys;
+    } else {
+        FURI_LOG_E(TAG, "No known key for nested auth");
+        instance->state = Gen2PollerStateFail;
+    }
+
+    return command;
+}
+
+static bool gen2_poller_open_key_check_session(Gen2Poller* instance) {
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    bool is_open = (instance->auth_state == Gen2AuthStatePassed);
+
+    if(!is_open) {
+        uint8_t block_num =
+            mf_classic_get_sector_trailer_num_by_sector(key_check_ctx->known_sector);
+        MfClassicKey known_key = key_check_ctx->known_key;
+        MfClassicAuthContext auth_ctx = {};
+        is_open = (gen2_poller_auth(
+                       instance,
+                       block_num,
+                       &known_key,
+                       key_check_ctx->known_key_type,
+                       &auth_ctx) == Gen2PollerErrorNone);
+        key_check_ctx->session_nt =
+            bit_lib_bytes_to_num_be(auth_ctx.nt.data, sizeof(MfClassicNt));
+    }
+
+    return is_open;
+}
+
+// Finishes a nested auth with the key, a passed auth keeps the session for the next sector
+static bool
+    gen2_poller_auth_candidate(Gen2Poller* instance, const Gen2NestedNt* nested_nt, uint64_t key) {
+    MfClassicKey auth_key = {};
+    bit_lib_num_to_bytes_be(key, sizeof(MfClassicKey), auth_key.data);
+
+    bool is_passed =
+        (gen2_poller_auth_nested_nt(instance, nested_nt, &auth_key) == Gen2PollerErrorNone);
+    if(is_passed) {
+        instance->mode_ctx.key_check_ctx.session_nt =
+            crypto1_decrypt_nested_nt(key, nested_nt->cuid, nested_nt->nt_enc);
+    } else {
+        gen2_poller_halt(instance);
+    }
+
+    return is_passed;
+}
+
+// Offline checks leave rare false positives, so a candidate only counts once the card accepts it.
+// Every attempt opens a new session with the known key and asks for a new nested nt, a rejected
+// key leaves the card halted and the session of the previous attempt is gone by then.
+static bool gen2_poller_confirm_key(
+    Gen2Poller* instance,
+    const Gen2NestedNt* nested_nt,
+    uint64_t key,
+    bool is_waiting) {
+    bool is_confirmed = false;
+
+    // Only the first candidate can answer the nt the card is still waiting on
+    if(is_waiting) {
+        is_confirmed = gen2_poller_auth_candidate(instance, nested_nt, key);
+    }
+    if(!is_confirmed) {
+        uint8_t block_num = mf_classic_get_sector_trailer_num_by_sector(nested_nt->sector);
+        Gen2NestedNt attempt_nt = {};
+        gen2_poller_halt(instance);
+        if(gen2_poller_open_key_check_session(instance) &&
+           (gen2_poller_collect_nt_nested(instance, block_num, nested_nt->key_type, &attempt_nt) ==
+            Gen2PollerErrorNone)) {
+            is_confirmed = gen2_poller_auth_candidate(instance, &attempt_nt, key);
+        } else {
+            gen2_poller_halt(instance);
+        }
+    }
+
+    return is_confirmed;
+}
+
+// Runs the whole dictionary against a nonce in batches. Each candidate is confirmed on the card,
+// a rejected one only moves the scan on to the rest of its batch and the batches after it.
+static bool
+    gen2_poller_find_key(Gen2Poller* instance, const Gen2NestedNt* nested_nt, uint64_t* key) {
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    bool found = false;
+    bool is_waiting = true;
+    keys_dict_rewind(key_check_ctx->dict);
+
+    while(!found) {
+        uint64_t keys[CRYPTO1_BATCH_WIDTH];
+        size_t keys_num = 0;
+        MfClassicKey dict_key = {};
+        while((keys_num < CRYPTO1_BATCH_WIDTH) &&
+              keys_dict_get_next_key(key_check_ctx->dict, dict_key.data, sizeof(MfClassicKey))) {
+            keys[keys_num++] = bit_lib_bytes_to_num_be(dict_key.data, sizeof(MfClassicKey));
+        }
+        if(keys_num == 0) break;
+
+        Crypto1BatchLane candidates = crypto1_batch_check_nested_nt(
+            keys, keys_num, nested_nt->cuid, nested_nt->nt_enc, nested_nt->nt_enc_parity);
+        for(size_t i = 0; (i < keys_num) && !found; i++) {
+            if(!crypto1_batch_lane_get(candidates, i)) continue;
+            if(gen2_poller_confirm_key(instance, nested_nt, keys[i], is_waiting)) {
+                *key = keys[i];
+                found = true;
             } else {
-                FURI_LOG_D(TAG, "Resetting ACs for block %d", block_num);
-                // Generate a block with old keys and default ACs (0xFF, 0x07, 0x80)
-                MfClassicBlock block;
-                memset(&block, 0, sizeof(block));
-                memcpy(block.data, write_ctx->mfc_data_target->block[block_num].data, 16);
-                memcpy(block.data + 6, "\xFF\x07\x80", 3);
-
-                error = gen2_poller_write_block_handler(instance, block_num, &block);
-                if(error != Gen2PollerErrorNone) {
-                    FURI_LOG_E(TAG, "Failed to reset ACs for block %d", block_num);
-                    break;
-                } else {
-                    FURI_LOG_D(TAG, "ACs for block %d reset", block_num);
-                    memcpy(write_ctx->mfc_data_target->block[block_num].data, block.data, 16);
-                }
+                FURI_LOG_D(TAG, "Candidate rejected for sector %d", nested_nt->sector);
             }
+            is_waiting = false;
         }
+    }
 
-        // Figure out which key to use for writing
-        write_ctx->write_key =
-            gen2_poller_get_key_type_to_write(write_ctx->mfc_data_target, block_num);
+    return found;
+}
 
-        // Get the key to use for writing from the target data
-        MfClassicSectorTrailer* sec_tr = mf_classic_get_sector_trailer_by_sector(
-            write_ctx->mfc_data_target, mf_classic_get_sector_by_block(block_num));
-        if(write_ctx->write_key == MfClassicKeyTypeA) {
-            write_ctx->auth_key = sec_tr->key_a;
-        } else {
-            write_ctx->auth_key = sec_tr->key_b;
+// More nonces of a key the dictionary missed, each from a session of its own. Their nested auths
+// are never finished, so every one ends with a halt.
+static void gen2_poller_collect_recovery_nts(
+    Gen2Poller* instance,
+    uint8_t sector,
+    MfClassicKeyType key_type) {
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    uint8_t block_num = mf_classic_get_sector_trailer_num_by_sector(sector);
+
+    for(size_t i = 1; i < GEN2_POLLER_NESTED_NT_PER_KEY; i++) {
+        Gen2NestedNt* nested_nt = &key_check_ctx->nested_nt[key_check_ctx->nested_nt_num];
+        if(!gen2_poller_open_key_check_session(instance) ||
+           (gen2_poller_collect_nt_nested(instance, block_num, key_type, nested_nt) !=
+            Gen2PollerErrorNone)) {
+            FURI_LOG_D(TAG, "Failed to collect more nts for sector %d", sector);
+            gen2_poller_halt(instance);
+            break;
         }
+        nested_nt->sector = sector;
+        nested_nt->nt_prev = key_check_ctx->session_nt;
+        nested_nt->key_found = false;
+        key_check_ctx->nested_nt_num++;
+        gen2_poller_halt(instance);
+    }
+}
 
-        // Write the block
-        error = gen2_poller_write_block_handler(
-            instance, block_num, &write_ctx->mfc_data_source->block[block_num]);
-        if(error != Gen2PollerErrorNone) {
-            FURI_LOG_E(TAG, "Couldn't write block %d", block_num);
+// Nested auth for one missing key. The card waits for the reader nonce while the dictionary is
+// checked offline, so a matching key finishes the auth and keeps the session for the next one.
+static void
+    gen2_poller_check_key(Gen2Poller* instance, uint8_t sector, MfClassicKeyType key_type) {
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    Gen2NestedNt* nested_nt = &key_check_ctx->nested_nt[key_check_ctx->nested_nt_num];
+    uint8_t block_num = mf_classic_get_sector_trailer_num_by_sector(sector);
+
+    do {
+        if(!gen2_poller_open_key_check_session(instance)) {
+            FURI_LOG_D(TAG, "Failed to auth with the known key");
+            gen2_poller_halt(instance);
+            break;
+        }
+        if(gen2_poller_collect_nt_nested(instance, block_num, key_type, nested_nt) !=
+           Gen2PollerErrorNone) {
+            FURI_LOG_D(TAG, "Failed to collect nt for sector %d", sector);
+            gen2_poller_halt(instance);
+            break;
         }
+        nested_nt->sector = sector;
+        nested_nt->nt_prev = key_check_ctx->session_nt;
+        key_check_ctx->nested_nt_num++;
+
+        uint64_t key = 0;
+        if(!gen2_poller_find_key(instance, nested_nt, &key)) {
+            gen2_poller_halt(instance);
+            gen2_poller_collect_recovery_nts(instance, sector, key_type);
+            break;
+        }
+
+        FURI_LOG_I(TAG, "Found key %c for sector %d", 'A' + key_type, sector);
+        mf_classic_set_key_found(instance->mfc_data, sector, key_type, key);
+        nested_nt->key_found = true;
     } while(false);
-    write_ctx->current_block++;
+}
 
-    if(error != Gen2PollerErrorNone) {
-        FURI_LOG_D(TAG, "Error occurred: %d", error);
-    } else if(
-        write_ctx->current_block ==
-        mf_classic_get_total_block_num(write_ctx->mfc_data_source->type)) {
+NfcCommand gen2_poller_check_keys_handler(Gen2Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    Gen2PollerKeyCheckContext* key_check_ctx = &instance->mode_ctx.key_check_ctx;
+    uint8_t sector = key_check_ctx->current_sector;
+
+    if(!mf_classic_is_key_found(instance->mfc_data, sector, MfClassicKeyTypeA)) {
+        gen2_poller_check_key(instance, sector, MfClassicKeyTypeA);
+    }
+    if(!mf_classic_is_key_found(instance->mfc_data, sector, MfClassicKeyTypeB)) {
+        gen2_poller_check_key(instance, sector, MfClassicKeyTypeB);
+    }
+    key_check_ctx->current_sector++;
+
+    if(key_check_ctx->current_sector ==
+       mf_classic_get_total_sectors_num(instance->mfc_data->type)) {
+        gen2_poller_halt(instance);
         instance->state = Gen2PollerStateSuccess;
     }
 
@@ -486,6 +868,10 @@ NfcCommand gen2_poller_success_handler(Gen2Poller* instance) {
 
     instance->gen2_event.type = Gen2PollerEventTypeSuccess;
     command = instance->callback(instance->gen2_event, instance->context);
+    if(instance->mode != Gen2PollerModeCheckKeys) {
+        nfc_magic_resume_reset(&instance->mode_ctx.write_ctx.resume);
+    }
+    nfc_magic_retry_reset(&instance->retry);
     instance->state = Gen2PollerStateIdle;
 
     return command;
@@ -498,6 +884,10 @@ NfcCommand gen2_poller_fail_handler(Gen2Poller* instance) {
 
     instance->gen2_event.type = Gen2PollerEventTypeFail;
     command = instance->callback(instance->gen2_event, instance->context);
+    if(instance->mode != Gen2PollerModeCheckKeys) {
+        nfc_magic_resume_reset(&instance->mode_ctx.write_ctx.resume);
+    }
+    nfc_magic_retry_reset(&instance->retry);
     instance->state = Gen2PollerStateIdle;
 
     return command;
@@ -510,6 +900,9 @@ static const Gen2PollerStateHandler gen2_poller_state_handlers[Gen2PollerStateNu
     [Gen2PollerStateWriteSourceDataRequest] = gen2_poller_write_source_data_request_handler,
     [Gen2PollerStateWriteTargetDataRequest] = gen2_poller_write_target_data_request_handler,
     [Gen2PollerStateWrite] = gen2_poller_write_handler,
+    [Gen2PollerStateWriteResume] = gen2_poller_write_resume_handler,
+    [Gen2PollerStateKeyCheckDataRequest] = gen2_poller_key_check_data_request_handler,
+    [Gen2PollerStateCheckKeys] = gen2_poller_check_keys_handler,
     [Gen2PollerStateSuccess] = gen2_poller_success_handler,
     [Gen2PollerStateFail] = gen2_poller_fail_handler,
 };
@@ -526,7 +919,13 @@ NfcCommand gen2_poller_callback(NfcGenericEvent event, void* context) {
     Iso14443_3aPollerEvent* iso3_event = event.event_data;
 
     if(iso3_event->type == Iso14443_3aPollerEventTypeReady) {
-        command = gen2_poller_state_handlers[instance->state](instance);
+        if(nfc_magic_retry_backoff(&instance->retry)) {
+            // Keep the card powered down, it is activated again after the reset
+            iso14443_3a_poller_halt(instance->iso3_poller);
+            command = NfcCommandReset;
+        } else {
+            command = gen2_poller_state_handlers[instance->state](instance);
+        }
     }
 
     return command;
@@ -558,16 +957,10 @@ Gen2PollerWriteProblems gen2_poller_check_target_problems(NfcDevice* target_dev)
     const MfClassicData* mfc_data = nfc_device_get_data(target_dev, NfcProtocolMfClassic);
 
     if(mfc_data) {
-        uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
-        for(uint16_t i = 0; i < total_block_num; i++) {
-            if(mf_classic_is_sector_trailer(i)) {
-                problems.all_problems |=
-                    gen2_poller_can_write_sector_trailer(mfc_data, i).all_problems;
-            } else {
-                problems.all_problems |=
-                    gen2_poller_can_write_data_block(mfc_data, i).all_problems;
-            }
-        }
+        Gen2WritePlan* plan = malloc(sizeof(Gen2WritePlan));
+        gen2_write_plan_compile(plan, NULL, mfc_data);
+        problems = plan->problems;
+        free(plan);
     } else {
         problems.no_data = true;
     }
@@ -575,20 +968,51 @@ Gen2PollerWriteProblems gen2_poller_check_target_problems(NfcDevice* target_dev)
     return problems;
 }
 
-Gen2PollerWriteProblems gen2_poller_check_source_problems(NfcDevice* source_dev) {
-    furi_assert(source_dev);
+Gen2PollerWriteProblems gen2_poller_check_source_problems(NfcMagicBlockSource* source) {
+    furi_assert(source);
 
     Gen2PollerWriteProblems problems = {0};
-    const MfClassicData* mfc_data = nfc_device_get_data(source_dev, NfcProtocolMfClassic);
 
-    if(mfc_data) {
-        uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
+    if(nfc_magic_block_source_get_protocol(source) == NfcProtocolMfClassic) {
+        uint16_t total_block_num =
+            mf_classic_get_total_block_num(nfc_magic_block_source_get_type(source));
         for(uint16_t i = 0; i < total_block_num; i++) {
-            if(!mf_classic_is_block_read(mfc_data, i)) {
+            if(!nfc_magic_block_source_is_block_read(source, i)) {
                 problems.missing_source_data = true;
+                break;
             }
         }
+    } else {
+        problems.missing_source_data = true;
     }
 
     return problems;
 }
+
+bool gen2_poller_is_key_check_possible(const MfClassicData* mfc_data) {
+    furi_assert(mfc_data);
+
+    uint8_t sectors_read = 0;
+    uint8_t keys_found = 0;
+    mf_classic_get_read_sectors_and_keys(mfc_data, &sectors_read, &keys_found);
+    uint8_t keys_total = mf_classic_get_total_sectors_num(mfc_data->type) * 2;
+
+    // Nested auth needs one known key to start from
+    return (keys_found > 0) && (keys_found < keys_total);
+}
+
+const MfClassicData* gen2_poller_get_data(Gen2Poller* instance) {
+    furi_assert(instance);
+
+    return instance->mfc_data;
+}
+
+size_t gen2_poller_get_nested_nts(Gen2Poller* instance, const Gen2NestedNt** nested_nts) {
+    furi_assert(instance);
+    furi_assert(instance->mode == Gen2PollerModeCheckKeys);
+    furi_assert(nested_nts);
+
+    *nested_nts = instance->mode_ctx.key_check_ctx.nested_nt;
+
+    return instance->mode_ctx.key_check_ctx.nested_nt_num;
+}
@@ -6,6 +6,10 @@
 #include <nfc/protocols/iso14443_3a/iso14443_3a.h>
 #include <nfc/protocols/iso14443_3a/iso14443_3a_poller.h>
 #include <nfc/nfc_device.h>
+#include <toolbox/keys_dict.h>
+#include "../nfc_magic_detect.h"
+#include "../nfc_magic_retry.h"
+#include "../../nfc_magic_block_source.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,6 +22,8 @@ typedef enum {
     Gen2PollerErrorAuth,
     Gen2PollerErrorTimeout,
     Gen2PollerErrorAccess,
+    // Frame arrived damaged, CRC or parity did not check out
+    Gen2PollerErrorCommunication,
 } Gen2PollerError;
 
 // Possible write problems, sorted by priority top to bottom
@@ -41,6 +47,10 @@ typedef enum {
     Gen2PollerEventTypeRequestMode,
     Gen2PollerEventTypeRequestDataToWrite,
     Gen2PollerEventTypeRequestTargetData,
+    Gen2PollerEventTypeRequestKeys,
+    Gen2PollerEventTypeCardLost,
+    Gen2PollerEventTypeResumed,
+    Gen2PollerEventTypeRetry,
 
     Gen2PollerEventTypeSuccess,
     Gen2PollerEventTypeFail,
@@ -49,6 +59,7 @@ typedef enum {
 typedef enum {
     Gen2PollerModeWipe,
     Gen2PollerModeWrite,
+    Gen2PollerModeCheckKeys,
 } Gen2PollerMode;
 
 typedef struct {
@@ -56,17 +67,35 @@ typedef struct {
 } Gen2PollerEventDataRequestMode;
 
 typedef struct {
-    const MfClassicData* mfc_data;
+    // Blocks are pulled from the file one sector at a time during the write
+    NfcMagicBlockSource* block_source;
 } Gen2PollerEventDataRequestDataToWrite;
 
 typedef struct {
     const MfClassicData* mfc_data;
 } Gen2PollerEventDataRequestTargetData;
 
+typedef struct {
+    const MfClassicData* mfc_data;
+    KeysDict* dict;
+} Gen2PollerEventDataRequestKeys;
+
+typedef struct {
+    uint16_t block;
+} Gen2PollerEventDataResumed;
+
+typedef struct {
+    uint16_t block;
+    NfcMagicRetryStats stats;
+} Gen2PollerEventDataRetry;
+
 typedef union {
     Gen2PollerEventDataRequestMode poller_mode;
     Gen2PollerEventDataRequestDataToWrite data_to_write;
     Gen2PollerEventDataRequestTargetData target_data;
+    Gen2PollerEventDataRequestKeys request_keys;
+    Gen2PollerEventDataResumed resumed;
+    Gen2PollerEventDataRetry retry;
 } Gen2PollerEventData;
 
 typedef struct {
@@ -76,21 +105,42 @@ typedef struct {
 
 typedef NfcCommand (*Gen2PollerCallback)(Gen2PollerEvent event, void* context);
 
+typedef struct {
+    uint8_t sector;
+    MfClassicKeyType key_type;
+    uint32_t cuid;
+    // Plain nt of the known key auth the nested auth was sent from
+    uint32_t nt_prev;
+    uint32_t nt_enc;
+    uint8_t nt_enc_parity;
+    bool key_found;
+} Gen2NestedNt;
+
 typedef struct Gen2Poller Gen2Poller;
 
-Gen2PollerError gen2_poller_detect(Nfc* nfc);
+Gen2PollerError gen2_poller_detect(NfcMagicDetectContext* magic_detect_ctx);
 
 Gen2Poller* gen2_poller_alloc(Nfc* nfc);
 
 void gen2_poller_free(Gen2Poller* instance);
 
+// Replaces the built-in retry budget, the policy must outlive the poller
+void gen2_poller_set_retry_policy(Gen2Poller* instance, const NfcMagicRetryPolicy* policy);
+
 void gen2_poller_start(Gen2Poller* instance, Gen2PollerCallback callback, void* context);
 
 void gen2_poller_stop(Gen2Poller* instance);
 
 Gen2PollerWriteProblems gen2_poller_check_target_problems(NfcDevice* target_dev);
 
-Gen2PollerWriteProblems gen2_poller_check_source_problems(NfcDevice* source_dev);
+// Streams through the whole source once
+Gen2PollerWriteProblems gen2_poller_check_source_problems(NfcMagicBlockSource* source);
+
+bool gen2_poller_is_key_check_possible(const MfClassicData* mfc_data);
+
+const MfClassicData* gen2_poller_get_data(Gen2Poller* instance);
+
+size_t gen2_poller_get_nested_nts(Gen2Poller* instance, const Gen2NestedNt** nested_nts);
 
 #ifdef __cplusplus
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gen2_poller.h"
+#include "gen2_write_plan.h"
+#include "gen2_access.h"
+#include "../nfc_magic_resume.h"
 #include <nfc/protocols/nfc_generic_event.h>
 #include "crypto1.h" // TODO: Move to a better home
 #include <nfc/protocols/iso14443_3a/iso14443_3a_poller.h>
@@ -17,6 +20,9 @@ extern "C" {
 #define GEN2_POLLER_MAX_BUFFER_SIZE (64U)
 #define GEN2_POLLER_MAX_FWT (150000U)
 
+// Nonces kept per key the dictionary misses, gen2_recover skips a key with fewer than two
+#define GEN2_POLLER_NESTED_NT_PER_KEY (3U)
+
 typedef enum {
     Gen2PollerStateIdle,
     Gen2PollerStateRequestMode,
@@ -24,6 +30,9 @@ typedef enum {
     Gen2PollerStateWriteSourceDataRequest,
     Gen2PollerStateWriteTargetDataRequest,
     Gen2PollerStateWrite,
+    Gen2PollerStateWriteResume,
+    Gen2PollerStateKeyCheckDataRequest,
+    Gen2PollerStateCheckKeys,
     Gen2PollerStateSuccess,
     Gen2PollerStateFail,
 
@@ -41,17 +50,41 @@ typedef enum {
 } Gen2CardState;
 
 typedef struct {
-    MfClassicData* mfc_data_source;
-    MfClassicData* mfc_data_target;
+    // Borrowed from the caller, must outlive the write session
+    NfcMagicBlockSource* block_source;
+    const MfClassicData* mfc_data_target;
+    // Sectors whose ACs were reset to default during this session
+    uint8_t access_reset[(MF_CLASSIC_TOTAL_SECTORS_MAX + 7) / 8];
+    // Sectors whose AC reset failed, the blocks planned after it can't be written
+    uint8_t access_reset_failed[(MF_CLASSIC_TOTAL_SECTORS_MAX + 7) / 8];
+    Gen2WritePlan plan;
     MfClassicKey auth_key;
     MfClassicKeyType read_key;
     MfClassicKeyType write_key;
     uint16_t current_block;
     bool need_halt_before_write;
+    NfcMagicResume resume;
+    // Current block was already lost once, a second failure skips it
+    bool is_retry;
 } Gen2PollerWriteContext;
 
+typedef struct {
+    KeysDict* dict;
+    uint8_t known_sector;
+    MfClassicKey known_key;
+    MfClassicKeyType known_key_type;
+    // Plain nt of the auth that opened the current session
+    uint32_t session_nt;
+    // Encrypted nonces of the missing keys. The first one of a key is checked against the
+    // dictionary offline, the rest are only collected when the dictionary has no match.
+    Gen2NestedNt nested_nt[MF_CLASSIC_TOTAL_SECTORS_MAX * 2 * GEN2_POLLER_NESTED_NT_PER_KEY];
+    uint16_t nested_nt_num;
+    uint8_t current_sector;
+} Gen2PollerKeyCheckContext;
+
 typedef union {
     Gen2PollerWriteContext write_ctx;
+    Gen2PollerKeyCheckContext key_check_ctx;
 } Gen2PollerModeContext;
 
 struct Gen2Poller {
@@ -66,13 +99,16 @@ struct Gen2Poller {
 
     Gen2PollerModeContext mode_ctx;
     Gen2PollerMode mode;
+    NfcMagicRetry retry;
 
     Crypto1* crypto;
     BitBuffer* tx_plain_buffer;
     BitBuffer* tx_encrypted_buffer;
     BitBuffer* rx_plain_buffer;
     BitBuffer* rx_encrypted_buffer;
-    MfClassicData* data;
+    Iso14443_3aData* iso3_data;
+    // Key check result, allocated on first use
+    MfClassicData* mfc_data;
 
     Gen2PollerEvent gen2_event;
     Gen2PollerEventData gen2_event_data;
@@ -110,24 +146,22 @@ Gen2PollerError gen2_poller_auth(
     MfClassicKeyType key_type,
     MfClassicAuthContext* data);
 
+Gen2PollerError gen2_poller_collect_nt_nested(
+    Gen2Poller* instance,
+    uint8_t block_num,
+    MfClassicKeyType key_type,
+    Gen2NestedNt* nested_nt);
+
+Gen2PollerError gen2_poller_auth_nested_nt(
+    Gen2Poller* instance,
+    const Gen2NestedNt* nested_nt,
+    MfClassicKey* key);
+
 Gen2PollerError gen2_poller_halt(Gen2Poller* instance);
 
 Gen2PollerError
     gen2_poller_write_block(Gen2Poller* instance, uint8_t block_num, const MfClassicBlock* data);
 
-MfClassicKeyType
-    gen2_poller_get_key_type_to_write(const MfClassicData* mfc_data, uint8_t block_num);
-
-bool gen2_poller_can_write_block(const MfClassicData* mfc_data, uint8_t block_num);
-
-bool gen2_can_reset_access_conditions(const MfClassicData* mfc_data, uint8_t block_num);
-
-Gen2PollerWriteProblems
-    gen2_poller_can_write_data_block(const MfClassicData* mfc_data, uint8_t block_num);
-
-Gen2PollerWriteProblems
-    gen2_poller_can_write_sector_trailer(const MfClassicData* mfc_data, uint8_t block_num);
-
 bool gen2_is_allowed_access(
     const MfClassicData* data,
     uint8_t block_num,
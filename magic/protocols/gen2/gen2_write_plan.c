@@ -0,0 +1,156 @@
+#include "gen2_write_plan.h"
+#include "gen2_poller_i.h"
+
+#include <furi/furi.h>
+
+#define TAG "GEN2"
+
+static bool gen2_write_plan_find_key(
+    const MfClassicData* target,
+    uint8_t block_num,
+    MfClassicAction action,
+    MfClassicKeyType* key_type) {
+    uint8_t sector_num = mf_classic_get_sector_by_block(block_num);
+    bool found = false;
+
+    for(MfClassicKeyType key = MfClassicKeyTypeA; key <= MfClassicKeyTypeB; key++) {
+        if(mf_classic_is_key_found(target, sector_num, key) &&
+           gen2_is_allowed_access(target, block_num, key, action)) {
+            *key_type = key;
+            found = true;
+            break;
+        }
+    }
+
+    return found;
+}
+
+static bool gen2_write_plan_find_trailer_key(
+    const MfClassicData* target,
+    uint8_t block_num,
+    MfClassicKeyType* key_type) {
+    uint8_t sector_num = mf_classic_get_sector_by_block(block_num);
+    bool found = false;
+
+    // The whole trailer is written at once, so one key must be allowed to write all of it
+    for(MfClassicKeyType key = MfClassicKeyTypeA; key <= MfClassicKeyTypeB; key++) {
+        if(mf_classic_is_key_found(target, sector_num, key) &&
+           gen2_is_allowed_access(target, block_num, key, MfClassicActionKeyAWrite) &&
+           gen2_is_allowed_access(target, block_num, key, MfClassicActionACWrite) &&
+           gen2_is_allowed_access(target, block_num, key, MfClassicActionKeyBWrite)) {
+            *key_type = key;
+            found = true;
+            break;
+        }
+    }
+
+    return found;
+}
+
+// With default ACs (FF 07 80) data blocks take either key, the trailer only key A
+static bool gen2_write_plan_find_default_access_key(
+    const MfClassicData* target,
+    uint8_t block_num,
+    MfClassicKeyType* key_type) {
+    uint8_t sector_num = mf_classic_get_sector_by_block(block_num);
+    bool found = false;
+
+    if(mf_classic_is_key_found(target, sector_num, MfClassicKeyTypeA)) {
+        *key_type = MfClassicKeyTypeA;
+        found = true;
+    } else if(
+        !mf_classic_is_sector_trailer(block_num) &&
+        mf_classic_is_key_found(target, sector_num, MfClassicKeyTypeB)) {
+        *key_type = MfClassicKeyTypeB;
+        found = true;
+    }
+
+    return found;
+}
+
+void gen2_write_plan_compile(
+    Gen2WritePlan* plan,
+    NfcMagicBlockSource* source,
+    const MfClassicData* target) {
+    furi_assert(plan);
+    furi_assert(target);
+
+    memset(plan, 0, sizeof(Gen2WritePlan));
+    plan->blocks_total = mf_classic_get_total_block_num(target->type);
+
+    uint8_t current_sector = 0;
+    bool sector_access_reset = false;
+
+    for(uint16_t i = 0; i < plan->blocks_total; i++) {
+        uint8_t block_num = i;
+        Gen2WritePlanStep* step = &plan->steps[block_num];
+        uint8_t sector_num = mf_classic_get_sector_by_block(block_num);
+        uint8_t sector_tr_num = mf_classic_get_sector_trailer_num_by_block(block_num);
+        bool is_trailer = mf_classic_is_sector_trailer(block_num);
+        MfClassicKeyType key_type = MfClassicKeyTypeA;
+
+        if(sector_num != current_sector) {
+            current_sector = sector_num;
+            sector_access_reset = false;
+        }
+
+        step->action = Gen2WritePlanActionImpossible;
+
+        do {
+            if(source && !nfc_magic_block_source_is_block_read(source, block_num)) {
+                step->action = Gen2WritePlanActionSkip;
+                plan->problems.missing_source_data = true;
+                break;
+            }
+
+            if(block_num == 0 && target->iso14443_3a_data->uid_len == 7) {
+                // 7-byte UID gen2 cards are not supported yet, need further testing
+                plan->problems.uid_locked = true;
+                break;
+            }
+
+            if(!mf_classic_is_block_read(target, sector_tr_num) ||
+               (!mf_classic_is_key_found(target, sector_num, MfClassicKeyTypeA) &&
+                !mf_classic_is_key_found(target, sector_num, MfClassicKeyTypeB))) {
+                plan->problems.missing_target_keys = true;
+                break;
+            }
+
+            if(sector_access_reset) {
+                if(gen2_write_plan_find_default_access_key(target, block_num, &key_type)) {
+                    step->action = Gen2WritePlanActionWrite;
+                    step->write_key = key_type;
+                } else {
+                    plan->problems.missing_target_keys = true;
+                }
+                break;
+            }
+
+            bool can_write =
+                is_trailer ?
+                    gen2_write_plan_find_trailer_key(target, block_num, &key_type) :
+                    gen2_write_plan_find_key(
+                        target, block_num, MfClassicActionDataWrite, &key_type);
+            if(can_write) {
+                step->action = Gen2WritePlanActionWrite;
+                step->write_key = key_type;
+                break;
+            }
+
+            // Check whether ACs can be reset to default to allow writing
+            MfClassicKeyType reset_key = MfClassicKeyTypeA;
+            if(gen2_write_plan_find_key(
+                   target, sector_tr_num, MfClassicActionACWrite, &reset_key) &&
+               gen2_write_plan_find_default_access_key(target, block_num, &key_type)) {
+                step->action = Gen2WritePlanActionResetAccessAndWrite;
+                step->reset_key = reset_key;
+                step->write_key = key_type;
+                sector_access_reset = true;
+            } else {
+                plan->problems.locked_access_bits = true;
+            }
+        } while(false);
+
+        FURI_LOG_T(TAG, "Plan block %d: action %d", block_num, step->action);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "gen2_poller.h"
+#include "../../nfc_magic_block_source.h"
+#include <nfc/protocols/mf_classic/mf_classic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    Gen2WritePlanActionSkip, // Nothing to write for this block
+    Gen2WritePlanActionWrite, // Write with write_key
+    Gen2WritePlanActionResetAccessAndWrite, // Reset sector ACs with reset_key, then write
+    Gen2WritePlanActionImpossible, // Block can't be written with the known keys and ACs
+} Gen2WritePlanAction;
+
+typedef struct {
+    uint8_t action : 2; // Gen2WritePlanAction
+    uint8_t write_key : 1; // MfClassicKeyType
+    uint8_t reset_key : 1; // MfClassicKeyType
+} Gen2WritePlanStep;
+
+typedef struct {
+    uint16_t blocks_total;
+    Gen2PollerWriteProblems problems;
+    Gen2WritePlanStep steps[MF_CLASSIC_TOTAL_BLOCKS_MAX];
+} Gen2WritePlan;
+
+/**
+ * @brief Decide, once per session, how every block of the target is going to be written.
+ *
+ * @param[out] plan Plan to fill.
+ * @param source Image to write, or NULL when wiping. Read through once, in block order.
+ * @param target Keys and access conditions of the target card.
+ */
+void gen2_write_plan_compile(
+    Gen2WritePlan* plan,
+    NfcMagicBlockSource* source,
+    const MfClassicData* target);
+
+#ifdef __cplusplus
+}
+#endif
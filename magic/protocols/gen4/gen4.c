@@ -18,6 +18,7 @@ void gen4_reset(Gen4* instance) {
 
     memset(&instance->config, 0, sizeof(Gen4Config));
     memset(&instance->revision, 0, sizeof(Gen4Revision));
+    instance->uid_len = 0;
 }
 
 void gen4_copy(Gen4* dest, const Gen4* source) {
@@ -27,6 +28,46 @@ void gen4_copy(Gen4* dest, const Gen4* source) {
     memcpy(dest, source, sizeof(Gen4));
 }
 
+void gen4_set_uid(Gen4* instance, const uint8_t* uid, size_t uid_len) {
+    furi_check(instance);
+    furi_check(uid);
+    furi_check(uid_len <= GEN4_UID_MAX_LEN);
+
+    memcpy(instance->uid, uid, uid_len);
+    instance->uid_len = uid_len;
+}
+
+bool gen4_is_uid_equal(const Gen4* instance, const uint8_t* uid, size_t uid_len) {
+    furi_check(instance);
+    furi_check(uid);
+
+    return (instance->uid_len != 0) && (instance->uid_len == uid_len) &&
+           (memcmp(instance->uid, uid, uid_len) == 0);
+}
+
+void gen4_config_patch_apply(const Gen4ConfigPatch* patch, Gen4Config* config) {
+    furi_check(patch);
+    furi_check(config);
+
+    const uint32_t fields = patch->fields;
+    if(fields & Gen4ConfigFieldShadowMode) {
+        config->data_parsed.gtu_mode = patch->values.data_parsed.gtu_mode;
+    }
+    if(fields & Gen4ConfigFieldDirectWriteMode) {
+        config->data_parsed.direct_write_mode = patch->values.data_parsed.direct_write_mode;
+    }
+    if(fields & Gen4ConfigFieldAts) {
+        config->data_parsed.ats_len = patch->values.data_parsed.ats_len;
+        memcpy(config->data_parsed.ats, patch->values.data_parsed.ats, GEN4_ATS_MAX_LEN);
+    }
+    if(fields & Gen4ConfigFieldAtqa) {
+        memcpy(config->data_parsed.atqa, patch->values.data_parsed.atqa, GEN4_ATQA_LEN);
+    }
+    if(fields & Gen4ConfigFieldSak) {
+        config->data_parsed.sak = patch->values.data_parsed.sak;
+    }
+}
+
 bool gen4_password_is_set(const Gen4Password* instance) {
     furi_check(instance);
 
@@ -46,6 +87,43 @@ void gen4_password_copy(Gen4Password* dest, const Gen4Password* source) {
     memcpy(dest->bytes, source->bytes, GEN4_PASSWORD_LEN);
 }
 
+void gen4_password_list_reset(Gen4PasswordList* instance) {
+    furi_check(instance);
+
+    memset(instance, 0, sizeof(Gen4PasswordList));
+}
+
+bool gen4_password_list_add(Gen4PasswordList* instance, const Gen4Password* password) {
+    furi_check(instance);
+    furi_check(password);
+
+    bool is_listed = false;
+    for(size_t i = 0; i < instance->count; i++) {
+        if(memcmp(instance->passwords[i].bytes, password->bytes, GEN4_PASSWORD_LEN) == 0) {
+            is_listed = true;
+            break;
+        }
+    }
+    if(!is_listed && (instance->count < GEN4_PASSWORD_LIST_MAX)) {
+        gen4_password_copy(&instance->passwords[instance->count], password);
+        instance->count++;
+        is_listed = true;
+    }
+
+    return is_listed;
+}
+
+bool gen4_mfu_frame_proves_packing(const uint8_t* before, const uint8_t* data) {
+    furi_check(before);
+    furi_check(data);
+
+    // The first page is stored by every firmware, it says nothing either way
+    return memcmp(
+               &before[GEN4_MFU_PAGE_SIZE],
+               &data[GEN4_MFU_PAGE_SIZE],
+               GEN4_BLOCK_SIZE - GEN4_MFU_PAGE_SIZE) != 0;
+}
+
 const char* gen4_get_shadow_mode_name(Gen4ShadowMode mode) {
     switch(mode) {
     case Gen4ShadowModePreWrite:
@@ -10,6 +10,11 @@
 #define GEN4_ATS_MAX_LEN (16)
 #define GEN4_ATQA_LEN (2)
 #define GEN4_CRC_LEN (2)
+#define GEN4_UID_MAX_LEN (10)
+#define GEN4_PASSWORD_LIST_MAX (8)
+
+#define GEN4_BLOCK_SIZE (16)
+#define GEN4_MFU_PAGE_SIZE (4)
 
 typedef enum {
     Gen4ProtocolMfClassic = 0x00,
@@ -20,6 +25,12 @@ typedef struct {
     uint8_t bytes[GEN4_PASSWORD_LEN];
 } Gen4Password;
 
+// Passwords tried in turn when detecting a card, first match wins
+typedef struct {
+    Gen4Password passwords[GEN4_PASSWORD_LIST_MAX];
+    uint8_t count;
+} Gen4PasswordList;
+
 typedef enum {
     Gen4UIDLengthSingle = 0x00,
     Gen4UIDLengthDouble = 0x01,
@@ -77,9 +88,26 @@ typedef struct {
     uint8_t data[GEN4_REVISION_SIZE];
 } Gen4Revision;
 
+typedef enum {
+    Gen4ConfigFieldShadowMode = (1U << 0),
+    Gen4ConfigFieldDirectWriteMode = (1U << 1),
+    Gen4ConfigFieldAts = (1U << 2),
+    Gen4ConfigFieldAtqa = (1U << 3),
+    Gen4ConfigFieldSak = (1U << 4),
+} Gen4ConfigField;
+
+typedef struct {
+    // Gen4ConfigField mask of the fields taken from values
+    uint32_t fields;
+    Gen4Config values;
+} Gen4ConfigPatch;
+
 typedef struct {
     Gen4Config config;
     Gen4Revision revision;
+    // Card the config belongs to, uid_len is 0 when unknown
+    uint8_t uid[GEN4_UID_MAX_LEN];
+    uint8_t uid_len;
 } Gen4;
 
 Gen4* gen4_alloc();
@@ -90,12 +118,27 @@ void gen4_reset(Gen4* instance);
 
 void gen4_copy(Gen4* dest, const Gen4* source);
 
+void gen4_set_uid(Gen4* instance, const uint8_t* uid, size_t uid_len);
+
+bool gen4_is_uid_equal(const Gen4* instance, const uint8_t* uid, size_t uid_len);
+
+void gen4_config_patch_apply(const Gen4ConfigPatch* patch, Gen4Config* config);
+
 bool gen4_password_is_set(const Gen4Password* instance);
 
 void gen4_password_reset(Gen4Password* instance);
 
 void gen4_password_copy(Gen4Password* dest, const Gen4Password* source);
 
+void gen4_password_list_reset(Gen4PasswordList* instance);
+
+// Duplicates are skipped, returns false only when the list is full
+bool gen4_password_list_add(Gen4PasswordList* instance, const Gen4Password* password);
+
+// A packed Ultralight write of data only proves the card kept the whole frame if the pages
+// after the first one held something else before, before is the frame read ahead of the write
+bool gen4_mfu_frame_proves_packing(const uint8_t* before, const uint8_t* data);
+
 const char* gen4_get_shadow_mode_name(Gen4ShadowMode mode);
 
 const char* gen4_get_direct_write_mode_name(Gen4DirectWriteBlock0Mode mode);
@@ -0,0 +1,53 @@
+#include "gen4_password_list.h"
+
+#include <flipper_format/flipper_format.h>
+
+#define TAG "Gen4PasswordList"
+
+#define GEN4_PASSWORD_LIST_FILE_TYPE "Flipper NFC Magic Gen4 passwords"
+#define GEN4_PASSWORD_LIST_FILE_VERSION (1)
+
+#define GEN4_PASSWORD_LIST_KEY_PASSWORD "Password"
+
+bool gen4_password_list_load(Gen4PasswordList* instance, Storage* storage, const char* path) {
+    furi_check(instance);
+    furi_check(storage);
+    furi_check(path);
+
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    Gen4PasswordList loaded_list = *instance;
+    bool loaded = false;
+
+    do {
+        if(!storage_file_exists(storage, path)) break;
+        if(!flipper_format_file_open_existing(ff, path)) break;
+
+        uint32_t version = 0;
+        if(!flipper_format_read_header(ff, temp_str, &version)) break;
+        if(furi_string_cmp_str(temp_str, GEN4_PASSWORD_LIST_FILE_TYPE) != 0) break;
+        if(version != GEN4_PASSWORD_LIST_FILE_VERSION) break;
+
+        // Every read continues from the previous key, so repeated keys come in file order
+        const char* key = GEN4_PASSWORD_LIST_KEY_PASSWORD;
+        Gen4Password password = {};
+        while(flipper_format_read_hex(ff, key, password.bytes, GEN4_PASSWORD_LEN)) {
+            if(!gen4_password_list_add(&loaded_list, &password)) {
+                FURI_LOG_W(TAG, "Only %d passwords are kept", GEN4_PASSWORD_LIST_MAX);
+                break;
+            }
+        }
+
+        *instance = loaded_list;
+        loaded = true;
+    } while(false);
+
+    if(!loaded) {
+        FURI_LOG_D(TAG, "No passwords loaded from %s", path);
+    }
+
+    furi_string_free(temp_str);
+    flipper_format_free(ff);
+
+    return loaded;
+}
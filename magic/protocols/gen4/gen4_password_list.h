@@ -0,0 +1,30 @@
+#pragma once
+
+#include "gen4.h"
+#include <furi.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Known GTU passwords tried on every card during detection, in file order.
+//
+// Filetype: Flipper NFC Magic Gen4 passwords
+// Version: 1
+// Password: 00 00 00 00
+// Password: 12 34 56 78
+
+/**
+ * @brief Append the passwords from a file to a list.
+ *
+ * Passwords past GEN4_PASSWORD_LIST_MAX are dropped. The list is left as it
+ * was when the file is missing or malformed.
+ *
+ * @return true if the file was read.
+ */
+bool gen4_password_list_load(Gen4PasswordList* instance, Storage* storage, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,12 +12,30 @@
 #define GEN4_POLLER_THREAD_FLAG_DETECTED (1U << 0)
 #define GEN4_POLLER_DEFAULT_CONFIG_SIZE (28)
 
+#define GEN4_POLLER_MFU_META_PAGE_FIRST (0xE5)
+#define GEN4_POLLER_MFU_META_PAGES (0xFC - GEN4_POLLER_MFU_META_PAGE_FIRST)
+// Room for a full 16 byte frame starting at the last metadata page
+#define GEN4_POLLER_MFU_META_BUFFER_SIZE                                  \
+    ((GEN4_POLLER_MFU_META_PAGES + GEN4_POLLER_MFU_PAGES_PER_BLOCK - 1) * \
+     GEN4_POLLER_MFU_PAGE_SIZE)
+
 typedef NfcCommand (*Gen4PollerStateHandler)(Gen4Poller* instance);
 
+// Blocks go out back to back in one session, a retry is the only re-select a block gets.
+// More attempts and a longer backoff give a card that slipped off center time to settle.
+static const NfcMagicRetryPolicy gen4_poller_retry_policy = {
+    .block_retries = 4,
+    .backoff_resets_min = 1,
+    .backoff_resets_max = 8,
+};
+
 typedef struct {
     NfcPoller* poller;
-    Gen4Password password;
+    const Gen4PasswordList* passwords;
+    // Index of the password the card answered to
+    size_t password_index;
     Gen4 gen4_data;
+    NfcMagicFingerprint* fingerprint;
     BitBuffer* tx_buffer;
     BitBuffer* rx_buffer;
     FuriThreadId thread_id;
@@ -61,6 +79,8 @@ Gen4Poller* gen4_poller_alloc(Nfc* nfc) {
     instance->rx_buffer = bit_buffer_alloc(GEN4_POLLER_MAX_BUFFER_SIZE);
 
     instance->gen4_data = gen4_alloc();
+    nfc_magic_resume_reset(&instance->resume);
+    nfc_magic_retry_init(&instance->retry, &gen4_poller_retry_policy);
 
     return instance;
 }
@@ -84,6 +104,67 @@ void gen4_poller_set_password(Gen4Poller* instance, Gen4Password password) {
     instance->password = password;
 }
 
+void gen4_poller_set_config_cache(Gen4Poller* instance, Gen4* cache) {
+    furi_assert(instance);
+
+    instance->config_cache = cache;
+}
+
+void gen4_poller_set_fingerprint(Gen4Poller* instance, const NfcMagicFingerprint* fingerprint) {
+    furi_assert(instance);
+
+    instance->fingerprint = fingerprint;
+}
+
+void gen4_poller_set_retry_policy(Gen4Poller* instance, const NfcMagicRetryPolicy* policy) {
+    furi_assert(instance);
+    furi_assert(policy);
+
+    nfc_magic_retry_init(&instance->retry, policy);
+}
+
+static void gen4_poller_update_config_cache(Gen4Poller* instance, const Gen4Config* config) {
+    if(instance->config_cache == NULL) return;
+
+    const Iso14443_3aData* iso3_data = nfc_poller_get_data(instance->poller);
+    memcpy(instance->config_cache->config.data_raw, config->data_raw, GEN4_CONFIG_SIZE);
+    gen4_set_uid(instance->config_cache, iso3_data->uid, iso3_data->uid_len);
+    instance->config_cache_valid = true;
+}
+
+static Gen4PollerError gen4_poller_load_config(Gen4Poller* instance, Gen4Config* config) {
+    Gen4PollerError error = Gen4PollerErrorNone;
+
+    if(instance->config_cache_valid) {
+        memcpy(config->data_raw, instance->config_cache->config.data_raw, GEN4_CONFIG_SIZE);
+    } else {
+        error = gen4_poller_get_config(instance, instance->password, config);
+        if(error == Gen4PollerErrorNone) {
+            gen4_poller_update_config_cache(instance, config);
+        }
+    }
+
+    return error;
+}
+
+// How a card reacts to a wrong password is not pinned down, it may stay silent until the next
+// select. Halt and select it again so every password starts from the same state.
+static bool gen4_poller_detect_reselect(
+    Gen4PollerDetectContext* gen4_poller_detect_ctx,
+    Iso14443_3aPoller* iso3_poller) {
+    iso14443_3a_poller_halt(iso3_poller);
+
+    Iso14443_3aData iso3_data = {};
+    if(iso14443_3a_poller_activate(iso3_poller, &iso3_data) != Iso14443_3aErrorNone) {
+        return false;
+    }
+
+    // Another card in the field must not be probed with the rest of the list
+    const Iso14443_3aData* detected = nfc_poller_get_data(gen4_poller_detect_ctx->poller);
+    return (iso3_data.uid_len == detected->uid_len) &&
+           (memcmp(iso3_data.uid, detected->uid, detected->uid_len) == 0);
+}
+
 NfcCommand gen4_poller_detect_callback(NfcGenericEvent event, void* context) {
     furi_assert(context);
     furi_assert(event.protocol == NfcProtocolIso14443_3a);
@@ -98,25 +179,44 @@ NfcCommand gen4_poller_detect_callback(NfcGenericEvent event, void* context) {
 
     if(iso3_event->type == Iso14443_3aPollerEventTypeReady) {
         do {
-            // check config
-            bit_buffer_append_byte(gen4_poller_detect_ctx->tx_buffer, GEN4_CMD_PREFIX);
-            bit_buffer_append_bytes(
-                gen4_poller_detect_ctx->tx_buffer,
-                gen4_poller_detect_ctx->password.bytes,
-                GEN4_PASSWORD_LEN);
-            bit_buffer_append_byte(gen4_poller_detect_ctx->tx_buffer, GEN4_CMD_GET_CFG);
+            // check config, the list holds at most GEN4_PASSWORD_LIST_MAX passwords
+            const Gen4PasswordList* passwords = gen4_poller_detect_ctx->passwords;
+            Iso14443_3aError error = Iso14443_3aErrorTimeout;
+            size_t rx_bytes = 0;
+            for(size_t i = 0; i < passwords->count; i++) {
+                if((i > 0) &&
+                   !gen4_poller_detect_reselect(gen4_poller_detect_ctx, iso3_poller)) {
+                    error = Iso14443_3aErrorTimeout;
+                    rx_bytes = 0;
+                    break;
+                }
 
-            Iso14443_3aError error = iso14443_3a_poller_send_standard_frame(
-                iso3_poller,
-                gen4_poller_detect_ctx->tx_buffer,
-                gen4_poller_detect_ctx->rx_buffer,
-                GEN4_POLLER_MAX_FWT);
+                bit_buffer_reset(gen4_poller_detect_ctx->tx_buffer);
+                bit_buffer_reset(gen4_poller_detect_ctx->rx_buffer);
+
+                bit_buffer_append_byte(gen4_poller_detect_ctx->tx_buffer, GEN4_CMD_PREFIX);
+                bit_buffer_append_bytes(
+                    gen4_poller_detect_ctx->tx_buffer,
+                    passwords->passwords[i].bytes,
+                    GEN4_PASSWORD_LEN);
+                bit_buffer_append_byte(gen4_poller_detect_ctx->tx_buffer, GEN4_CMD_GET_CFG);
+
+                error = iso14443_3a_poller_send_standard_frame(
+                    iso3_poller,
+                    gen4_poller_detect_ctx->tx_buffer,
+                    gen4_poller_detect_ctx->rx_buffer,
+                    GEN4_POLLER_MAX_FWT);
+                rx_bytes = bit_buffer_get_size_bytes(gen4_poller_detect_ctx->rx_buffer);
+                if((error == Iso14443_3aErrorNone) && (rx_bytes == GEN4_CONFIG_SIZE)) {
+                    gen4_poller_detect_ctx->password_index = i;
+                    break;
+                }
+            }
 
             if(error != Iso14443_3aErrorNone) {
                 gen4_poller_detect_ctx->error = Gen4PollerErrorProtocol;
                 break;
             }
-            size_t rx_bytes = bit_buffer_get_size_bytes(gen4_poller_detect_ctx->rx_buffer);
             if(rx_bytes != GEN4_CONFIG_SIZE) {
                 gen4_poller_detect_ctx->error = Gen4PollerErrorProtocol;
                 break;
@@ -134,7 +234,7 @@ NfcCommand gen4_poller_detect_callback(NfcGenericEvent event, void* context) {
             bit_buffer_append_byte(gen4_poller_detect_ctx->tx_buffer, GEN4_CMD_PREFIX);
             bit_buffer_append_bytes(
                 gen4_poller_detect_ctx->tx_buffer,
-                gen4_poller_detect_ctx->password.bytes,
+                passwords->passwords[gen4_poller_detect_ctx->password_index].bytes,
                 GEN4_PASSWORD_LEN);
             bit_buffer_append_byte(gen4_poller_detect_ctx->tx_buffer, GEN4_CMD_GET_REVISION);
 
@@ -159,6 +259,12 @@ NfcCommand gen4_poller_detect_callback(NfcGenericEvent event, void* context) {
                 bit_buffer_get_data(gen4_poller_detect_ctx->rx_buffer),
                 GEN4_REVISION_SIZE);
 
+            const Iso14443_3aData* iso3_data = nfc_poller_get_data(gen4_poller_detect_ctx->poller);
+            gen4_set_uid(&gen4_poller_detect_ctx->gen4_data, iso3_data->uid, iso3_data->uid_len);
+            nfc_magic_fingerprint_set_iso14443_3a(gen4_poller_detect_ctx->fingerprint, iso3_data);
+            nfc_magic_fingerprint_set_gen4(
+                gen4_poller_detect_ctx->fingerprint, &gen4_poller_detect_ctx->gen4_data);
+
             gen4_poller_detect_ctx->error = Gen4PollerErrorNone;
         } while(false);
     } else if(iso3_event->type == Iso14443_3aPollerEventTypeError) {
@@ -169,14 +275,22 @@ NfcCommand gen4_poller_detect_callback(NfcGenericEvent event, void* context) {
     return command;
 }
 
-Gen4PollerError gen4_poller_detect(Nfc* nfc, Gen4Password password, Gen4* gen4_data) {
-    furi_assert(nfc);
+Gen4PollerError gen4_poller_detect(
+    NfcMagicDetectContext* detect_ctx,
+    const Gen4PasswordList* passwords,
+    Gen4* gen4_data,
+    Gen4Password* password) {
+    furi_assert(detect_ctx);
+    furi_assert(passwords);
+
+    nfc_magic_detect_context_reset(detect_ctx);
 
     Gen4PollerDetectContext gen4_poller_detect_ctx = {};
-    gen4_poller_detect_ctx.poller = nfc_poller_alloc(nfc, NfcProtocolIso14443_3a);
-    gen4_poller_detect_ctx.password = password;
-    gen4_poller_detect_ctx.tx_buffer = bit_buffer_alloc(GEN4_POLLER_MAX_BUFFER_SIZE);
-    gen4_poller_detect_ctx.rx_buffer = bit_buffer_alloc(GEN4_POLLER_MAX_BUFFER_SIZE);
+    gen4_poller_detect_ctx.poller = nfc_poller_alloc(detect_ctx->nfc, NfcProtocolIso14443_3a);
+    gen4_poller_detect_ctx.passwords = passwords;
+    gen4_poller_detect_ctx.fingerprint = &detect_ctx->fingerprint;
+    gen4_poller_detect_ctx.tx_buffer = detect_ctx->tx_buffer;
+    gen4_poller_detect_ctx.rx_buffer = detect_ctx->rx_buffer;
     gen4_poller_detect_ctx.thread_id = furi_thread_get_current_id();
     gen4_poller_detect_ctx.error = Gen4PollerErrorNone;
 
@@ -190,11 +304,13 @@ Gen4PollerError gen4_poller_detect(Nfc* nfc, Gen4Password password, Gen4* gen4_d
     nfc_poller_stop(gen4_poller_detect_ctx.poller);
 
     nfc_poller_free(gen4_poller_detect_ctx.poller);
-    bit_buffer_free(gen4_poller_detect_ctx.tx_buffer);
-    bit_buffer_free(gen4_poller_detect_ctx.rx_buffer);
 
     if(gen4_poller_detect_ctx.error == Gen4PollerErrorNone) {
         gen4_copy(gen4_data, &gen4_poller_detect_ctx.gen4_data);
+        if(password) {
+            gen4_password_copy(
+                password, &passwords->passwords[gen4_poller_detect_ctx.password_index]);
+        }
     }
 
     return gen4_poller_detect_ctx.error;
@@ -204,6 +320,23 @@ NfcCommand gen4_poller_idle_handler(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     instance->current_block = 0;
+    instance->page_packing = Gen4PollerPagePackingUnknown;
+    instance->is_resume_bound = false;
+
+    // A cached config only holds for the card it was read from
+    const Iso14443_3aData* iso3_data = nfc_poller_get_data(instance->poller);
+    instance->config_cache_valid =
+        (instance->config_cache != NULL) &&
+        gen4_is_uid_equal(instance->config_cache, iso3_data->uid, iso3_data->uid_len);
+    instance->fingerprint_valid =
+        (instance->fingerprint != NULL) && instance->fingerprint->gen4_read &&
+        nfc_magic_fingerprint_is_uid_equal(
+            instance->fingerprint, iso3_data->uid, iso3_data->uid_len);
+
+    // The cache also tracks changes made after detection, so the fingerprint only seeds it
+    if(instance->fingerprint_valid && !instance->config_cache_valid) {
+        gen4_poller_update_config_cache(instance, &instance->fingerprint->gen4_config);
+    }
 
     instance->gen4_event.type = Gen4PollerEventTypeCardDetected;
     command = instance->callback(instance->gen4_event, instance->context);
@@ -217,6 +350,9 @@ NfcCommand gen4_poller_request_mode_handler(Gen4Poller* instance) {
 
     instance->gen4_event.type = Gen4PollerEventTypeRequestMode;
     command = instance->callback(instance->gen4_event, instance->context);
+    instance->provisioning = false;
+    instance->shadow_write = false;
+    instance->shadow_pre_write_set = false;
     if(instance->gen4_event_data.request_mode.mode == Gen4PollerModeWipe) {
         instance->state = Gen4PollerStateWipe;
     } else if(instance->gen4_event_data.request_mode.mode == Gen4PollerModeWrite) {
@@ -231,6 +367,64 @@ NfcCommand gen4_poller_request_mode_handler(Gen4Poller* instance) {
         instance->state = Gen4PollerStateSetShadowMode;
     } else if(instance->gen4_event_data.request_mode.mode == Gen4PollerModeSetDirectWriteBlock0Mode) {
         instance->state = Gen4PollerStateSetDirectWriteBlock0;
+    } else if(instance->gen4_event_data.request_mode.mode == Gen4PollerModeSetConfig) {
+        instance->state = Gen4PollerStateSetConfig;
+    } else if(
+        (instance->gen4_event_data.request_mode.mode == Gen4PollerModeProvision) &&
+        (instance->profile != NULL)) {
+        instance->provisioning = true;
+        instance->state = Gen4PollerStateRequestWriteData;
+    } else if(instance->gen4_event_data.request_mode.mode == Gen4PollerModeWriteShadow) {
+        instance->shadow_write = true;
+        instance->state = Gen4PollerStateRequestWriteData;
+    } else {
+        instance->state = Gen4PollerStateFail;
+    }
+
+    return command;
+}
+
+// Continues a write cut short by card loss when the same card is back for the same image
+static NfcCommand gen4_poller_bind_resume(Gen4Poller* instance, uint32_t source_hash) {
+    NfcCommand command = NfcCommandContinue;
+
+    const Iso14443_3aData* iso3_data = nfc_poller_get_data(instance->poller);
+    instance->current_block = nfc_magic_resume_bind(
+        &instance->resume, iso3_data->uid, iso3_data->uid_len, source_hash);
+    instance->is_resume_bound = true;
+
+    // A retried block is not news to the scene
+    if((instance->current_block > 0) && !nfc_magic_retry_is_pending(&instance->retry)) {
+        FURI_LOG_D(TAG, "Resuming at block %d", instance->current_block);
+        instance->gen4_event.type = Gen4PollerEventTypeResumed;
+        instance->gen4_event_data.resumed.block = instance->current_block;
+        command = instance->callback(instance->gen4_event, instance->context);
+    }
+
+    return command;
+}
+
+// A block, config or metadata write that timed out is retried on a fresh activation after the
+// field was off for a while. Out of retries, a write lost after some progress keeps the cursor.
+// A card that answers with an error, a wrong password for one, fails right away.
+static NfcCommand gen4_poller_handle_write_error(Gen4Poller* instance, Gen4PollerError error) {
+    NfcCommand command = NfcCommandContinue;
+    bool is_transient = (error == Gen4PollerErrorTimeout);
+
+    if(is_transient && nfc_magic_retry_schedule(&instance->retry)) {
+        FURI_LOG_D(TAG, "Retrying block %d", instance->current_block);
+        iso14443_3a_poller_halt(instance->iso3_poller);
+        instance->is_resume_bound = false;
+        instance->gen4_event.type = Gen4PollerEventTypeRetry;
+        instance->gen4_event_data.retry.block = instance->current_block;
+        instance->gen4_event_data.retry.stats = instance->retry.stats;
+        command = instance->callback(instance->gen4_event, instance->context);
+    } else if(is_transient && nfc_magic_resume_has_progress(&instance->resume)) {
+        nfc_magic_retry_end_block(&instance->retry, false);
+        iso14443_3a_poller_halt(instance->iso3_poller);
+        instance->state = Gen4PollerStateIdle;
+        instance->gen4_event.type = Gen4PollerEventTypeCardLost;
+        command = instance->callback(instance->gen4_event, instance->context);
     } else {
         instance->state = Gen4PollerStateFail;
     }
@@ -243,6 +437,13 @@ NfcCommand gen4_poller_wipe_handler(Gen4Poller* instance) {
 
     do {
         Gen4PollerError error = Gen4PollerErrorNone;
+        if(!instance->is_resume_bound) {
+            uint32_t source_hash = nfc_magic_resume_hash(
+                NFC_MAGIC_RESUME_HASH_INIT,
+                gen4_poller_default_block_0,
+                sizeof(gen4_poller_default_block_0));
+            command = gen4_poller_bind_resume(instance, source_hash);
+        }
         if(instance->current_block == 0) {
             error = gen4_poller_set_config(
                 instance,
@@ -252,17 +453,20 @@ NfcCommand gen4_poller_wipe_handler(Gen4Poller* instance) {
                 false);
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to set default config: %d", error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
+            gen4_poller_update_config_cache(instance, &gen4_poller_default_config);
             gen4_password_reset(&instance->password);
             error = gen4_poller_write_block(
                 instance, instance->password, instance->current_block, gen4_poller_default_block_0);
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to write 0 block: %d", error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
+            // The default config is single size UID
+            nfc_magic_resume_set_uid(&instance->resume, gen4_poller_default_block_0, 4);
         } else if(instance->current_block < GEN4_POLLER_BLOCKS_TOTAL) {
             const uint8_t* block = gen4_poller_is_sector_trailer(instance->current_block) ?
                                        gen4_poller_default_sector_trailer_block :
@@ -271,7 +475,7 @@ NfcCommand gen4_poller_wipe_handler(Gen4Poller* instance) {
                 instance, instance->password, instance->current_block, block);
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to write %d block: %d", instance->current_block, error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
         } else {
@@ -279,39 +483,190 @@ NfcCommand gen4_poller_wipe_handler(Gen4Poller* instance) {
             break;
         }
         instance->current_block++;
+        nfc_magic_resume_advance(&instance->resume, instance->current_block);
+        nfc_magic_retry_end_block(&instance->retry, true);
     } while(false);
 
     return command;
 }
 
+static uint16_t gen4_poller_get_image_blocks(NfcProtocol protocol, const NfcDeviceData* data) {
+    uint16_t blocks = 0;
+
+    if(protocol == NfcProtocolMfClassic) {
+        const MfClassicData* mfc_data = data;
+        blocks = mf_classic_get_total_block_num(mfc_data->type);
+    } else if(protocol == NfcProtocolMfUltralight) {
+        const MfUltralightData* mfu_data = data;
+        blocks = mfu_data->pages_read;
+    }
+
+    return blocks;
+}
+
+static const uint8_t* gen4_poller_get_image_block(
+    NfcProtocol protocol,
+    const NfcDeviceData* data,
+    uint16_t block_num,
+    size_t* block_size) {
+    const uint8_t* block = NULL;
+
+    if(protocol == NfcProtocolMfClassic) {
+        const MfClassicData* mfc_data = data;
+        block = mfc_data->block[block_num].data;
+        *block_size = MF_CLASSIC_BLOCK_SIZE;
+    } else {
+        const MfUltralightData* mfu_data = data;
+        block = mfu_data->page[block_num].data;
+        *block_size = MF_ULTRALIGHT_PAGE_SIZE;
+    }
+
+    return block;
+}
+
+static bool gen4_poller_is_diff_base_compatible(Gen4Poller* instance) {
+    bool compatible = false;
+
+    if(instance->diff_base == NULL) {
+        compatible = false;
+    } else if(instance->protocol == NfcProtocolMfClassic) {
+        const MfClassicData* mfc_data = instance->data;
+        const MfClassicData* mfc_base = instance->diff_base;
+        compatible = (mfc_data->type == mfc_base->type);
+    } else {
+        const MfUltralightData* mfu_data = instance->data;
+        const MfUltralightData* mfu_base = instance->diff_base;
+        compatible = (mfu_data->type == mfu_base->type) &&
+                     (mfu_data->pages_read == mfu_base->pages_read);
+    }
+
+    return compatible;
+}
+
+static bool gen4_poller_is_shadow_block_changed(Gen4Poller* instance, uint16_t block_num) {
+    size_t block_size = 0;
+    const uint8_t* block =
+        gen4_poller_get_image_block(instance->protocol, instance->data, block_num, &block_size);
+    const uint8_t* base_block = gen4_poller_get_image_block(
+        instance->protocol, instance->diff_base, block_num, &block_size);
+
+    return memcmp(block, base_block, block_size) != 0;
+}
+
 NfcCommand gen4_poller_request_write_data_handler(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     instance->gen4_event.type = Gen4PollerEventTypeRequestDataToWrite;
+    instance->gen4_event_data.request_data.diff_base = NULL;
+    instance->gen4_event_data.request_data.block_source = NULL;
     command = instance->callback(instance->gen4_event, instance->context);
     instance->protocol = instance->gen4_event_data.request_data.protocol;
     instance->data = instance->gen4_event_data.request_data.data;
+    instance->diff_base = instance->gen4_event_data.request_data.diff_base;
+    instance->block_source = instance->gen4_event_data.request_data.block_source;
 
-    if((instance->protocol == NfcProtocolMfClassic) ||
-       (instance->protocol == NfcProtocolMfUltralight)) {
+    if((instance->protocol != NfcProtocolMfClassic) &&
+       (instance->protocol != NfcProtocolMfUltralight)) {
+        FURI_LOG_E(TAG, "Unsupported protocol");
+        instance->state = Gen4PollerStateFail;
+    } else if(
+        instance->block_source &&
+        (instance->protocol != nfc_magic_block_source_get_protocol(instance->block_source))) {
+        FURI_LOG_E(TAG, "Block source holds another protocol");
+        instance->state = Gen4PollerStateFail;
+    } else if(!instance->shadow_write) {
         instance->state = Gen4PollerStateWrite;
+    } else if(gen4_poller_is_diff_base_compatible(instance)) {
+        instance->state = Gen4PollerStateWriteShadow;
     } else {
-        FURI_LOG_E(TAG, "Unsupported protocol");
+        FURI_LOG_E(TAG, "Shadow image does not match the card image");
         instance->state = Gen4PollerStateFail;
     }
 
     return command;
 }
 
+static bool gen4_poller_get_source_hash(Gen4Poller* instance, uint32_t* hash) {
+    bool hashed = true;
+
+    if(instance->block_source) {
+        hashed = nfc_magic_block_source_get_hash(instance->block_source, hash);
+    } else if(instance->protocol == NfcProtocolMfClassic) {
+        const MfClassicData* mfc_data = instance->data;
+        *hash = nfc_magic_resume_hash(
+            NFC_MAGIC_RESUME_HASH_INIT,
+            mfc_data->block,
+            mf_classic_get_total_block_num(mfc_data->type) * sizeof(MfClassicBlock));
+    } else {
+        const MfUltralightData* mfu_data = instance->data;
+        *hash = nfc_magic_resume_hash(
+            NFC_MAGIC_RESUME_HASH_INIT,
+            mfu_data->page,
+            mfu_data->pages_read * sizeof(MfUltralightPage));
+    }
+
+    return hashed;
+}
+
+static NfcCommand gen4_poller_bind_source(Gen4Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    uint32_t source_hash = 0;
+
+    if(gen4_poller_get_source_hash(instance, &source_hash)) {
+        command = gen4_poller_bind_resume(instance, source_hash);
+    } else {
+        FURI_LOG_E(TAG, "Failed to read the image to write");
+        instance->state = Gen4PollerStateFail;
+    }
+
+    return command;
+}
+
+// Pages of the Ultralight image, from the parsed data or streamed from the file
+static bool gen4_poller_read_mfu_pages(
+    Gen4Poller* instance,
+    uint16_t page,
+    uint16_t count,
+    uint8_t* data) {
+    bool read = true;
+
+    for(uint16_t i = 0; i < count; i++) {
+        MfUltralightPage* dst = (MfUltralightPage*)&data[i * MF_ULTRALIGHT_PAGE_SIZE];
+        if(instance->block_source) {
+            read = nfc_magic_block_source_read_page(instance->block_source, page + i, dst);
+        } else {
+            const MfUltralightData* mfu_data = instance->data;
+            read = (page + i < mfu_data->pages_read);
+            if(read) *dst = mfu_data->page[page + i];
+        }
+        if(!read) break;
+    }
+
+    return read;
+}
+
 static NfcCommand gen4_poller_write_mf_classic(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     do {
         const MfClassicData* mfc_data = instance->data;
-        const Iso14443_3aData* iso3_data = mfc_data->iso14443_3a_data;
+        const Iso14443_3aData* iso3_data = NULL;
+        MfClassicType type = MfClassicTypeNum;
+        if(instance->block_source) {
+            iso3_data = nfc_magic_block_source_get_iso14443_3a_data(instance->block_source);
+            type = nfc_magic_block_source_get_type(instance->block_source);
+        } else {
+            iso3_data = mfc_data->iso14443_3a_data;
+            type = mfc_data->type;
+        }
+
+        if(!instance->is_resume_bound) {
+            command = gen4_poller_bind_source(instance);
+            if(instance->state == Gen4PollerStateFail) break;
+        }
         if(instance->current_block == 0) {
             instance->config.data_parsed.protocol = Gen4ProtocolMfClassic;
-            instance->total_blocks = mf_classic_get_total_block_num(mfc_data->type);
+            instance->total_blocks = mf_classic_get_total_block_num(type);
 
             if(iso3_data->uid_len == 4) {
                 instance->config.data_parsed.uid_len_code = Gen4UIDLengthSingle;
@@ -335,42 +690,171 @@ static NfcCommand gen4_poller_write_mf_classic(Gen4Poller* instance) {
                 instance, instance->password, &instance->config, GEN4_CONFIG_SIZE, false);
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to write config: %d", error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
+            gen4_poller_update_config_cache(instance, &instance->config);
         }
         if(instance->current_block < instance->total_blocks) {
             FURI_LOG_D(TAG, "Writing block %d", instance->current_block);
+            MfClassicBlock block = {};
+            if(instance->block_source) {
+                if(!nfc_magic_block_source_read_block(
+                       instance->block_source, instance->current_block, &block)) {
+                    FURI_LOG_E(TAG, "Failed to read %d block", instance->current_block);
+                    instance->state = Gen4PollerStateFail;
+                    break;
+                }
+            } else {
+                block = mfc_data->block[instance->current_block];
+            }
             Gen4PollerError error = gen4_poller_write_block(
-                instance,
-                instance->password,
-                instance->current_block,
-                mfc_data->block[instance->current_block].data);
+                instance, instance->password, instance->current_block, block.data);
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to write %d block: %d", instance->current_block, error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
+            if(instance->current_block == 0) {
+                nfc_magic_resume_set_uid(&instance->resume, iso3_data->uid, iso3_data->uid_len);
+            }
         } else {
             instance->state = Gen4PollerStateSuccess;
             break;
         }
         instance->current_block++;
+        nfc_magic_resume_advance(&instance->resume, instance->current_block);
+        nfc_magic_retry_end_block(&instance->retry, true);
     } while(false);
 
     return command;
 }
 
+static Gen4PollerError gen4_poller_write_mfu_pages(
+    Gen4Poller* instance,
+    uint8_t page,
+    const uint8_t* data,
+    uint8_t* pages_written) {
+    Gen4PollerError error = Gen4PollerErrorNone;
+    uint8_t block[GEN4_POLLER_BLOCK_SIZE] = {};
+    bool proves_packing = false;
+
+    do {
+        *pages_written = 1;
+
+        // Not every GTU firmware stores the whole 16 byte frame in Ultralight mode.
+        // Read the pages around the first packed write to find out which one this is.
+        if(instance->page_packing == Gen4PollerPagePackingUnknown) {
+            error = gen4_poller_read_block(instance, instance->password, page, block);
+            if(error != Gen4PollerErrorNone) {
+                // Nothing is written yet, the retry path redoes the probe on the same page
+                FURI_LOG_D(TAG, "Failed to read %02X page before packing probe", page);
+                break;
+            }
+            proves_packing = gen4_mfu_frame_proves_packing(block, data);
+        }
+
+        error = gen4_poller_write_block(instance, instance->password, page, data);
+        if(error != Gen4PollerErrorNone) break;
+
+        if(instance->page_packing == Gen4PollerPagePackingUnknown) {
+            error = gen4_poller_read_block(instance, instance->password, page, block);
+            if((error != Gen4PollerErrorNone) ||
+               (memcmp(block, data, GEN4_POLLER_BLOCK_SIZE) != 0)) {
+                FURI_LOG_D(TAG, "Page packing is not supported");
+                instance->page_packing = Gen4PollerPagePackingUnsupported;
+                error = Gen4PollerErrorNone;
+                break;
+            }
+            // If the following pages already held this data the frame proves nothing, keep probing
+            if(proves_packing) {
+                FURI_LOG_D(TAG, "Page packing is supported");
+                instance->page_packing = Gen4PollerPagePackingSupported;
+            }
+        }
+
+        if(instance->page_packing != Gen4PollerPagePackingUnsupported) {
+            *pages_written = GEN4_POLLER_MFU_PAGES_PER_BLOCK;
+        }
+    } while(false);
+
+    return error;
+}
+
+static void gen4_poller_set_mfu_meta_pages(
+    uint8_t* meta,
+    uint32_t* meta_present,
+    uint8_t page,
+    const uint8_t* data,
+    size_t pages) {
+    for(size_t i = 0; i < pages; i++) {
+        size_t index = page + i - GEN4_POLLER_MFU_META_PAGE_FIRST;
+        memcpy(
+            &meta[index * GEN4_POLLER_MFU_PAGE_SIZE],
+            &data[i * GEN4_POLLER_MFU_PAGE_SIZE],
+            GEN4_POLLER_MFU_PAGE_SIZE);
+        *meta_present |= 1UL << index;
+    }
+}
+
+static Gen4PollerError
+    gen4_poller_write_mfu_meta_pages(Gen4Poller* instance, const uint8_t* meta, uint32_t present) {
+    Gen4PollerError error = Gen4PollerErrorNone;
+    const uint32_t group_mask = (1UL << GEN4_POLLER_MFU_PAGES_PER_BLOCK) - 1;
+
+    size_t index = 0;
+    while(index < GEN4_POLLER_MFU_META_PAGES) {
+        if((present & (1UL << index)) == 0) {
+            index++;
+            continue;
+        }
+
+        uint8_t page = GEN4_POLLER_MFU_META_PAGE_FIRST + index;
+        const uint8_t* data = &meta[index * GEN4_POLLER_MFU_PAGE_SIZE];
+        uint8_t pages_written = 1;
+        if((((present >> index) & group_mask) == group_mask) &&
+           (instance->page_packing != Gen4PollerPagePackingUnsupported)) {
+            error = gen4_poller_write_mfu_pages(instance, page, data, &pages_written);
+        } else {
+            // Trailing bytes belong to the following pages or are zero padding
+            error = gen4_poller_write_block(instance, instance->password, page, data);
+        }
+        if(error != Gen4PollerErrorNone) {
+            FURI_LOG_D(TAG, "Failed to write %02X page: %d", page, error);
+            break;
+        }
+        index += pages_written;
+    }
+
+    return error;
+}
+
 static NfcCommand gen4_poller_write_mf_ultralight(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     do {
         const MfUltralightData* mfu_data = instance->data;
-        const Iso14443_3aData* iso3_data = mfu_data->iso14443_3a_data;
+        const Iso14443_3aData* iso3_data = NULL;
+        MfUltralightType type = MfUltralightTypeNum;
+        uint16_t pages_read = 0;
+        if(instance->block_source) {
+            iso3_data = nfc_magic_block_source_get_iso14443_3a_data(instance->block_source);
+            type = nfc_magic_block_source_get_mfu_type(instance->block_source);
+            pages_read = nfc_magic_block_source_get_pages_read(instance->block_source);
+        } else {
+            iso3_data = mfu_data->iso14443_3a_data;
+            type = mfu_data->type;
+            pages_read = mfu_data->pages_read;
+        }
+
+        if(!instance->is_resume_bound) {
+            command = gen4_poller_bind_source(instance);
+            if(instance->state == Gen4PollerStateFail) break;
+        }
         if(instance->current_block == 0) {
             instance->total_blocks = 64;
             instance->config.data_parsed.protocol = Gen4ProtocolMfUltralight;
-            switch(mfu_data->type) {
+            switch(type) {
             case MfUltralightTypeNTAG203:
                 FURI_LOG_D(TAG, "NTAG203 type");
                 instance->config.data_parsed.mfu_mode = Gen4UltralightModeNTAG;
@@ -439,128 +923,119 @@ static NfcCommand gen4_poller_write_mf_ultralight(Gen4Poller* instance) {
                 instance, instance->password, &instance->config, GEN4_CONFIG_SIZE, false);
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to write config: %d", error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
+            gen4_poller_update_config_cache(instance, &instance->config);
         }
 
-        if(instance->current_block < mfu_data->pages_read) {
-            FURI_LOG_D(
-                TAG, "Writing page %zu / %zu", instance->current_block, mfu_data->pages_read);
-            Gen4PollerError error = gen4_poller_write_block(
-                instance,
-                instance->password,
-                instance->current_block,
-                mfu_data->page[instance->current_block].data);
+        if(instance->current_block < pages_read) {
+            FURI_LOG_D(TAG, "Writing page %d / %d", instance->current_block, pages_read);
+            // A frame carries the following pages too, zero padded past the last one
+            uint8_t frame[GEN4_POLLER_BLOCK_SIZE] = {};
+            uint16_t frame_pages =
+                MIN(GEN4_POLLER_MFU_PAGES_PER_BLOCK, pages_read - instance->current_block);
+            if(!gen4_poller_read_mfu_pages(
+                   instance, instance->current_block, frame_pages, frame)) {
+                FURI_LOG_E(TAG, "Failed to read %d page", instance->current_block);
+                instance->state = Gen4PollerStateFail;
+                break;
+            }
+
+            uint8_t pages_written = 1;
+            Gen4PollerError error = Gen4PollerErrorNone;
+            if((frame_pages == GEN4_POLLER_MFU_PAGES_PER_BLOCK) &&
+               (instance->page_packing != Gen4PollerPagePackingUnsupported)) {
+                error = gen4_poller_write_mfu_pages(
+                    instance, instance->current_block, frame, &pages_written);
+            } else {
+                error = gen4_poller_write_block(
+                    instance, instance->password, instance->current_block, frame);
+            }
             if(error != Gen4PollerErrorNone) {
                 FURI_LOG_D(TAG, "Failed to write %d page: %d", instance->current_block, error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_handle_write_error(instance, error);
                 break;
             }
-            instance->current_block++;
+            // The UID spans pages 0 and 1
+            if((instance->current_block < 2) && (instance->current_block + pages_written >= 2)) {
+                nfc_magic_resume_set_uid(&instance->resume, iso3_data->uid, iso3_data->uid_len);
+            }
+            instance->current_block += pages_written;
+            nfc_magic_resume_advance(&instance->resume, instance->current_block);
+            nfc_magic_retry_end_block(&instance->retry, true);
         } else {
-            uint8_t block[GEN4_POLLER_BLOCK_SIZE] = {};
-            bool write_success = true;
+            // Signature, version, password and PACK live in the E5..FB window,
+            // collect them first so that adjacent pages share one frame
+            uint8_t meta[GEN4_POLLER_MFU_META_BUFFER_SIZE] = {};
+            uint32_t meta_present = 0;
+            const uint32_t features = mf_ultralight_get_feature_support_set(type);
+            const MfUltralightSignature* signature = NULL;
+            const MfUltralightVersion* version_data = NULL;
+            if(instance->block_source) {
+                signature = nfc_magic_block_source_get_mfu_signature(instance->block_source);
+                version_data = nfc_magic_block_source_get_mfu_version(instance->block_source);
+            } else {
+                signature = &mfu_data->signature;
+                version_data = &mfu_data->version;
+            }
 
-            if(mf_ultralight_support_feature(
-                   mf_ultralight_get_feature_support_set(mfu_data->type),
-                   MfUltralightFeatureSupportReadSignature)) {
+            if(mf_ultralight_support_feature(features, MfUltralightFeatureSupportReadSignature)) {
                 FURI_LOG_D(TAG, "Writing Signature");
-                for(size_t i = 0; i < 8; i++) {
-                    memcpy(block, &mfu_data->signature.data[i * 4], 4); //-V1086
-                    Gen4PollerError error =
-                        gen4_poller_write_block(instance, instance->password, 0xF2 + i, block);
-                    if(error != Gen4PollerErrorNone) {
-                        write_success = false;
-                        break;
-                    }
-                }
-                if(!write_success) {
-                    FURI_LOG_E(TAG, "Failed to write Signature");
-                    instance->state = Gen4PollerStateFail;
-                    break;
-                }
+                gen4_poller_set_mfu_meta_pages(meta, &meta_present, 0xF2, signature->data, 8);
             } else {
                 FURI_LOG_D(TAG, "Signature is not supported, skipping");
             }
 
-            if(mf_ultralight_support_feature(
-                   mf_ultralight_get_feature_support_set(mfu_data->type),
-                   MfUltralightFeatureSupportReadVersion)) {
-                FURI_LOG_D(TAG, "Writing Version part 1");
-                block[0] = mfu_data->version.header;
-                block[1] = mfu_data->version.vendor_id;
-                block[2] = mfu_data->version.prod_type;
-                block[3] = mfu_data->version.prod_subtype;
-                Gen4PollerError error =
-                    gen4_poller_write_block(instance, instance->password, 0xFA, block);
-                if(error != Gen4PollerErrorNone) {
-                    FURI_LOG_E(TAG, "Failed to write 1st part Version");
-                    instance->state = Gen4PollerStateFail;
-                    break;
-                }
-
-                FURI_LOG_D(TAG, "Writing Version part 2");
-                block[0] = mfu_data->version.prod_ver_major;
-                block[1] = mfu_data->version.prod_ver_minor;
-                block[2] = mfu_data->version.storage_size;
-                block[3] = mfu_data->version.protocol_type;
-                error = gen4_poller_write_block(instance, instance->password, 0xFB, block);
-                if(error != Gen4PollerErrorNone) {
-                    FURI_LOG_E(TAG, "Failed to write 2nd part Version");
-                    instance->state = Gen4PollerStateFail;
-                    break;
-                }
+            if(mf_ultralight_support_feature(features, MfUltralightFeatureSupportReadVersion)) {
+                FURI_LOG_D(TAG, "Writing Version");
+                const uint8_t version[] = {
+                    version_data->header,
+                    version_data->vendor_id,
+                    version_data->prod_type,
+                    version_data->prod_subtype,
+                    version_data->prod_ver_major,
+                    version_data->prod_ver_minor,
+                    version_data->storage_size,
+                    version_data->protocol_type,
+                };
+                gen4_poller_set_mfu_meta_pages(meta, &meta_present, 0xFA, version, 2);
             } else {
                 FURI_LOG_D(TAG, "Version is not supported, skipping");
             }
 
-            if(mf_ultralight_support_feature(
-                   mf_ultralight_get_feature_support_set(mfu_data->type),
-                   MfUltralightFeatureSupportPasswordAuth)) {
-                FURI_LOG_D(TAG, "Writing Password");
-                MfUltralightConfigPages* config_pages = NULL;
-                if(mf_ultralight_get_config_page(mfu_data, &config_pages)) {
-                    block[0] = config_pages->password.data[0];
-                    block[1] = config_pages->password.data[1];
-                    block[2] = config_pages->password.data[2];
-                    block[3] = config_pages->password.data[3];
-                    Gen4PollerError error =
-                        gen4_poller_write_block(instance, instance->password, 0xE5, block);
-                    if(error != Gen4PollerErrorNone) {
-                        FURI_LOG_E(TAG, "Failed to write Password to sector E5");
-                        instance->state = Gen4PollerStateFail;
-                        break;
-                    }
-                    error = gen4_poller_write_block(instance, instance->password, 0xF0, block);
-                    if(error != Gen4PollerErrorNone) {
-                        FURI_LOG_E(TAG, "Failed to write Password to sector F0");
-                        instance->state = Gen4PollerStateFail;
-                        break;
-                    }
-
-                    FURI_LOG_D(TAG, "Writing PACK");
-                    block[0] = config_pages->pack.data[0];
-                    block[1] = config_pages->pack.data[1];
-                    block[2] = 0x00;
-                    block[3] = 0x00;
-                    error = gen4_poller_write_block(instance, instance->password, 0xE6, block);
-                    if(error != Gen4PollerErrorNone) {
-                        FURI_LOG_E(TAG, "Failed to write PACK to sector E6");
-                        instance->state = Gen4PollerStateFail;
-                        break;
-                    }
-                    error = gen4_poller_write_block(instance, instance->password, 0xF1, block);
-                    if(error != Gen4PollerErrorNone) {
-                        FURI_LOG_E(TAG, "Failed to write PACK to sector F1");
-                        instance->state = Gen4PollerStateFail;
-                        break;
-                    }
+            if(mf_ultralight_support_feature(features, MfUltralightFeatureSupportPasswordAuth)) {
+                FURI_LOG_D(TAG, "Writing Password and PACK");
+                MfUltralightConfigPages config_pages = {};
+                if(gen4_poller_read_mfu_pages(
+                       instance,
+                       mf_ultralight_get_config_page_num(type),
+                       sizeof(MfUltralightConfigPages) / MF_ULTRALIGHT_PAGE_SIZE,
+                       (uint8_t*)&config_pages)) {
+                    const uint8_t pack[] = {
+                        config_pages.pack.data[0],
+                        config_pages.pack.data[1],
+                        0x00,
+                        0x00,
+                    };
+                    const uint8_t* password = config_pages.password.data;
+                    gen4_poller_set_mfu_meta_pages(meta, &meta_present, 0xE5, password, 1);
+                    gen4_poller_set_mfu_meta_pages(meta, &meta_present, 0xF0, password, 1);
+                    gen4_poller_set_mfu_meta_pages(meta, &meta_present, 0xE6, pack, 1);
+                    gen4_poller_set_mfu_meta_pages(meta, &meta_present, 0xF1, pack, 1);
                 }
             } else {
                 FURI_LOG_D(TAG, "Password is not supported, skipping");
             }
 
+            Gen4PollerError error = gen4_poller_write_mfu_meta_pages(instance, meta, meta_present);
+            if(error != Gen4PollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to write metadata pages: %d", error);
+                command = gen4_poller_handle_write_error(instance, error);
+                break;
+            }
+            nfc_magic_retry_end_block(&instance->retry, true);
+
             instance->state = Gen4PollerStateSuccess;
         }
     } while(false);
@@ -587,6 +1062,10 @@ NfcCommand gen4_poller_write_handler(Gen4Poller* instance) {
         furi_crash("Unsupported protocol to write");
     }
 
+    if(instance->provisioning && (instance->state == Gen4PollerStateSuccess)) {
+        instance->state = Gen4PollerStateProvision;
+    }
+
     return command;
 }
 
@@ -608,6 +1087,9 @@ NfcCommand gen4_poller_change_password_handler(Gen4Poller* instance) {
         }
 
         instance->password = new_password;
+        if(instance->config_cache_valid) {
+            instance->config_cache->config.data_parsed.password = new_password;
+        }
         instance->state = Gen4PollerStateSuccess;
     } while(false);
 
@@ -618,6 +1100,16 @@ NfcCommand gen4_poller_set_default_cfg_handler(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     do {
+        if(instance->config_cache_valid &&
+           (memcmp(
+                instance->config_cache->config.data_raw,
+                gen4_poller_default_config.data_raw,
+                GEN4_POLLER_DEFAULT_CONFIG_SIZE) == 0)) {
+            FURI_LOG_D(TAG, "Default config already set");
+            instance->state = Gen4PollerStateSuccess;
+            break;
+        }
+
         Gen4PollerError error = gen4_poller_set_config(
             instance,
             instance->password,
@@ -629,6 +1121,7 @@ NfcCommand gen4_poller_set_default_cfg_handler(Gen4Poller* instance) {
             instance->state = Gen4PollerStateFail;
             break;
         }
+        gen4_poller_update_config_cache(instance, &gen4_poller_default_config);
 
         instance->state = Gen4PollerStateSuccess;
     } while(false);
@@ -683,20 +1176,30 @@ NfcCommand gen4_poller_get_info_handler(Gen4Poller* instance) {
     do {
         Gen4 gen4_data;
 
-        Gen4PollerError error =
-            gen4_poller_get_revision(instance, instance->password, &gen4_data.revision);
+        // Revision is fixed in the card firmware, detection already read it
+        Gen4PollerError error = Gen4PollerErrorNone;
+        if(instance->fingerprint_valid) {
+            gen4_data.revision = instance->fingerprint->gen4_revision;
+        } else {
+            error = gen4_poller_get_revision(instance, instance->password, &gen4_data.revision);
+        }
         if(error != Gen4PollerErrorNone) {
             FURI_LOG_E(TAG, "Failed to get revision: %d", error);
             instance->state = Gen4PollerStateFail;
             break;
         }
 
+        // Config is what the user asked to see, always read it from the card
         error = gen4_poller_get_config(instance, instance->password, &gen4_data.config);
         if(error != Gen4PollerErrorNone) {
             FURI_LOG_E(TAG, "Failed to get current config: %d", error);
             instance->state = Gen4PollerStateFail;
             break;
         }
+        gen4_poller_update_config_cache(instance, &gen4_data.config);
+
+        const Iso14443_3aData* iso3_data = nfc_poller_get_data(instance->poller);
+        gen4_set_uid(&gen4_data, iso3_data->uid, iso3_data->uid_len);
 
         // Copy config&&revision data to event data buffer
         gen4_copy(instance->gen4_data, &gen4_data);
@@ -711,6 +1214,13 @@ NfcCommand gen4_poller_set_shadow_mode_handler(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     do {
+        if(instance->config_cache_valid &&
+           (instance->config_cache->config.data_parsed.gtu_mode == instance->shadow_mode)) {
+            FURI_LOG_D(TAG, "Shadow mode already set");
+            instance->state = Gen4PollerStateSuccess;
+            break;
+        }
+
         Gen4PollerError error =
             gen4_poller_set_shadow_mode(instance, instance->password, instance->shadow_mode);
 
@@ -719,6 +1229,9 @@ NfcCommand gen4_poller_set_shadow_mode_handler(Gen4Poller* instance) {
             instance->state = Gen4PollerStateFail;
             break;
         }
+        if(instance->config_cache_valid) {
+            instance->config_cache->config.data_parsed.gtu_mode = instance->shadow_mode;
+        }
 
         instance->state = Gen4PollerStateSuccess;
     } while(false);
@@ -730,6 +1243,14 @@ NfcCommand gen4_poller_set_direct_write_block_0_mode_handler(Gen4Poller* instanc
     NfcCommand command = NfcCommandContinue;
 
     do {
+        if(instance->config_cache_valid &&
+           (instance->config_cache->config.data_parsed.direct_write_mode ==
+            instance->direct_write_block_0_mode)) {
+            FURI_LOG_D(TAG, "Direct write to block 0 mode already set");
+            instance->state = Gen4PollerStateSuccess;
+            break;
+        }
+
         Gen4PollerError error = gen4_poller_set_direct_write_block_0_mode(
             instance, instance->password, instance->direct_write_block_0_mode);
 
@@ -738,6 +1259,169 @@ NfcCommand gen4_poller_set_direct_write_block_0_mode_handler(Gen4Poller* instanc
             instance->state = Gen4PollerStateFail;
             break;
         }
+        if(instance->config_cache_valid) {
+            instance->config_cache->config.data_parsed.direct_write_mode =
+                instance->direct_write_block_0_mode;
+        }
+
+        instance->state = Gen4PollerStateSuccess;
+    } while(false);
+
+    return command;
+}
+
+static Gen4PollerError
+    gen4_poller_apply_config_patch(Gen4Poller* instance, const Gen4ConfigPatch* patch) {
+    Gen4PollerError error = Gen4PollerErrorNone;
+
+    do {
+        Gen4Config config = {};
+        error = gen4_poller_load_config(instance, &config);
+        if(error != Gen4PollerErrorNone) {
+            FURI_LOG_E(TAG, "Failed to get current config: %d", error);
+            break;
+        }
+
+        Gen4Config patched = config;
+        gen4_config_patch_apply(patch, &patched);
+        if(memcmp(patched.data_raw, config.data_raw, GEN4_CONFIG_SIZE) == 0) {
+            FURI_LOG_D(TAG, "Config already up to date");
+            break;
+        }
+
+        error = gen4_poller_set_config(
+            instance, instance->password, &patched, GEN4_CONFIG_SIZE, false);
+        if(error != Gen4PollerErrorNone) {
+            FURI_LOG_E(TAG, "Failed to set config: %d", error);
+            break;
+        }
+        gen4_poller_update_config_cache(instance, &patched);
+    } while(false);
+
+    return error;
+}
+
+NfcCommand gen4_poller_set_config_handler(Gen4Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+
+    Gen4PollerError error = gen4_poller_apply_config_patch(instance, &instance->config_patch);
+    if(error == Gen4PollerErrorNone) {
+        instance->state = Gen4PollerStateSuccess;
+    } else {
+        instance->state = Gen4PollerStateFail;
+    }
+
+    return command;
+}
+
+NfcCommand gen4_poller_provision_handler(Gen4Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    const Gen4Profile* profile = instance->profile;
+
+    do {
+        // Dump is already written, the config overrides land on top of its config
+        Gen4PollerError error = gen4_poller_apply_config_patch(instance, &profile->config_patch);
+        if(error != Gen4PollerErrorNone) {
+            instance->state = Gen4PollerStateFail;
+            break;
+        }
+
+        // Password goes last, every earlier command still uses the current one
+        if(profile->password_set) {
+            error = gen4_poller_change_password(instance, instance->password, profile->password);
+            if(error != Gen4PollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to change password: %d", error);
+                instance->state = Gen4PollerStateFail;
+                break;
+            }
+            instance->password = profile->password;
+            if(instance->config_cache_valid) {
+                instance->config_cache->config.data_parsed.password = profile->password;
+            }
+        }
+
+        instance->state = Gen4PollerStateSuccess;
+    } while(false);
+
+    return command;
+}
+
+// A failed shadow write still takes the card out of pre-write mode, if it is there to listen
+static void gen4_poller_abort_shadow_write(Gen4Poller* instance) {
+    Gen4PollerError error =
+        gen4_poller_set_shadow_mode(instance, instance->password, instance->shadow_mode);
+    if(error == Gen4PollerErrorNone) {
+        instance->shadow_pre_write_set = false;
+        if(instance->config_cache_valid) {
+            instance->config_cache->config.data_parsed.gtu_mode = instance->shadow_mode;
+        }
+    } else {
+        FURI_LOG_E(TAG, "Failed to restore shadow mode after error: %d", error);
+    }
+    instance->state = Gen4PollerStateFail;
+}
+
+NfcCommand gen4_poller_write_shadow_handler(Gen4Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+
+    do {
+        Gen4PollerError error = Gen4PollerErrorNone;
+        if(!instance->shadow_pre_write_set) {
+            instance->total_blocks =
+                gen4_poller_get_image_blocks(instance->protocol, instance->data);
+            instance->blocks_to_write = 0;
+            for(uint16_t i = 0; i < instance->total_blocks; i++) {
+                if(gen4_poller_is_shadow_block_changed(instance, i)) instance->blocks_to_write++;
+            }
+            FURI_LOG_D(TAG, "Shadow blocks to write: %d", instance->blocks_to_write);
+
+            error =
+                gen4_poller_set_shadow_mode(instance, instance->password, Gen4ShadowModePreWrite);
+            if(error != Gen4PollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to set pre-write mode: %d", error);
+                instance->state = Gen4PollerStateFail;
+                break;
+            }
+            instance->shadow_pre_write_set = true;
+            instance->current_block = 0;
+            instance->blocks_written = 0;
+        }
+
+        while((instance->current_block < instance->total_blocks) &&
+              !gen4_poller_is_shadow_block_changed(instance, instance->current_block)) {
+            instance->current_block++;
+        }
+
+        if(instance->current_block < instance->total_blocks) {
+            size_t block_size = 0;
+            const uint8_t* block = gen4_poller_get_image_block(
+                instance->protocol, instance->data, instance->current_block, &block_size);
+            error = gen4_poller_write_block(
+                instance, instance->password, instance->current_block, block);
+            if(error != Gen4PollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to write %d block: %d", instance->current_block, error);
+                gen4_poller_abort_shadow_write(instance);
+                break;
+            }
+            instance->current_block++;
+            instance->blocks_written++;
+
+            instance->gen4_event.type = Gen4PollerEventTypeProgress;
+            instance->gen4_event_data.progress.blocks_written = instance->blocks_written;
+            instance->gen4_event_data.progress.blocks_total = instance->blocks_to_write;
+            command = instance->callback(instance->gen4_event, instance->context);
+            break;
+        }
+
+        error = gen4_poller_set_shadow_mode(instance, instance->password, instance->shadow_mode);
+        if(error != Gen4PollerErrorNone) {
+            FURI_LOG_E(TAG, "Failed to restore shadow mode: %d", error);
+            instance->state = Gen4PollerStateFail;
+            break;
+        }
+        if(instance->config_cache_valid) {
+            instance->config_cache->config.data_parsed.gtu_mode = instance->shadow_mode;
+        }
 
         instance->state = Gen4PollerStateSuccess;
     } while(false);
@@ -750,6 +1434,8 @@ NfcCommand gen4_poller_success_handler(Gen4Poller* instance) {
 
     instance->gen4_event.type = Gen4PollerEventTypeSuccess;
     command = instance->callback(instance->gen4_event, instance->context);
+    nfc_magic_resume_reset(&instance->resume);
+    nfc_magic_retry_reset(&instance->retry);
     if(command != NfcCommandStop) {
         furi_delay_ms(100);
     }
@@ -762,6 +1448,8 @@ NfcCommand gen4_poller_fail_handler(Gen4Poller* instance) {
 
     instance->gen4_event.type = Gen4PollerEventTypeFail;
     command = instance->callback(instance->gen4_event, instance->context);
+    nfc_magic_resume_reset(&instance->resume);
+    nfc_magic_retry_reset(&instance->retry);
     if(command != NfcCommandStop) {
         furi_delay_ms(100);
     }
@@ -780,6 +1468,9 @@ static const Gen4PollerStateHandler gen4_poller_state_handlers[Gen4PollerStateNu
     [Gen4PollerStateSetDefaultConfig] = gen4_poller_set_default_cfg_handler,
     [Gen4PollerStateSetShadowMode] = gen4_poller_set_shadow_mode_handler,
     [Gen4PollerStateSetDirectWriteBlock0] = gen4_poller_set_direct_write_block_0_mode_handler,
+    [Gen4PollerStateSetConfig] = gen4_poller_set_config_handler,
+    [Gen4PollerStateProvision] = gen4_poller_provision_handler,
+    [Gen4PollerStateWriteShadow] = gen4_poller_write_shadow_handler,
     [Gen4PollerStateSuccess] = gen4_poller_success_handler,
     [Gen4PollerStateFail] = gen4_poller_fail_handler,
 
@@ -797,7 +1488,13 @@ static NfcCommand gen4_poller_callback(NfcGenericEvent event, void* context) {
     Iso14443_3aPollerEvent* iso3_event = event.event_data;
 
     if(iso3_event->type == Iso14443_3aPollerEventTypeReady) {
-        command = gen4_poller_state_handlers[instance->state](instance);
+        if(nfc_magic_retry_backoff(&instance->retry)) {
+            // Keep the card powered down, it is activated again after the reset
+            iso14443_3a_poller_halt(instance->iso3_poller);
+            command = NfcCommandReset;
+        } else {
+            command = gen4_poller_state_handlers[instance->state](instance);
+        }
     }
 
     return command;
@@ -838,3 +1535,17 @@ void gen4_poller_struct_set_shadow_mode(Gen4Poller* instance, Gen4ShadowMode mod
 
     instance->shadow_mode = mode;
 }
+
+void gen4_poller_struct_set_config_patch(Gen4Poller* instance, const Gen4ConfigPatch* patch) {
+    furi_assert(instance);
+    furi_assert(patch);
+
+    instance->config_patch = *patch;
+}
+
+void gen4_poller_struct_set_profile(Gen4Poller* instance, const Gen4Profile* profile) {
+    furi_assert(instance);
+    furi_assert(profile);
+
+    instance->profile = profile;
+}
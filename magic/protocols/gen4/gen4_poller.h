@@ -1,6 +1,10 @@
 #pragma once
 
 #include "gen4.h"
+#include "gen4_profile.h"
+#include "../nfc_magic_detect.h"
+#include "../nfc_magic_retry.h"
+#include "../../nfc_magic_block_source.h"
 #include <nfc/nfc.h>
 #include <nfc/protocols/nfc_protocol.h>
 #include <nfc/protocols/mf_classic/mf_classic.h>
@@ -31,6 +35,10 @@ typedef enum {
     Gen4PollerEventTypeRequestMode,
     Gen4PollerEventTypeRequestDataToWrite,
     Gen4PollerEventTypeRequestNewPassword,
+    Gen4PollerEventTypeProgress,
+    Gen4PollerEventTypeCardLost,
+    Gen4PollerEventTypeResumed,
+    Gen4PollerEventTypeRetry,
 
     Gen4PollerEventTypeSuccess,
     Gen4PollerEventTypeFail,
@@ -45,7 +53,10 @@ typedef enum {
 
     Gen4PollerModeSetDefaultCfg,
     Gen4PollerModeSetShadowMode,
-    Gen4PollerModeSetDirectWriteBlock0Mode
+    Gen4PollerModeSetDirectWriteBlock0Mode,
+    Gen4PollerModeSetConfig,
+    Gen4PollerModeProvision,
+    Gen4PollerModeWriteShadow,
 } Gen4PollerMode;
 
 typedef struct {
@@ -55,16 +66,37 @@ typedef struct {
 typedef struct {
     NfcProtocol protocol;
     const NfcDeviceData* data;
+    // Shadow writes only: image already on the card, equal blocks are skipped
+    const NfcDeviceData* diff_base;
+    // Blocks or pages are pulled from the file instead of data, data may be NULL
+    NfcMagicBlockSource* block_source;
 } Gen4PollerEventDataRequestDataToWrite;
 
 typedef struct {
     Gen4Password password;
 } Gen4PollerEventDataRequestNewPassword;
 
+typedef struct {
+    uint16_t blocks_written;
+    uint16_t blocks_total;
+} Gen4PollerEventDataProgress;
+
+typedef struct {
+    uint16_t block;
+} Gen4PollerEventDataResumed;
+
+typedef struct {
+    uint16_t block;
+    NfcMagicRetryStats stats;
+} Gen4PollerEventDataRetry;
+
 typedef union {
     Gen4PollerEventDataRequestMode request_mode;
     Gen4PollerEventDataRequestDataToWrite request_data;
     Gen4PollerEventDataRequestNewPassword request_password;
+    Gen4PollerEventDataProgress progress;
+    Gen4PollerEventDataResumed resumed;
+    Gen4PollerEventDataRetry retry;
 } Gen4PollerEventData;
 
 typedef struct {
@@ -76,7 +108,18 @@ typedef NfcCommand (*Gen4PollerCallback)(Gen4PollerEvent event, void* context);
 
 typedef struct Gen4Poller Gen4Poller;
 
-Gen4PollerError gen4_poller_detect(Nfc* nfc, Gen4Password password, Gen4* gen4_data);
+/**
+ * @brief Look for a Gen4 card answering to any of the passwords.
+ *
+ * All passwords are tried with GET_CFG in list order within one activation.
+ *
+ * @param password where the password the card answered to is copied, may be NULL.
+ */
+Gen4PollerError gen4_poller_detect(
+    NfcMagicDetectContext* detect_ctx,
+    const Gen4PasswordList* passwords,
+    Gen4* gen4_data,
+    Gen4Password* password);
 
 Gen4Poller* gen4_poller_alloc(Nfc* nfc);
 
@@ -84,6 +127,16 @@ void gen4_poller_free(Gen4Poller* instance);
 
 void gen4_poller_set_password(Gen4Poller* instance, Gen4Password password);
 
+// Config known for a card, reused instead of reading it back while the UID matches.
+// Kept up to date with every config change the poller makes.
+void gen4_poller_set_config_cache(Gen4Poller* instance, Gen4* cache);
+
+// Detection results, config and revision are not read again while the UID matches
+void gen4_poller_set_fingerprint(Gen4Poller* instance, const NfcMagicFingerprint* fingerprint);
+
+// Replaces the built-in retry budget, the policy must outlive the poller
+void gen4_poller_set_retry_policy(Gen4Poller* instance, const NfcMagicRetryPolicy* policy);
+
 void gen4_poller_start(Gen4Poller* instance, Gen4PollerCallback callback, void* context);
 
 void gen4_poller_stop(Gen4Poller* instance);
@@ -96,6 +149,12 @@ void gen4_poller_struct_set_direct_write_block_0_mode(
 
 void gen4_poller_struct_set_shadow_mode(Gen4Poller* instance, Gen4ShadowMode mode);
 
+void gen4_poller_struct_set_config_patch(Gen4Poller* instance, const Gen4ConfigPatch* patch);
+
+// Provision writes the dump requested with Gen4PollerEventTypeRequestDataToWrite, applies
+// the profile config overrides and finally sets the profile password, all in one activation
+void gen4_poller_struct_set_profile(Gen4Poller* instance, const Gen4Profile* profile);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gen4_poller.h"
+#include "../nfc_magic_resume.h"
 #include <nfc/nfc_poller.h>
 #include <nfc/protocols/iso14443_3a/iso14443_3a_poller.h>
 #include <bit_lib/bit_lib.h>
@@ -14,9 +15,12 @@ extern "C" {
 #define GEN4_POLLER_MAX_BUFFER_SIZE (64U)
 #define GEN4_POLLER_MAX_FWT (200000U)
 
-#define GEN4_POLLER_BLOCK_SIZE (16)
+#define GEN4_POLLER_BLOCK_SIZE (GEN4_BLOCK_SIZE)
 #define GEN4_POLLER_BLOCKS_TOTAL (256)
 
+#define GEN4_POLLER_MFU_PAGE_SIZE (GEN4_MFU_PAGE_SIZE)
+#define GEN4_POLLER_MFU_PAGES_PER_BLOCK (GEN4_POLLER_BLOCK_SIZE / GEN4_POLLER_MFU_PAGE_SIZE)
+
 typedef enum {
     Gen4PollerStateIdle,
     Gen4PollerStateRequestMode,
@@ -29,6 +33,9 @@ typedef enum {
     Gen4PollerStateSetDefaultConfig,
     Gen4PollerStateSetShadowMode,
     Gen4PollerStateSetDirectWriteBlock0,
+    Gen4PollerStateSetConfig,
+    Gen4PollerStateProvision,
+    Gen4PollerStateWriteShadow,
 
     Gen4PollerStateSuccess,
     Gen4PollerStateFail,
@@ -36,6 +43,12 @@ typedef enum {
     Gen4PollerStateNum,
 } Gen4PollerState;
 
+typedef enum {
+    Gen4PollerPagePackingUnknown,
+    Gen4PollerPagePackingSupported,
+    Gen4PollerPagePackingUnsupported,
+} Gen4PollerPagePacking;
+
 struct Gen4Poller {
     NfcPoller* poller;
     Iso14443_3aPoller* iso3_poller;
@@ -49,12 +62,32 @@ struct Gen4Poller {
     Gen4Config config;
     Gen4ShadowMode shadow_mode;
     Gen4DirectWriteBlock0Mode direct_write_block_0_mode;
+    Gen4ConfigPatch config_patch;
+    const Gen4Profile* profile;
+    bool provisioning;
+
+    const NfcDeviceData* diff_base;
+    NfcMagicBlockSource* block_source;
+    bool shadow_write;
+    bool shadow_pre_write_set;
+    uint16_t blocks_written;
+    uint16_t blocks_to_write;
+
+    Gen4* config_cache;
+    bool config_cache_valid;
+    const NfcMagicFingerprint* fingerprint;
+    // The fingerprint describes the card in the field
+    bool fingerprint_valid;
 
     BitBuffer* tx_buffer;
     BitBuffer* rx_buffer;
 
     uint16_t current_block;
     uint16_t total_blocks;
+    Gen4PollerPagePacking page_packing;
+    NfcMagicResume resume;
+    bool is_resume_bound;
+    NfcMagicRetry retry;
 
     NfcProtocol protocol;
     const NfcDeviceData* data;
@@ -79,6 +112,12 @@ Gen4PollerError gen4_poller_write_block(
     uint8_t block_num,
     const uint8_t* data);
 
+Gen4PollerError gen4_poller_read_block(
+    Gen4Poller* instance,
+    Gen4Password password,
+    uint8_t block_num,
+    uint8_t* data);
+
 Gen4PollerError gen4_poller_change_password(
     Gen4Poller* instance,
     Gen4Password pwd_current,
@@ -0,0 +1,118 @@
+#include "gen4_profile.h"
+
+#include <flipper_format/flipper_format.h>
+
+#define TAG "Gen4Profile"
+
+#define GEN4_PROFILE_FILE_TYPE "Flipper NFC Magic Gen4 profile"
+#define GEN4_PROFILE_FILE_VERSION (1)
+
+#define GEN4_PROFILE_KEY_DUMP "Dump"
+#define GEN4_PROFILE_KEY_SHADOW_MODE "Shadow mode"
+#define GEN4_PROFILE_KEY_DIRECT_WRITE_MODE "Direct write mode"
+#define GEN4_PROFILE_KEY_PASSWORD "Password"
+#define GEN4_PROFILE_KEY_ATS "ATS"
+#define GEN4_PROFILE_KEY_ATQA "ATQA"
+#define GEN4_PROFILE_KEY_SAK "SAK"
+
+Gen4Profile* gen4_profile_alloc() {
+    Gen4Profile* instance = malloc(sizeof(Gen4Profile));
+    instance->dump_path = furi_string_alloc();
+
+    return instance;
+}
+
+void gen4_profile_free(Gen4Profile* instance) {
+    furi_check(instance);
+
+    furi_string_free(instance->dump_path);
+    free(instance);
+}
+
+void gen4_profile_reset(Gen4Profile* instance) {
+    furi_check(instance);
+
+    furi_string_reset(instance->dump_path);
+    memset(&instance->config_patch, 0, sizeof(Gen4ConfigPatch));
+    instance->password_set = false;
+    gen4_password_reset(&instance->password);
+}
+
+// Optional keys may come in any order, so every lookup starts from the top
+static bool gen4_profile_read_uint32(FlipperFormat* ff, const char* key, uint32_t* value) {
+    return flipper_format_rewind(ff) && flipper_format_read_uint32(ff, key, value, 1);
+}
+
+static bool gen4_profile_read_hex(FlipperFormat* ff, const char* key, uint8_t* data, size_t size) {
+    return flipper_format_rewind(ff) && flipper_format_read_hex(ff, key, data, size);
+}
+
+bool gen4_profile_load(Gen4Profile* instance, Storage* storage, const char* path) {
+    furi_check(instance);
+    furi_check(storage);
+    furi_check(path);
+
+    gen4_profile_reset(instance);
+
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    bool loaded = false;
+
+    do {
+        if(!flipper_format_file_open_existing(ff, path)) break;
+
+        uint32_t version = 0;
+        if(!flipper_format_read_header(ff, temp_str, &version)) break;
+        if(furi_string_cmp_str(temp_str, GEN4_PROFILE_FILE_TYPE) != 0) break;
+        if(version != GEN4_PROFILE_FILE_VERSION) break;
+
+        if(!flipper_format_read_string(ff, GEN4_PROFILE_KEY_DUMP, instance->dump_path)) break;
+
+        Gen4ConfigPatch* patch = &instance->config_patch;
+        uint32_t value = 0;
+        if(gen4_profile_read_uint32(ff, GEN4_PROFILE_KEY_SHADOW_MODE, &value)) {
+            if(value > Gen4ShadowModeSplit) break;
+            patch->values.data_parsed.gtu_mode = value;
+            patch->fields |= Gen4ConfigFieldShadowMode;
+        }
+        if(gen4_profile_read_uint32(ff, GEN4_PROFILE_KEY_DIRECT_WRITE_MODE, &value)) {
+            if(value > Gen4DirectWriteBlock0ModeDefault) break;
+            patch->values.data_parsed.direct_write_mode = value;
+            patch->fields |= Gen4ConfigFieldDirectWriteMode;
+        }
+
+        uint32_t ats_len = 0;
+        if(flipper_format_rewind(ff) &&
+           flipper_format_get_value_count(ff, GEN4_PROFILE_KEY_ATS, &ats_len)) {
+            if(ats_len > GEN4_ATS_MAX_LEN) break;
+            if(!gen4_profile_read_hex(
+                   ff, GEN4_PROFILE_KEY_ATS, patch->values.data_parsed.ats, ats_len)) {
+                break;
+            }
+            patch->values.data_parsed.ats_len = ats_len;
+            patch->fields |= Gen4ConfigFieldAts;
+        }
+        if(gen4_profile_read_hex(
+               ff, GEN4_PROFILE_KEY_ATQA, patch->values.data_parsed.atqa, GEN4_ATQA_LEN)) {
+            patch->fields |= Gen4ConfigFieldAtqa;
+        }
+        if(gen4_profile_read_hex(ff, GEN4_PROFILE_KEY_SAK, &patch->values.data_parsed.sak, 1)) {
+            patch->fields |= Gen4ConfigFieldSak;
+        }
+
+        instance->password_set = gen4_profile_read_hex(
+            ff, GEN4_PROFILE_KEY_PASSWORD, instance->password.bytes, GEN4_PASSWORD_LEN);
+
+        loaded = true;
+    } while(false);
+
+    if(!loaded) {
+        FURI_LOG_E(TAG, "Failed to load profile %s", path);
+        gen4_profile_reset(instance);
+    }
+
+    furi_string_free(temp_str);
+    flipper_format_free(ff);
+
+    return loaded;
+}
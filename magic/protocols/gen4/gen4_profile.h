@@ -0,0 +1,43 @@
+#pragma once
+
+#include "gen4.h"
+#include <furi.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEN4_PROFILE_EXTENSION ".gen4"
+
+// Everything needed to bring a blank Gen4 card to its production state:
+// the dump to clone, config overrides applied on top of it and the final password.
+//
+// Filetype: Flipper NFC Magic Gen4 profile
+// Version: 1
+// Dump: /ext/nfc/card.nfc
+// # Optional, omitted keys keep the values written with the dump
+// Shadow mode: 2
+// Direct write mode: 1
+// ATS: 05 78 80 70 02
+// ATQA: 00 44
+// SAK: 08
+// Password: 00 00 00 00
+typedef struct {
+    FuriString* dump_path;
+    Gen4ConfigPatch config_patch;
+    bool password_set;
+    Gen4Password password;
+} Gen4Profile;
+
+Gen4Profile* gen4_profile_alloc();
+
+void gen4_profile_free(Gen4Profile* instance);
+
+void gen4_profile_reset(Gen4Profile* instance);
+
+bool gen4_profile_load(Gen4Profile* instance, Storage* storage, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,31 @@
+#include "nfc_magic_detect.h"
+
+#include <furi/furi.h>
+
+NfcMagicDetectContext* nfc_magic_detect_context_alloc(Nfc* nfc) {
+    furi_assert(nfc);
+
+    NfcMagicDetectContext* instance = malloc(sizeof(NfcMagicDetectContext));
+    instance->nfc = nfc;
+    instance->tx_buffer = bit_buffer_alloc(NFC_MAGIC_DETECT_MAX_BUFFER_SIZE);
+    instance->rx_buffer = bit_buffer_alloc(NFC_MAGIC_DETECT_MAX_BUFFER_SIZE);
+    nfc_magic_fingerprint_reset(&instance->fingerprint);
+
+    return instance;
+}
+
+void nfc_magic_detect_context_free(NfcMagicDetectContext* instance) {
+    furi_assert(instance);
+
+    bit_buffer_free(instance->tx_buffer);
+    bit_buffer_free(instance->rx_buffer);
+    free(instance);
+}
+
+void nfc_magic_detect_context_reset(NfcMagicDetectContext* instance) {
+    furi_assert(instance);
+
+    bit_buffer_reset(instance->tx_buffer);
+    bit_buffer_reset(instance->rx_buffer);
+    nfc_magic_fingerprint_reset(&instance->fingerprint);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "nfc_magic_fingerprint.h"
+#include <nfc/nfc.h>
+#include <toolbox/bit_buffer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NFC_MAGIC_DETECT_MAX_BUFFER_SIZE (64U)
+
+/**
+ * @brief Scratch state shared by all magic detect functions.
+ *
+ * Owned by the scanner and lent to each detect call, so that repeated
+ * scanning doesn't allocate and free the same buffers on every pass.
+ */
+typedef struct {
+    Nfc* nfc;
+    BitBuffer* tx_buffer;
+    BitBuffer* rx_buffer;
+    // What the last detect call saw of the card
+    NfcMagicFingerprint fingerprint;
+} NfcMagicDetectContext;
+
+NfcMagicDetectContext* nfc_magic_detect_context_alloc(Nfc* nfc);
+
+void nfc_magic_detect_context_free(NfcMagicDetectContext* instance);
+
+void nfc_magic_detect_context_reset(NfcMagicDetectContext* instance);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+#include "nfc_magic_fingerprint.h"
+
+#include <furi/furi.h>
+#include <string.h>
+
+void nfc_magic_fingerprint_reset(NfcMagicFingerprint* instance) {
+    furi_assert(instance);
+
+    memset(instance, 0, sizeof(NfcMagicFingerprint));
+    instance->protocol = NfcMagicProtocolInvalid;
+}
+
+static void nfc_magic_fingerprint_set_uid(
+    NfcMagicFingerprint* instance,
+    const uint8_t* uid,
+    size_t uid_len) {
+    instance->uid_len = MIN(uid_len, sizeof(instance->uid));
+    memcpy(instance->uid, uid, instance->uid_len);
+}
+
+void nfc_magic_fingerprint_set_iso14443_3a(
+    NfcMagicFingerprint* instance,
+    const Iso14443_3aData* iso3_data) {
+    furi_assert(instance);
+    furi_assert(iso3_data);
+
+    nfc_magic_fingerprint_set_uid(instance, iso3_data->uid, iso3_data->uid_len);
+    memcpy(instance->atqa, iso3_data->atqa, sizeof(instance->atqa));
+    instance->sak = iso3_data->sak;
+}
+
+void nfc_magic_fingerprint_set_ats(NfcMagicFingerprint* instance, const uint8_t* ats, size_t len) {
+    furi_assert(instance);
+    furi_assert(ats);
+
+    instance->ats_len = MIN(len, sizeof(instance->ats));
+    memcpy(instance->ats, ats, instance->ats_len);
+}
+
+void nfc_magic_fingerprint_set_gen4(NfcMagicFingerprint* instance, const Gen4* gen4_data) {
+    furi_assert(instance);
+    furi_assert(gen4_data);
+
+    instance->gen4_config = gen4_data->config;
+    instance->gen4_revision = gen4_data->revision;
+    instance->gen4_read = true;
+}
+
+void nfc_magic_fingerprint_set_slix(NfcMagicFingerprint* instance, const SlixData* slix_data) {
+    furi_assert(instance);
+    furi_assert(slix_data);
+
+    nfc_magic_fingerprint_set_uid(instance, slix_data->uid, SLIX_UID_LEN);
+    instance->slix_system_info_read = slix_data->system_info_read;
+    if(slix_data->system_info_read) {
+        instance->slix_system_info = slix_data->iso15693_3_info;
+    }
+}
+
+bool nfc_magic_fingerprint_is_uid_equal(
+    const NfcMagicFingerprint* instance,
+    const uint8_t* uid,
+    size_t uid_len) {
+    furi_assert(instance);
+
+    return (uid != NULL) && (instance->uid_len != 0) && (instance->uid_len == uid_len) &&
+           (memcmp(instance->uid, uid, uid_len) == 0);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "nfc_magic_protocols.h"
+#include "gen4/gen4.h"
+#include "slix/slix.h"
+#include <nfc/protocols/iso14443_3a/iso14443_3a.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NFC_MAGIC_FINGERPRINT_UID_SIZE_MAX (10U)
+#define NFC_MAGIC_FINGERPRINT_ATS_SIZE_MAX (16U)
+
+/**
+ * @brief What detection learned about a card.
+ *
+ * Filled by the detect functions and handed by the scanner to the operation
+ * pollers, which take the parts they need instead of reading them again as
+ * long as the card in the field has the same UID.
+ */
+typedef struct {
+    NfcMagicProtocol protocol;
+    uint8_t uid[NFC_MAGIC_FINGERPRINT_UID_SIZE_MAX];
+    uint8_t uid_len;
+
+    // ISO14443-3A cards, ats_len is 0 when no RATS was sent
+    uint8_t atqa[2];
+    uint8_t sak;
+    uint8_t ats[NFC_MAGIC_FINGERPRINT_ATS_SIZE_MAX];
+    uint8_t ats_len;
+
+    // Gen4 cards, as read with the password that matched
+    bool gen4_read;
+    Gen4Config gen4_config;
+    Gen4Revision gen4_revision;
+
+    // SLIX cards
+    bool slix_system_info_read;
+    Iso15693_3SystemInfo slix_system_info;
+} NfcMagicFingerprint;
+
+void nfc_magic_fingerprint_reset(NfcMagicFingerprint* instance);
+
+void nfc_magic_fingerprint_set_iso14443_3a(
+    NfcMagicFingerprint* instance,
+    const Iso14443_3aData* iso3_data);
+
+void nfc_magic_fingerprint_set_ats(NfcMagicFingerprint* instance, const uint8_t* ats, size_t len);
+
+void nfc_magic_fingerprint_set_gen4(NfcMagicFingerprint* instance, const Gen4* gen4_data);
+
+// Takes the UID and, if detect got it, the ISO15693-3 system info
+void nfc_magic_fingerprint_set_slix(NfcMagicFingerprint* instance, const SlixData* slix_data);
+
+// A fingerprint without a UID never matches
+bool nfc_magic_fingerprint_is_uid_equal(
+    const NfcMagicFingerprint* instance,
+    const uint8_t* uid,
+    size_t uid_len);
+
+#ifdef __cplusplus
+}
+#endif
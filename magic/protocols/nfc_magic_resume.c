@@ -0,0 +1,81 @@
+#include "nfc_magic_resume.h"
+
+#include <furi/furi.h>
+#include <string.h>
+
+#define NFC_MAGIC_RESUME_HASH_PRIME (16777619UL)
+
+uint32_t nfc_magic_resume_hash(uint32_t hash, const void* data, size_t size) {
+    furi_assert(data);
+
+    // FNV-1a, the image only needs telling apart from another one
+    const uint8_t* bytes = data;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= NFC_MAGIC_RESUME_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+void nfc_magic_resume_reset(NfcMagicResume* instance) {
+    furi_assert(instance);
+
+    memset(instance, 0, sizeof(NfcMagicResume));
+}
+
+bool nfc_magic_resume_is_pending(const NfcMagicResume* instance, uint32_t source_hash) {
+    furi_assert(instance);
+
+    return (instance->next_block > 0) && (instance->source_hash == source_hash);
+}
+
+bool nfc_magic_resume_is_same_card(
+    const NfcMagicResume* instance,
+    const uint8_t* uid,
+    size_t uid_len) {
+    furi_assert(instance);
+
+    return (uid != NULL) && (uid_len == instance->uid_len) &&
+           (memcmp(uid, instance->uid, uid_len) == 0);
+}
+
+uint16_t nfc_magic_resume_bind(
+    NfcMagicResume* instance,
+    const uint8_t* uid,
+    size_t uid_len,
+    uint32_t source_hash) {
+    furi_assert(instance);
+
+    if(!nfc_magic_resume_is_same_card(instance, uid, uid_len) ||
+       !nfc_magic_resume_is_pending(instance, source_hash)) {
+        nfc_magic_resume_reset(instance);
+        instance->source_hash = source_hash;
+        if(uid != NULL) {
+            nfc_magic_resume_set_uid(instance, uid, uid_len);
+        }
+    }
+    instance->start_block = instance->next_block;
+
+    return instance->next_block;
+}
+
+void nfc_magic_resume_set_uid(NfcMagicResume* instance, const uint8_t* uid, size_t uid_len) {
+    furi_assert(instance);
+    furi_assert(uid);
+
+    instance->uid_len = MIN(uid_len, sizeof(instance->uid));
+    memcpy(instance->uid, uid, instance->uid_len);
+}
+
+void nfc_magic_resume_advance(NfcMagicResume* instance, uint16_t next_block) {
+    furi_assert(instance);
+
+    instance->next_block = next_block;
+}
+
+bool nfc_magic_resume_has_progress(const NfcMagicResume* instance) {
+    furi_assert(instance);
+
+    return instance->next_block > instance->start_block;
+}
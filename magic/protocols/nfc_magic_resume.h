@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NFC_MAGIC_RESUME_UID_SIZE_MAX (10U)
+
+#define NFC_MAGIC_RESUME_HASH_INIT (2166136261UL)
+
+/**
+ * @brief Write cursor kept by a block writer across card loss.
+ *
+ * Bound to the UID the card answers with and to a hash of the image being
+ * written. When the same card comes back for the same image, the writer
+ * continues from the first block that was not acknowledged.
+ */
+typedef struct {
+    uint8_t uid[NFC_MAGIC_RESUME_UID_SIZE_MAX];
+    uint8_t uid_len;
+    uint32_t source_hash;
+    // First block not acknowledged by the card
+    uint16_t next_block;
+    // Block the current activation started from
+    uint16_t start_block;
+} NfcMagicResume;
+
+uint32_t nfc_magic_resume_hash(uint32_t hash, const void* data, size_t size);
+
+void nfc_magic_resume_reset(NfcMagicResume* instance);
+
+bool nfc_magic_resume_is_pending(const NfcMagicResume* instance, uint32_t source_hash);
+
+bool nfc_magic_resume_is_same_card(
+    const NfcMagicResume* instance,
+    const uint8_t* uid,
+    size_t uid_len);
+
+/**
+ * @brief Bind the cursor to the card in the field and the image to write.
+ *
+ * @return block to continue from, 0 if the card or the image is not the one
+ * the cursor was bound to. A NULL uid never matches.
+ */
+uint16_t nfc_magic_resume_bind(
+    NfcMagicResume* instance,
+    const uint8_t* uid,
+    size_t uid_len,
+    uint32_t source_hash);
+
+// Writing block 0 changes the UID the card answers with
+void nfc_magic_resume_set_uid(NfcMagicResume* instance, const uint8_t* uid, size_t uid_len);
+
+void nfc_magic_resume_advance(NfcMagicResume* instance, uint16_t next_block);
+
+// Whether the current activation acknowledged at least one block
+bool nfc_magic_resume_has_progress(const NfcMagicResume* instance);
+
+#ifdef __cplusplus
+}
+#endif
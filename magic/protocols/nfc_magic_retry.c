@@ -0,0 +1,65 @@
+#include "nfc_magic_retry.h"
+
+#include <furi/furi.h>
+#include <string.h>
+
+void nfc_magic_retry_init(NfcMagicRetry* instance, const NfcMagicRetryPolicy* policy) {
+    furi_assert(instance);
+    furi_assert(policy);
+
+    instance->policy = policy;
+    nfc_magic_retry_reset(instance);
+}
+
+void nfc_magic_retry_reset(NfcMagicRetry* instance) {
+    furi_assert(instance);
+
+    memset(&instance->stats, 0, sizeof(NfcMagicRetryStats));
+    instance->attempt = 0;
+    instance->backoff_left = 0;
+}
+
+bool nfc_magic_retry_schedule(NfcMagicRetry* instance) {
+    furi_assert(instance);
+    furi_assert(instance->policy);
+
+    const NfcMagicRetryPolicy* policy = instance->policy;
+    bool scheduled = false;
+
+    if(instance->attempt < policy->block_retries) {
+        uint32_t backoff = (uint32_t)policy->backoff_resets_min << instance->attempt;
+        instance->backoff_left = MIN(backoff, policy->backoff_resets_max);
+        instance->attempt++;
+        instance->stats.retries++;
+        scheduled = true;
+    }
+
+    return scheduled;
+}
+
+bool nfc_magic_retry_is_pending(const NfcMagicRetry* instance) {
+    furi_assert(instance);
+
+    return instance->attempt > 0;
+}
+
+bool nfc_magic_retry_backoff(NfcMagicRetry* instance) {
+    furi_assert(instance);
+
+    bool is_backoff = instance->backoff_left > 0;
+    if(is_backoff) {
+        instance->backoff_left--;
+    }
+
+    return is_backoff;
+}
+
+void nfc_magic_retry_end_block(NfcMagicRetry* instance, bool acked) {
+    furi_assert(instance);
+
+    if(acked && (instance->attempt > 0)) {
+        instance->stats.recovered++;
+    }
+    instance->attempt = 0;
+    instance->backoff_left = 0;
+}
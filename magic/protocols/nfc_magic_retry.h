@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Retry budget of a block writer for transient errors.
+ *
+ * Backoff is counted in field resets: the card is powered down for backoff_resets_min
+ * resets before the first retry and for twice as many before every retry after it.
+ * Every poller has its own, sized to what a retry costs on its protocol.
+ */
+typedef struct {
+    // Attempts a block gets on top of the first one
+    uint8_t block_retries;
+    uint8_t backoff_resets_min;
+    uint8_t backoff_resets_max;
+} NfcMagicRetryPolicy;
+
+typedef struct {
+    // Retries over the whole operation
+    uint16_t retries;
+    // Blocks acknowledged on a retry
+    uint16_t recovered;
+} NfcMagicRetryStats;
+
+typedef struct {
+    const NfcMagicRetryPolicy* policy;
+    NfcMagicRetryStats stats;
+    // Retries spent on the current block
+    uint8_t attempt;
+    // Field resets left before the current block is retried
+    uint8_t backoff_left;
+} NfcMagicRetry;
+
+void nfc_magic_retry_init(NfcMagicRetry* instance, const NfcMagicRetryPolicy* policy);
+
+// Clears the counters for a new operation, the policy is kept
+void nfc_magic_retry_reset(NfcMagicRetry* instance);
+
+/**
+ * @brief Schedule another attempt at the current block after a transient error.
+ *
+ * @return true if the budget allows it, the backoff is then armed.
+ */
+bool nfc_magic_retry_schedule(NfcMagicRetry* instance);
+
+// Whether the current block already failed at least once
+bool nfc_magic_retry_is_pending(const NfcMagicRetry* instance);
+
+/**
+ * @brief Spend one field reset of the armed backoff.
+ *
+ * @return true if the poller has to return NfcCommandReset instead of running.
+ */
+bool nfc_magic_retry_backoff(NfcMagicRetry* instance);
+
+// The current block was acknowledged or given up on, the next one gets a full budget
+void nfc_magic_retry_end_block(NfcMagicRetry* instance, bool acked);
+
+#ifdef __cplusplus
+}
+#endif
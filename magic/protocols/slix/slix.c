@@ -1,7 +1,9 @@
 #include "slix.h"
+#include "slix_device.h"
 #include <furi/furi.h>
 #include <nfc/protocols/iso15693_3/iso15693_3.h>
 #include <nfc/helpers/iso13239_crc.h>
+#include <toolbox/simple_array.h>
 #include <string.h>
 
 // From NXP AN10787 ICODE UID format
@@ -12,16 +14,79 @@
 #define SLIX_TYPE_INDICATOR_SLIX  (0x02U)
 
 void slix_build_inventory_request(BitBuffer* buf) {
+    // No AFI, no mask
+    slix_build_masked_inventory_request(buf, 0, 0);
+}
+
+void slix_build_masked_inventory_request(BitBuffer* buf, uint64_t mask, uint8_t mask_len) {
+    furi_assert(mask_len <= SLIX_UID_LEN * 8);
+
     bit_buffer_reset(buf);
     uint8_t flags = ISO15693_3_REQ_FLAG_INVENTORY_T5 | ISO15693_3_REQ_FLAG_T5_N_SLOTS_1 |
                     ISO15693_3_REQ_FLAG_DATA_RATE_HI;
     bit_buffer_append_byte(buf, flags);
     bit_buffer_append_byte(buf, ISO15693_3_CMD_INVENTORY);
-    // No AFI, no mask
-    bit_buffer_append_byte(buf, 0x00);
+    // Mask length in bits, followed by the mask value padded to whole bytes
+    bit_buffer_append_byte(buf, mask_len);
+    for(uint8_t i = 0; i < (mask_len + 7) / 8; i++) {
+        bit_buffer_append_byte(buf, (mask >> (i * 8)) & 0xFF);
+    }
+    iso13239_crc_append(Iso13239CrcTypeDefault, buf);
+}
+
+void slix_build_system_info_request(BitBuffer* buf, const uint8_t* uid) {
+    bit_buffer_reset(buf);
+    // Addressed, High data rate
+    uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI |
+                    ISO15693_3_REQ_FLAG_T4_ADDRESSED;
+    bit_buffer_append_byte(buf, flags);
+    bit_buffer_append_byte(buf, ISO15693_3_CMD_GET_SYS_INFO);
+    bit_buffer_append_bytes(buf, uid, SLIX_UID_LEN);
     iso13239_crc_append(Iso13239CrcTypeDefault, buf);
 }
 
+bool slix_parse_system_info_response(SlixData* data, const BitBuffer* buf) {
+    furi_assert(data);
+    furi_assert(buf);
+
+    // Response format: flags(1) + info_flags(1) + uid(8) + optional_data(...)
+    const size_t min_resp_size = 1 + 1 + SLIX_UID_LEN;
+    const size_t resp_size = bit_buffer_get_size_bytes(buf);
+    if(resp_size < min_resp_size) return false;
+
+    const uint8_t* resp_data = bit_buffer_get_data(buf);
+    if(resp_data[0] & ISO15693_3_RESP_FLAG_ERROR) return false;
+
+    Iso15693_3SystemInfo* info = &data->iso15693_3_info;
+    info->flags = resp_data[1];
+
+    // Each optional field is only present when its info flag is set
+    size_t optional_size = 0;
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_DSFID) optional_size += 1;
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_AFI) optional_size += 1;
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_MEMORY) optional_size += 2;
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_IC_REF) optional_size += 1;
+    if(resp_size < min_resp_size + optional_size) return false;
+
+    const uint8_t* extra_data = &resp_data[min_resp_size];
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_DSFID) {
+        info->dsfid = *extra_data++;
+    }
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_AFI) {
+        info->afi = *extra_data++;
+    }
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_MEMORY) {
+        info->block_count = *extra_data++ + 1;
+        info->block_size = (*extra_data++ & 0x1F) + 1;
+    }
+    if(info->flags & ISO15693_3_SYSINFO_FLAG_IC_REF) {
+        info->ic_ref = *extra_data++;
+    }
+    data->system_info_read = true;
+
+    return true;
+}
+
 void slix_build_write_block_request(
     BitBuffer* buf,
     const uint8_t* uid,
@@ -90,3 +155,76 @@ SlixType slix_get_type(const SlixData* data) {
 
     return type;
 }
+
+void slix_save_to_device(const SlixData* data, NfcDevice* device) {
+    furi_assert(data);
+    furi_assert(device);
+
+    Iso15693_3Data* iso15693_3_data = iso15693_3_alloc();
+    memcpy(iso15693_3_data->uid, data->uid, SLIX_UID_LEN);
+    iso15693_3_data->system_info = data->iso15693_3_info;
+    iso15693_3_data->settings = data->iso15693_3_settings;
+
+    // Only the blocks that were actually read end up in the file
+    const uint16_t block_count = data->memory_blocks_read;
+    iso15693_3_data->system_info.block_count = block_count;
+    iso15693_3_data->system_info.block_size = SLIX_BLOCK_SIZE;
+    simple_array_init(iso15693_3_data->block_data, block_count * SLIX_BLOCK_SIZE);
+    memcpy(
+        simple_array_get_data(iso15693_3_data->block_data),
+        data->memory,
+        block_count * SLIX_BLOCK_SIZE);
+    simple_array_init(iso15693_3_data->block_security, block_count);
+
+    SlixDeviceNxpData nxp_data = {
+        .protection_pointer = data->slix_info.protection_pointer,
+        .protection_condition = data->slix_info.protection_condition,
+        .lock_eas = data->slix_info.lock_eas,
+        .lock_ppl = data->slix_info.lock_ppl,
+        .signature_read = data->signature_read,
+    };
+    memcpy(nxp_data.signature, data->signature, SLIX_SIGNATURE_SIZE);
+
+    slix_device_set_data(device, iso15693_3_data, &nxp_data);
+    iso15693_3_free(iso15693_3_data);
+}
+
+bool slix_load_from_device(SlixData* data, const NfcDevice* device) {
+    furi_assert(data);
+    furi_assert(device);
+
+    bool loaded = false;
+
+    do {
+        SlixDeviceNxpData nxp_data;
+        const Iso15693_3Data* iso15693_3_data = slix_device_get_data(device, &nxp_data);
+        if(iso15693_3_data == NULL) break;
+
+        const Iso15693_3SystemInfo* info = &iso15693_3_data->system_info;
+        if(info->block_size != SLIX_BLOCK_SIZE) break;
+        if(info->block_count > SLIX_BLOCKS_MAX) break;
+
+        slix_reset(data);
+        memcpy(data->uid, iso15693_3_data->uid, SLIX_UID_LEN);
+        data->iso15693_3_info = *info;
+        data->system_info_read = true;
+        data->iso15693_3_settings = iso15693_3_data->settings;
+        data->memory_blocks_read = info->block_count;
+        memcpy(
+            data->memory,
+            simple_array_cget_data(iso15693_3_data->block_data),
+            info->block_count * SLIX_BLOCK_SIZE);
+
+        data->slix_info.protection_pointer = nxp_data.protection_pointer;
+        data->slix_info.protection_condition = nxp_data.protection_condition;
+        data->slix_info.lock_eas = nxp_data.lock_eas;
+        data->slix_info.lock_ppl = nxp_data.lock_ppl;
+        data->signature_read = nxp_data.signature_read;
+        memcpy(data->signature, nxp_data.signature, SLIX_SIGNATURE_SIZE);
+
+        data->type = slix_get_type(data);
+        loaded = true;
+    } while(false);
+
+    return loaded;
+}
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <toolbox/bit_buffer.h>
 #include <nfc/protocols/iso15693_3/iso15693_3.h>
+#include <nfc/nfc_device.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,6 +13,10 @@ extern "C" {
 #define SLIX_BLOCK_SIZE     4
 #define SLIX_SIGNATURE_SIZE 32
 
+// SLIX2 has the largest user memory of the family (80 blocks)
+#define SLIX_BLOCKS_MAX  80
+#define SLIX_MEMORY_SIZE (SLIX_BLOCKS_MAX * SLIX_BLOCK_SIZE)
+
 #define SLIX_NXP_MANUFACTURER_CODE          (0x04U)
 #define SLIX_CMD_GET_NXP_SYSTEM_INFORMATION (0xABU)
 #define SLIX_CMD_READ_SIGNATURE             (0xBDU)
@@ -40,13 +45,36 @@ typedef struct {
     SlixType type;
     Iso15693_3Settings iso15693_3_settings;
     Iso15693_3SystemInfo iso15693_3_info;
+    bool system_info_read;
     SlixSystemInfo slix_info;
     SlixSignature signature;
     bool signature_read;
+    uint8_t memory[SLIX_MEMORY_SIZE];
+    uint16_t memory_blocks_read;
 } SlixData;
 
 void slix_build_inventory_request(BitBuffer* buf);
 
+/**
+ * @brief Build a single-slot INVENTORY request answered only by cards whose UID matches the mask.
+ *
+ * @param buf Buffer to fill.
+ * @param mask UID bits to match, least significant bit first.
+ * @param mask_len Number of mask bits, 0 to 64.
+ */
+void slix_build_masked_inventory_request(BitBuffer* buf, uint64_t mask, uint8_t mask_len);
+
+void slix_build_system_info_request(BitBuffer* buf, const uint8_t* uid);
+
+/**
+ * @brief Parse a GET SYSTEM INFO response into SlixData.
+ *
+ * @param[out] data SlixData to fill, system_info_read is set on success.
+ * @param buf Response with the CRC already checked and trimmed.
+ * @return true if the response was valid, false otherwise.
+ */
+bool slix_parse_system_info_response(SlixData* data, const BitBuffer* buf);
+
 SlixData* slix_alloc(void);
 
 void slix_free(SlixData* data);
@@ -57,6 +85,23 @@ void slix_copy(SlixData* dest, const SlixData* src);
 
 SlixType slix_get_type(const SlixData* data);
 
+/**
+ * @brief Store a SLIX dump (system info, NXP info, signature and memory) in an NfcDevice.
+ *
+ * @param data SLIX dump to store.
+ * @param device NfcDevice to fill.
+ */
+void slix_save_to_device(const SlixData* data, NfcDevice* device);
+
+/**
+ * @brief Load a SLIX dump from an NfcDevice holding SLIX or ISO15693-3 data.
+ *
+ * @param[out] data SLIX dump to fill.
+ * @param device NfcDevice to read from.
+ * @return true if the device holds a SLIX-compatible dump, false otherwise.
+ */
+bool slix_load_from_device(SlixData* data, const NfcDevice* device);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,66 @@
+#include "slix_device.h"
+
+#include <nfc/protocols/slix/slix.h>
+#include <furi/furi.h>
+#include <string.h>
+
+void slix_device_set_data(
+    NfcDevice* device,
+    const Iso15693_3Data* iso15693_3_data,
+    const SlixDeviceNxpData* nxp_data) {
+    furi_assert(device);
+    furi_assert(iso15693_3_data);
+    furi_assert(nxp_data);
+
+    // Stack instance only: nfc_device_set_data() makes its own deep copy
+    SlixData slix_data = {
+        .iso15693_3_data = (Iso15693_3Data*)iso15693_3_data,
+        .system_info =
+            {
+                .protection =
+                    {
+                        .pointer = nxp_data->protection_pointer,
+                        .condition = nxp_data->protection_condition,
+                    },
+                .lock_bits =
+                    {
+                        .eas = nxp_data->lock_eas,
+                        .ppl = nxp_data->lock_ppl,
+                    },
+            },
+    };
+    if(nxp_data->signature_read) {
+        memcpy(slix_data.signature, nxp_data->signature, SLIX_DEVICE_SIGNATURE_SIZE);
+    }
+
+    nfc_device_set_data(device, NfcProtocolSlix, &slix_data);
+}
+
+const Iso15693_3Data* slix_device_get_data(const NfcDevice* device, SlixDeviceNxpData* nxp_data) {
+    furi_assert(device);
+    furi_assert(nxp_data);
+
+    memset(nxp_data, 0, sizeof(SlixDeviceNxpData));
+
+    NfcProtocol protocol = nfc_device_get_protocol(device);
+    if(protocol == NfcProtocolSlix) {
+        const SlixData* slix_data = nfc_device_get_data(device, NfcProtocolSlix);
+        nxp_data->protection_pointer = slix_data->system_info.protection.pointer;
+        nxp_data->protection_condition = slix_data->system_info.protection.condition;
+        nxp_data->lock_eas = slix_data->system_info.lock_bits.eas;
+        nxp_data->lock_ppl = slix_data->system_info.lock_bits.ppl;
+
+        // The file format has no "signature read" marker, an all-zero signature means none
+        memcpy(nxp_data->signature, slix_data->signature, SLIX_DEVICE_SIGNATURE_SIZE);
+        for(size_t i = 0; i < SLIX_DEVICE_SIGNATURE_SIZE; i++) {
+            if(nxp_data->signature[i]) {
+                nxp_data->signature_read = true;
+                break;
+            }
+        }
+    } else if(protocol != NfcProtocolIso15693_3) {
+        return NULL;
+    }
+
+    return nfc_device_get_data(device, NfcProtocolIso15693_3);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <nfc/nfc_device.h>
+#include <nfc/protocols/iso15693_3/iso15693_3.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLIX_DEVICE_SIGNATURE_SIZE (32U)
+
+/**
+ * @brief NXP-specific part of a SLIX card, as stored in a .nfc file.
+ *
+ * This header deliberately does not include slix.h: the firmware SLIX protocol
+ * uses the same type names, so only slix_device.c may see its definitions.
+ */
+typedef struct {
+    uint8_t protection_pointer;
+    uint8_t protection_condition;
+    bool lock_eas;
+    bool lock_ppl;
+    bool signature_read;
+    uint8_t signature[SLIX_DEVICE_SIGNATURE_SIZE];
+} SlixDeviceNxpData;
+
+/**
+ * @brief Store a SLIX card in an NfcDevice using the firmware SLIX protocol.
+ *
+ * @param device NfcDevice to fill, the data is copied.
+ * @param iso15693_3_data ISO15693-3 part of the card: UID, system info and memory.
+ * @param nxp_data NXP-specific part of the card.
+ */
+void slix_device_set_data(
+    NfcDevice* device,
+    const Iso15693_3Data* iso15693_3_data,
+    const SlixDeviceNxpData* nxp_data);
+
+/**
+ * @brief Get a SLIX card from an NfcDevice holding SLIX or plain ISO15693-3 data.
+ *
+ * @param device NfcDevice to read from.
+ * @param[out] nxp_data NXP-specific part of the card, zeroed for ISO15693-3 data.
+ * @return ISO15693-3 part owned by the device, or NULL for other protocols.
+ */
+const Iso15693_3Data* slix_device_get_data(const NfcDevice* device, SlixDeviceNxpData* nxp_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,6 +2,7 @@
 
 #include <nfc/protocols/iso15693_3/iso15693_3.h>
 #include <nfc/nfc_poller.h>
+#include <nfc/helpers/iso13239_crc.h>
 
 #define SLIX_POLLER_THREAD_FLAG_DETECTED (1U << 0)
 #define SLIX_WIPE_BLOCKS_TOTAL           (32)
@@ -18,6 +19,13 @@ typedef struct {
     SlixData* slix_data;
 } SlixPollerDetectContext;
 
+// Commands are addressed, a card powered up again answers them without a new inventory
+static const NfcMagicRetryPolicy slix_poller_retry_policy = {
+    .block_retries = 3,
+    .backoff_resets_min = 1,
+    .backoff_resets_max = 4,
+};
+
 static NfcCommand slix_poller_detect_callback(NfcEvent event, void* context) {
     furi_assert(context);
 
@@ -26,31 +34,32 @@ static NfcCommand slix_poller_detect_callback(NfcEvent event, void* context) {
 
     if(event.type == NfcEventTypePollerReady) {
         do {
-            // Build and send INVENTORY command
-            slix_build_inventory_request(slix_poller_detect_ctx->tx_buffer);
-
-            NfcError error = nfc_poller_trx(
+            // Anticollision stops at the first card, so a stack of labels is detected too
+            SlixData* slix_data = slix_poller_detect_ctx->slix_data;
+            size_t uids_found = slix_poller_inventory_all(
                 slix_poller_detect_ctx->nfc,
                 slix_poller_detect_ctx->tx_buffer,
                 slix_poller_detect_ctx->rx_buffer,
-                ISO15693_3_FDT_POLL_FC * 2); // A bit more than standard FWT
-
-            if(error != NfcErrorNone) {
-                FURI_LOG_D(TAG, "INVENTORY trx error: %d", error);
+                &slix_data->uid,
+                1);
+            if(uids_found == 0) {
+                FURI_LOG_D(TAG, "No card answered INVENTORY");
                 break;
             }
+            slix_poller_detect_ctx->detected = true;
 
-            // A valid INVENTORY response is 12 bytes (flags, dsfid, uid, crc)
-            // We check for a response of at least that size with no error flags.
-            if(bit_buffer_get_size_bytes(slix_poller_detect_ctx->rx_buffer) >= 12) {
-                uint8_t flags = bit_buffer_get_byte(slix_poller_detect_ctx->rx_buffer, 0);
-                if(!(flags & ISO15693_3_RESP_FLAG_ERROR)) {
-                    slix_poller_detect_ctx->detected = true;
-                    // The UID starts at the 3rd byte (index 2) of the INVENTORY response.
-                    const uint8_t* uid_lsb =
-                        &bit_buffer_get_data(slix_poller_detect_ctx->rx_buffer)[2];
-                    memcpy(slix_poller_detect_ctx->slix_data->uid, uid_lsb, SLIX_UID_LEN);
-                }
+            // Fetch system info while the card is still active, so get info, dump and
+            // wipe do not have to repeat it. A failure here is not a detect failure.
+            slix_build_system_info_request(slix_poller_detect_ctx->tx_buffer, slix_data->uid);
+            NfcError error = nfc_poller_trx(
+                slix_poller_detect_ctx->nfc,
+                slix_poller_detect_ctx->tx_buffer,
+                slix_poller_detect_ctx->rx_buffer,
+                SLIX_POLLER_MAX_FWT);
+            if(error != NfcErrorNone) break;
+            if(iso13239_crc_check(Iso13239CrcTypeDefault, slix_poller_detect_ctx->rx_buffer)) {
+                iso13239_crc_trim(slix_poller_detect_ctx->rx_buffer);
+                slix_parse_system_info_response(slix_data, slix_poller_detect_ctx->rx_buffer);
             }
 
         } while(false);
@@ -60,8 +69,11 @@ static NfcCommand slix_poller_detect_callback(NfcEvent event, void* context) {
     return command;
 }
 
-bool slix_poller_detect(Nfc* nfc, SlixData* slix_data) {
-    furi_assert(nfc);
+bool slix_poller_detect(NfcMagicDetectContext* detect_ctx, SlixData* slix_data) {
+    furi_assert(detect_ctx);
+
+    Nfc* nfc = detect_ctx->nfc;
+    nfc_magic_detect_context_reset(detect_ctx);
 
     nfc_config(nfc, NfcModePoller, NfcTechIso15693);
     nfc_set_guard_time_us(nfc, ISO15693_3_GUARD_TIME_US);
@@ -69,8 +81,8 @@ bool slix_poller_detect(Nfc* nfc, SlixData* slix_data) {
 
     SlixPollerDetectContext slix_poller_detect_ctx = {
         .nfc = nfc,
-        .tx_buffer = bit_buffer_alloc(SLIX_POLLER_MAX_BUFFER_SIZE),
-        .rx_buffer = bit_buffer_alloc(SLIX_POLLER_MAX_BUFFER_SIZE),
+        .tx_buffer = detect_ctx->tx_buffer,
+        .rx_buffer = detect_ctx->rx_buffer,
         .thread_id = furi_thread_get_current_id(),
         .detected = false,
         .slix_data = slix_data,
@@ -82,8 +94,9 @@ bool slix_poller_detect(Nfc* nfc, SlixData* slix_data) {
     furi_thread_flags_wait(SLIX_POLLER_THREAD_FLAG_DETECTED, FuriFlagWaitAny, 200);
     nfc_stop(nfc);
 
-    bit_buffer_free(slix_poller_detect_ctx.tx_buffer);
-    bit_buffer_free(slix_poller_detect_ctx.rx_buffer);
+    if(slix_poller_detect_ctx.detected) {
+        nfc_magic_fingerprint_set_slix(&detect_ctx->fingerprint, slix_data);
+    }
 
     return slix_poller_detect_ctx.detected;
 }
@@ -104,6 +117,7 @@ SlixPoller* slix_poller_alloc(Nfc* nfc) {
     instance->rx_buffer = bit_buffer_alloc(SLIX_POLLER_MAX_BUFFER_SIZE);
 
     instance->slix_event.data = &instance->slix_event_data;
+    nfc_magic_retry_init(&instance->retry, &slix_poller_retry_policy);
 
     return instance;
 }
@@ -120,12 +134,53 @@ void slix_poller_free(SlixPoller* instance) {
 
 typedef NfcCommand (*SlixPollerStateHandler)(SlixPoller* instance);
 
+static void slix_poller_reset_card_state(SlixPoller* instance) {
+    instance->current_block = 0;
+    instance->blocks_total = 0;
+    instance->memory_size_guessed = false;
+    instance->multi_read_unsupported = false;
+    instance->multi_write_unsupported = false;
+    slix_poller_prepare_headers(instance);
+}
+
+// Detection already fetched the system info of the scanned card
+static void slix_poller_apply_fingerprint(SlixPoller* instance) {
+    const NfcMagicFingerprint* fingerprint = instance->fingerprint;
+    SlixData* slix_data = instance->slix_data;
+
+    if((fingerprint != NULL) && fingerprint->slix_system_info_read &&
+       !slix_data->system_info_read &&
+       nfc_magic_fingerprint_is_uid_equal(fingerprint, slix_data->uid, SLIX_UID_LEN)) {
+        slix_data->iso15693_3_info = fingerprint->slix_system_info;
+        slix_data->system_info_read = true;
+    }
+}
+
+static void slix_poller_start_card(SlixPoller* instance) {
+    const uint8_t* uid = instance->uids[instance->uid_index];
+
+    // Data from detect only describes the scanned card, start from scratch for the others
+    if(memcmp(instance->slix_data->uid, uid, SLIX_UID_LEN) != 0) {
+        slix_reset(instance->slix_data);
+        memcpy(instance->slix_data->uid, uid, SLIX_UID_LEN);
+    }
+    slix_poller_apply_fingerprint(instance);
+    slix_poller_reset_card_state(instance);
+    instance->state = instance->card_state;
+}
+
 static NfcCommand slix_poller_idle_handler(SlixPoller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     // Card presence is assumed, as it was just detected by the scanner.
     // Immediately notify the scene and move to the next state.
-    instance->current_block = 0;
+    slix_poller_reset_card_state(instance);
+    instance->source_data = NULL;
+    instance->uids_total = 0;
+    instance->uid_index = 0;
+    instance->scanned_card_failed = false;
+    instance->others_failed = 0;
+    nfc_magic_retry_reset(&instance->retry);
     instance->slix_event.type = SlixPollerEventTypeCardDetected;
     command = instance->callback(instance->slix_event, instance->context);
     instance->state = SlixPollerStateRequestMode;
@@ -139,10 +194,20 @@ static NfcCommand slix_poller_request_mode_handler(SlixPoller* instance) {
     instance->slix_event.type = SlixPollerEventTypeRequestMode;
     command = instance->callback(instance->slix_event, instance->context);
 
+    // Wipe and get info run against every card in the field
     if(instance->slix_event_data.request_mode.mode == SlixPollerModeWipe) {
-        instance->state = SlixPollerStateWipe;
+        instance->card_state = SlixPollerStateWipe;
+        instance->state = SlixPollerStateInventory;
     } else if(instance->slix_event_data.request_mode.mode == SlixPollerModeGetInfo) {
-        instance->state = SlixPollerStateGetInfo;
+        instance->card_state = SlixPollerStateGetInfo;
+        instance->state = SlixPollerStateInventory;
+    } else if(instance->slix_event_data.request_mode.mode == SlixPollerModeDump) {
+        instance->slix_data->memory_blocks_read = 0;
+        slix_poller_apply_fingerprint(instance);
+        instance->state = SlixPollerStateDump;
+    } else if(instance->slix_event_data.request_mode.mode == SlixPollerModeWrite) {
+        slix_poller_apply_fingerprint(instance);
+        instance->state = SlixPollerStateRequestWriteData;
     } else {
         // Other modes not implemented yet
         instance->state = SlixPollerStateFail;
@@ -151,36 +216,74 @@ static NfcCommand slix_poller_request_mode_handler(SlixPoller* instance) {
     return command;
 }
 
-static NfcCommand slix_poller_get_info_handler(SlixPoller* instance) {
+static NfcCommand slix_poller_inventory_handler(SlixPoller* instance) {
     NfcCommand command = NfcCommandContinue;
-    SlixPollerError error = SlixPollerErrorNone;
 
-    do {
-        // 1. Get standard ISO15693-3 system info
-        error = slix_poller_get_system_info(instance);
-        if(error != SlixPollerErrorNone) {
-            FURI_LOG_E(TAG, "Failed to get ISO15693-3 system info: %d", error);
-            break;
+    size_t uids_total = slix_poller_inventory_all(
+        instance->nfc,
+        instance->tx_buffer,
+        instance->rx_buffer,
+        instance->uids,
+        SLIX_POLLER_UIDS_MAX);
+
+    if(uids_total == 0) {
+        FURI_LOG_E(TAG, "No card answered INVENTORY");
+        instance->state = SlixPollerStateFail;
+    } else {
+        FURI_LOG_D(TAG, "%zu card(s) in field", uids_total);
+        if(uids_total == SLIX_POLLER_UIDS_MAX) {
+            FURI_LOG_W(TAG, "Card limit reached, remaining cards are skipped");
         }
 
-        // 2. Select the card to prepare for addressed commands
-        error = slix_poller_select(instance);
-        if(error != SlixPollerErrorNone) {
-            FURI_LOG_E(TAG, "Failed to select card: %d", error);
-            break;
+        // Process the scanned card first, the fingerprint holds its UID and system info.
+        // Get info and wipe hand over no data, slix_data only names it for other callers.
+        const uint8_t* scanned_uid = instance->slix_data->uid;
+        if((instance->fingerprint != NULL) && (instance->fingerprint->uid_len == SLIX_UID_LEN)) {
+            scanned_uid = instance->fingerprint->uid;
+        }
+        for(size_t i = 1; i < uids_total; i++) {
+            if(memcmp(instance->uids[i], scanned_uid, SLIX_UID_LEN) == 0) {
+                uint8_t uid[SLIX_UID_LEN];
+                memcpy(uid, instance->uids[0], SLIX_UID_LEN);
+                memcpy(instance->uids[0], instance->uids[i], SLIX_UID_LEN);
+                memcpy(instance->uids[i], uid, SLIX_UID_LEN);
+                break;
+            }
+        }
+
+        instance->uids_total = uids_total;
+        instance->uid_index = 0;
+        slix_poller_start_card(instance);
+    }
+
+    return command;
+}
+
+static SlixPollerError slix_poller_read_info(SlixPoller* instance) {
+    SlixPollerError error = SlixPollerErrorNone;
+
+    do {
+        // 1. Get standard ISO15693-3 system info, unless detect already fetched it.
+        // All commands are addressed, so the card does not need to be selected.
+        if(!instance->slix_data->system_info_read) {
+            error = slix_poller_get_system_info(instance);
+            if(error != SlixPollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to get ISO15693-3 system info: %d", error);
+                break;
+            }
         }
 
-        // 3. Get NXP-specific system info
+        // 2. Get NXP-specific system info
         error = slix_poller_get_nxp_system_info(instance);
         if(error != SlixPollerErrorNone) {
             FURI_LOG_E(TAG, "Failed to get NXP system info: %d", error);
             break;
         }
 
-        // 4. Determine card type
+        // 3. Determine card type
         instance->slix_data->type = slix_get_type(instance->slix_data);
 
-        // 5. Read signature if supported (SLIX2)
+        // 4. Read signature if supported (SLIX2)
         if(instance->slix_data->type == SlixTypeSlix2) {
             error = slix_poller_read_signature(instance);
             if(error == SlixPollerErrorNone) {
@@ -194,60 +297,338 @@ static NfcCommand slix_poller_get_info_handler(SlixPoller* instance) {
         }
     } while(false);
 
+    return error;
+}
+
+static NfcCommand slix_poller_get_info_handler(SlixPoller* instance) {
+    NfcCommand command = NfcCommandContinue;
+
+    SlixPollerError error = slix_poller_read_info(instance);
     instance->state = (error == SlixPollerErrorNone) ? SlixPollerStateSuccess :
                                                        SlixPollerStateFail;
 
     return command;
 }
 
+static bool slix_poller_resolve_memory_size(SlixPoller* instance) {
+    Iso15693_3SystemInfo* info = &instance->slix_data->iso15693_3_info;
+
+    // Reuse the system info from detect or an earlier get info run if there was one
+    if(!instance->slix_data->system_info_read) {
+        if(slix_poller_get_system_info(instance) != SlixPollerErrorNone) {
+            FURI_LOG_W(TAG, "Failed to get system info");
+            return false;
+        }
+    }
+    if(!(info->flags & ISO15693_3_SYSINFO_FLAG_MEMORY)) {
+        FURI_LOG_W(TAG, "Card does not report its memory size");
+        return false;
+    }
+    if(info->block_size != SLIX_BLOCK_SIZE) {
+        FURI_LOG_W(TAG, "Unsupported block size: %d", info->block_size);
+        return false;
+    }
+
+    // The full count, wipe needs no buffer and dump checks it against SLIX_BLOCKS_MAX
+    instance->blocks_total = info->block_count;
+
+    return true;
+}
+
+static uint8_t slix_poller_get_chunk_size(SlixPoller* instance, bool multi_block_unsupported) {
+    uint16_t blocks_left = instance->blocks_total - instance->current_block;
+
+    return multi_block_unsupported ? 1 : MIN(blocks_left, SLIX_POLLER_MULTI_BLOCKS_MAX);
+}
+
+// Timeouts and damaged frames get another go at the block once the field was off for a while
+static bool slix_poller_schedule_retry(SlixPoller* instance, SlixPollerError error) {
+    bool is_transient =
+        (error == SlixPollerErrorTimeout) || (error == SlixPollerErrorCommunication);
+    bool scheduled = is_transient && nfc_magic_retry_schedule(&instance->retry);
+
+    if(scheduled) {
+        FURI_LOG_D(TAG, "Retrying block %d", instance->current_block);
+    } else {
+        nfc_magic_retry_end_block(&instance->retry, false);
+    }
+
+    return scheduled;
+}
+
+static NfcCommand slix_poller_notify_retry(SlixPoller* instance) {
+    instance->slix_event.type = SlixPollerEventTypeRetry;
+    instance->slix_event_data.retry.block = instance->current_block;
+    instance->slix_event_data.retry.stats = instance->retry.stats;
+
+    return instance->callback(instance->slix_event, instance->context);
+}
+
 static NfcCommand slix_poller_wipe_handler(SlixPoller* instance) {
     NfcCommand command = NfcCommandContinue;
 
-    if(instance->current_block >= SLIX_WIPE_BLOCKS_TOTAL) {
-        instance->state = SlixPollerStateSuccess;
-    } else {
-        do {
-            const uint8_t zero_block[SLIX_BLOCK_SIZE] = {0};
-            SlixPollerError error =
-                slix_poller_write_block(instance, instance->current_block, zero_block);
+    do {
+        if(instance->blocks_total == 0 && !slix_poller_resolve_memory_size(instance)) {
+            FURI_LOG_W(TAG, "Memory size unknown, wiping up to %d blocks", SLIX_WIPE_BLOCKS_TOTAL);
+            instance->blocks_total = SLIX_WIPE_BLOCKS_TOTAL;
+            instance->memory_size_guessed = true;
+        }
+        if(instance->current_block >= instance->blocks_total) {
+            instance->state = SlixPollerStateSuccess;
+            break;
+        }
+
+        static const uint8_t zero_blocks[SLIX_POLLER_MULTI_BLOCKS_MAX * SLIX_BLOCK_SIZE] = {0};
+        uint8_t block_count =
+            slix_poller_get_chunk_size(instance, instance->multi_write_unsupported);
 
+        if(block_count > 1) {
+            SlixPollerError error = slix_poller_write_multiple_blocks(
+                instance, instance->current_block, block_count, zero_blocks);
             if(error != SlixPollerErrorNone) {
-                // Some SLIX cards have fewer than 32 blocks.
-                // Writing to a non-existent block will cause a protocol error.
-                // We can treat this as success and finish wiping.
-                FURI_LOG_W(
+                // WRITE MULTIPLE BLOCKS is optional, redo this chunk one block at a time
+                FURI_LOG_D(TAG, "Write multiple blocks failed, using single block writes");
+                instance->multi_write_unsupported = true;
+                break;
+            }
+        } else {
+            SlixPollerError error =
+                slix_poller_write_block(instance, instance->current_block, zero_blocks);
+            if(error != SlixPollerErrorNone) {
+                if(instance->memory_size_guessed) {
+                    // Without a known memory size the first failing block marks its end
+                    FURI_LOG_W(
+                        TAG,
+                        "Wipe failed on block %d, assuming end of memory",
+                        instance->current_block);
+                    instance->state = SlixPollerStateSuccess;
+                } else if(slix_poller_schedule_retry(instance, error)) {
+                    command = slix_poller_notify_retry(instance);
+                } else {
+                    FURI_LOG_E(TAG, "Wipe failed on block %d", instance->current_block);
+                    instance->state = SlixPollerStateFail;
+                }
+                break;
+            }
+        }
+        instance->current_block += block_count;
+        nfc_magic_retry_end_block(&instance->retry, true);
+    } while(false);
+
+    return command;
+}
+
+static NfcCommand slix_poller_dump_handler(SlixPoller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    SlixData* slix_data = instance->slix_data;
+
+    do {
+        if(instance->blocks_total == 0) {
+            // System info, NXP info and signature go into the dump alongside the memory
+            SlixPollerError error = slix_poller_read_info(instance);
+            if(error != SlixPollerErrorNone || !slix_poller_resolve_memory_size(instance)) {
+                instance->state = SlixPollerStateFail;
+                break;
+            }
+            // A partial dump would load and write back as if it were the whole card
+            if(instance->blocks_total > SLIX_BLOCKS_MAX) {
+                FURI_LOG_E(
                     TAG,
-                    "Wipe failed on block %d, assuming end of memory",
-                    instance->current_block);
-                instance->state = SlixPollerStateSuccess;
+                    "Card has %d blocks, dump holds %d",
+                    instance->blocks_total,
+                    SLIX_BLOCKS_MAX);
+                instance->state = SlixPollerStateFail;
                 break;
             }
-            instance->current_block++;
-        } while(false);
+        }
+        if(instance->current_block >= instance->blocks_total) {
+            instance->state = SlixPollerStateSuccess;
+            break;
+        }
+
+        uint8_t block_count =
+            slix_poller_get_chunk_size(instance, instance->multi_read_unsupported);
+        SlixPollerError error = slix_poller_read_multiple_blocks(
+            instance,
+            instance->current_block,
+            block_count,
+            &slix_data->memory[instance->current_block * SLIX_BLOCK_SIZE]);
+
+        if(error != SlixPollerErrorNone) {
+            if(block_count > 1) {
+                // Redo this chunk one block at a time
+                FURI_LOG_D(TAG, "Read multiple blocks failed, using single block reads");
+                instance->multi_read_unsupported = true;
+            } else if(slix_poller_schedule_retry(instance, error)) {
+                command = slix_poller_notify_retry(instance);
+            } else {
+                FURI_LOG_E(TAG, "Read failed on block %d", instance->current_block);
+                instance->state = SlixPollerStateFail;
+            }
+            break;
+        }
+        instance->current_block += block_count;
+        slix_data->memory_blocks_read = instance->current_block;
+        nfc_magic_retry_end_block(&instance->retry, true);
+    } while(false);
+
+    return command;
+}
+
+static NfcCommand slix_poller_request_write_data_handler(SlixPoller* instance) {
+    NfcCommand command = NfcCommandContinue;
+
+    instance->slix_event.type = SlixPollerEventTypeRequestDataToWrite;
+    instance->slix_event_data.data_to_write.slix_data = NULL;
+    command = instance->callback(instance->slix_event, instance->context);
+    instance->source_data = instance->slix_event_data.data_to_write.slix_data;
+
+    do {
+        if(instance->source_data == NULL || instance->source_data->memory_blocks_read == 0) {
+            FURI_LOG_E(TAG, "No data to write");
+            instance->state = SlixPollerStateFail;
+            break;
+        }
+        if(!slix_poller_resolve_memory_size(instance)) {
+            instance->state = SlixPollerStateFail;
+            break;
+        }
+        if(instance->source_data->memory_blocks_read > instance->blocks_total) {
+            FURI_LOG_E(
+                TAG,
+                "Source has %d blocks, target only %d",
+                instance->source_data->memory_blocks_read,
+                instance->blocks_total);
+            instance->state = SlixPollerStateFail;
+            break;
+        }
+        instance->blocks_total = instance->source_data->memory_blocks_read;
+        instance->state = SlixPollerStateWrite;
+    } while(false);
+
+    return command;
+}
+
+static SlixPollerError slix_poller_write_settings(SlixPoller* instance) {
+    SlixPollerError error = SlixPollerErrorNone;
+    const Iso15693_3SystemInfo* source_info = &instance->source_data->iso15693_3_info;
+    const Iso15693_3SystemInfo* target_info = &instance->slix_data->iso15693_3_info;
+
+    // Only touch AFI and DSFID when they differ, so locked but matching values are not an error
+    if((source_info->flags & ISO15693_3_SYSINFO_FLAG_AFI) &&
+       (source_info->afi != target_info->afi)) {
+        error =
+            slix_poller_write_system_byte(instance, ISO15693_3_CMD_WRITE_AFI, source_info->afi);
+    }
+    if((error == SlixPollerErrorNone) && (source_info->flags & ISO15693_3_SYSINFO_FLAG_DSFID) &&
+       (source_info->dsfid != target_info->dsfid)) {
+        error = slix_poller_write_system_byte(
+            instance, ISO15693_3_CMD_WRITE_DSFID, source_info->dsfid);
     }
 
+    return error;
+}
+
+static NfcCommand slix_poller_write_handler(SlixPoller* instance) {
+    NfcCommand command = NfcCommandContinue;
+
+    do {
+        if(instance->current_block >= instance->blocks_total) {
+            SlixPollerError error = slix_poller_write_settings(instance);
+            if(error != SlixPollerErrorNone) {
+                FURI_LOG_E(TAG, "Failed to write AFI/DSFID: %d", error);
+            }
+            instance->state = (error == SlixPollerErrorNone) ? SlixPollerStateSuccess :
+                                                               SlixPollerStateFail;
+            break;
+        }
+
+        const uint8_t* data =
+            &instance->source_data->memory[instance->current_block * SLIX_BLOCK_SIZE];
+        uint8_t block_count =
+            slix_poller_get_chunk_size(instance, instance->multi_write_unsupported);
+        SlixPollerError error = SlixPollerErrorNone;
+        if(block_count > 1) {
+            error = slix_poller_write_multiple_blocks(
+                instance, instance->current_block, block_count, data);
+        } else {
+            error = slix_poller_write_block(instance, instance->current_block, data);
+        }
+
+        if(error != SlixPollerErrorNone) {
+            if(block_count > 1) {
+                // Redo this chunk one block at a time
+                FURI_LOG_D(TAG, "Write multiple blocks failed, using single block writes");
+                instance->multi_write_unsupported = true;
+            } else if(slix_poller_schedule_retry(instance, error)) {
+                command = slix_poller_notify_retry(instance);
+            } else {
+                FURI_LOG_E(TAG, "Write failed on block %d", instance->current_block);
+                instance->state = SlixPollerStateFail;
+            }
+            break;
+        }
+        instance->current_block += block_count;
+        nfc_magic_retry_end_block(&instance->retry, true);
+    } while(false);
+
     return command;
 }
 
-static NfcCommand slix_poller_success_handler(SlixPoller* instance) {
-    instance->slix_event.type = SlixPollerEventTypeSuccess;
-    NfcCommand command = instance->callback(instance->slix_event, instance->context);
+static NfcCommand slix_poller_finish_card(SlixPoller* instance, bool success) {
+    NfcCommand command = NfcCommandContinue;
+
+    // A non-NXP tag lying next to the target must not fail the whole operation
+    if(!success && (instance->uid_index == 0)) {
+        instance->scanned_card_failed = true;
+    } else if(!success) {
+        instance->others_failed++;
+    }
+
+    if(instance->uids_total > 0) {
+        instance->slix_event.type = SlixPollerEventTypeCardDone;
+        instance->slix_event_data.card_done.card_index = instance->uid_index;
+        instance->slix_event_data.card_done.cards_total = instance->uids_total;
+        instance->slix_event_data.card_done.success = success;
+        command = instance->callback(instance->slix_event, instance->context);
+
+        instance->uid_index++;
+        if(command == NfcCommandContinue && instance->uid_index < instance->uids_total) {
+            slix_poller_start_card(instance);
+            return command;
+        }
+    }
+
+    if(instance->others_failed > 0) {
+        FURI_LOG_W(TAG, "%d other card(s) failed", instance->others_failed);
+    }
+    instance->slix_event.type = instance->scanned_card_failed ? SlixPollerEventTypeFail :
+                                                                SlixPollerEventTypeSuccess;
+    instance->slix_event_data.result.cards_total = MAX(instance->uids_total, 1);
+    instance->slix_event_data.result.others_failed = instance->others_failed;
+    command = instance->callback(instance->slix_event, instance->context);
     instance->state = SlixPollerStateIdle;
+
     return command;
 }
 
+static NfcCommand slix_poller_success_handler(SlixPoller* instance) {
+    return slix_poller_finish_card(instance, true);
+}
+
 static NfcCommand slix_poller_fail_handler(SlixPoller* instance) {
-    instance->slix_event.type = SlixPollerEventTypeFail;
-    NfcCommand command = instance->callback(instance->slix_event, instance->context);
-    instance->state = SlixPollerStateIdle;
-    return command;
+    return slix_poller_finish_card(instance, false);
 }
 
 static const SlixPollerStateHandler slix_poller_state_handlers[SlixPollerStateNum] = {
     [SlixPollerStateIdle] = slix_poller_idle_handler,
     [SlixPollerStateRequestMode] = slix_poller_request_mode_handler,
+    [SlixPollerStateInventory] = slix_poller_inventory_handler,
     [SlixPollerStateWipe] = slix_poller_wipe_handler,
     [SlixPollerStateGetInfo] = slix_poller_get_info_handler,
+    [SlixPollerStateDump] = slix_poller_dump_handler,
+    [SlixPollerStateRequestWriteData] = slix_poller_request_write_data_handler,
+    [SlixPollerStateWrite] = slix_poller_write_handler,
     [SlixPollerStateSuccess] = slix_poller_success_handler,
     [SlixPollerStateFail] = slix_poller_fail_handler,
 };
@@ -258,7 +639,12 @@ static NfcCommand slix_poller_run(NfcEvent event, void* context) {
     NfcCommand command = NfcCommandContinue;
 
     if(event.type == NfcEventTypePollerReady) {
-        command = slix_poller_state_handlers[instance->state](instance);
+        if(nfc_magic_retry_backoff(&instance->retry)) {
+            // Keep the card powered down, the block is retried once it is back up
+            command = NfcCommandReset;
+        } else {
+            command = slix_poller_state_handlers[instance->state](instance);
+        }
     }
 
     return command;
@@ -287,6 +673,17 @@ void slix_poller_set_data(SlixPoller* instance, const SlixData* data) {
     slix_copy(instance->slix_data, data);
 }
 
+void slix_poller_set_fingerprint(SlixPoller* instance, const NfcMagicFingerprint* fingerprint) {
+    furi_assert(instance);
+    instance->fingerprint = fingerprint;
+}
+
+void slix_poller_set_retry_policy(SlixPoller* instance, const NfcMagicRetryPolicy* policy) {
+    furi_assert(instance);
+    furi_assert(policy);
+    nfc_magic_retry_init(&instance->retry, policy);
+}
+
 const SlixData* slix_poller_get_data(const SlixPoller* instance) {
     furi_assert(instance);
     return instance->slix_data;
@@ -3,6 +3,8 @@
 #include <nfc/nfc.h>
 #include <nfc/protocols/nfc_generic_event.h>
 #include "slix.h"
+#include "../nfc_magic_detect.h"
+#include "../nfc_magic_retry.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -11,7 +13,9 @@ extern "C" {
 typedef enum {
     SlixPollerEventTypeCardDetected,
     SlixPollerEventTypeRequestMode,
-    // Add other events like RequestDataToWrite here
+    SlixPollerEventTypeRequestDataToWrite,
+    SlixPollerEventTypeCardDone,
+    SlixPollerEventTypeRetry,
     SlixPollerEventTypeSuccess,
     SlixPollerEventTypeFail,
 } SlixPollerEventType;
@@ -19,18 +23,41 @@ typedef enum {
 typedef enum {
     SlixPollerModeWipe,
     SlixPollerModeGetInfo,
-    // Add other modes like Write here
+    SlixPollerModeDump,
+    SlixPollerModeWrite,
 } SlixPollerMode;
 
 typedef struct {
     SlixPollerMode mode;
 } SlixPollerEventDataRequestMode;
 
-// Add other event data structs here
+typedef struct {
+    const SlixData* slix_data;
+} SlixPollerEventDataRequestDataToWrite;
+
+typedef struct {
+    uint8_t card_index;
+    uint8_t cards_total;
+    bool success;
+} SlixPollerEventDataCardDone;
+
+typedef struct {
+    uint16_t block;
+    NfcMagicRetryStats stats;
+} SlixPollerEventDataRetry;
+
+// Success and fail only tell about the scanned card, the other cards are counted here
+typedef struct {
+    uint8_t cards_total;
+    uint8_t others_failed;
+} SlixPollerEventDataResult;
 
 typedef union {
     SlixPollerEventDataRequestMode request_mode;
-    // Add other event data unions here
+    SlixPollerEventDataRequestDataToWrite data_to_write;
+    SlixPollerEventDataCardDone card_done;
+    SlixPollerEventDataRetry retry;
+    SlixPollerEventDataResult result;
 } SlixPollerEventData;
 
 typedef struct {
@@ -45,11 +72,11 @@ typedef struct SlixPoller SlixPoller;
 /**
  * @brief Detect a SLIX (ISO15693) magic card.
  *
- * @param nfc Nfc instance.
+ * @param detect_ctx Detect context lent by the scanner.
  * @param[out] slix_data A pointer to the SlixData instance to be filled.
  * @return true if a SLIX card was detected, false otherwise.
  */
-bool slix_poller_detect(Nfc* nfc, SlixData* slix_data);
+bool slix_poller_detect(NfcMagicDetectContext* detect_ctx, SlixData* slix_data);
 
 SlixPoller* slix_poller_alloc(Nfc* nfc);
 
@@ -61,6 +88,17 @@ void slix_poller_stop(SlixPoller* instance);
 
 void slix_poller_set_data(SlixPoller* instance, const SlixData* data);
 
+/**
+ * @brief Hand over what the scanner learned about the card.
+ *
+ * The system info it holds is used instead of asking the card again, for the
+ * card with the same UID only.
+ */
+void slix_poller_set_fingerprint(SlixPoller* instance, const NfcMagicFingerprint* fingerprint);
+
+// Replaces the built-in retry budget, the policy must outlive the poller
+void slix_poller_set_retry_policy(SlixPoller* instance, const NfcMagicRetryPolicy* policy);
+
 const SlixData* slix_poller_get_data(const SlixPoller* instance);
 
 #ifdef __cplusplus
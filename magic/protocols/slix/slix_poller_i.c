@@ -7,6 +7,11 @@
 
 #define TAG "SlixPoller"
 
+#define SLIX_POLLER_COMMAND_INDEX (1U)
+
+// ISO15693 custom command range, these carry the manufacturer code
+#define SLIX_POLLER_CUSTOM_CMD_START (0xA0U)
+
 static SlixPollerError slix_poller_process_nfc_error(NfcError error) {
     SlixPollerError ret = SlixPollerErrorNone;
 
@@ -19,36 +24,48 @@ static SlixPollerError slix_poller_process_nfc_error(NfcError error) {
         break;
     default:
         // Covers other NfcError types like communication errors
-        ret = SlixPollerErrorProtocol;
+        ret = SlixPollerErrorCommunication;
         break;
     }
 
     return ret;
 }
 
-SlixPollerError
-    slix_poller_write_block(SlixPoller* instance, uint8_t block_num, const uint8_t* data) {
+void slix_poller_prepare_headers(SlixPoller* instance) {
     furi_assert(instance);
-    bit_buffer_reset(instance->tx_buffer);
 
     // Flags: Addressed, High data rate
-    uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI |
-                    ISO15693_3_REQ_FLAG_T4_ADDRESSED;
-    bit_buffer_append_byte(instance->tx_buffer, flags);
-    // Command
-    bit_buffer_append_byte(instance->tx_buffer, ISO15693_3_CMD_WRITE_BLOCK);
-    // UID
-    bit_buffer_append_bytes(instance->tx_buffer, instance->slix_data->uid, SLIX_UID_LEN);
-    // Block number
-    bit_buffer_append_byte(instance->tx_buffer, block_num);
-    // Data
-    bit_buffer_append_bytes(instance->tx_buffer, data, SLIX_BLOCK_SIZE);
-    // Append CRC
+    const uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI |
+                          ISO15693_3_REQ_FLAG_T4_ADDRESSED;
+
+    // flags(1) + command(1) + UID(8), command is patched in per request
+    instance->iso_header[0] = flags;
+    instance->iso_header[SLIX_POLLER_COMMAND_INDEX] = 0;
+    memcpy(&instance->iso_header[2], instance->slix_data->uid, SLIX_UID_LEN);
+
+    // flags(1) + command(1) + manufacturer code(1) + UID(8)
+    instance->nxp_header[0] = flags;
+    instance->nxp_header[SLIX_POLLER_COMMAND_INDEX] = 0;
+    instance->nxp_header[2] = SLIX_NXP_MANUFACTURER_CODE;
+    memcpy(&instance->nxp_header[3], instance->slix_data->uid, SLIX_UID_LEN);
+}
+
+static void slix_poller_begin_request(SlixPoller* instance, uint8_t command) {
+    // NXP custom commands carry the manufacturer code between command and UID
+    if(command >= SLIX_POLLER_CUSTOM_CMD_START) {
+        bit_buffer_copy_bytes(
+            instance->tx_buffer, instance->nxp_header, SLIX_POLLER_NXP_HEADER_SIZE);
+    } else {
+        bit_buffer_copy_bytes(
+            instance->tx_buffer, instance->iso_header, SLIX_POLLER_ISO_HEADER_SIZE);
+    }
+    bit_buffer_set_byte(instance->tx_buffer, SLIX_POLLER_COMMAND_INDEX, command);
+}
+
+static SlixPollerError slix_poller_send_request(SlixPoller* instance, uint32_t fwt) {
     iso13239_crc_append(Iso13239CrcTypeDefault, instance->tx_buffer);
 
-    // Send request
-    NfcError error = nfc_poller_trx(
-        instance->nfc, instance->tx_buffer, instance->rx_buffer, SLIX_POLLER_MAX_FWT);
+    NfcError error = nfc_poller_trx(instance->nfc, instance->tx_buffer, instance->rx_buffer, fwt);
 
     SlixPollerError slix_error = slix_poller_process_nfc_error(error);
 
@@ -56,69 +73,73 @@ SlixPollerError
         // Check for card-level error response
         if(iso13239_crc_check(Iso13239CrcTypeDefault, instance->rx_buffer)) {
             iso13239_crc_trim(instance->rx_buffer);
-            uint8_t resp_flags = bit_buffer_get_byte(instance->rx_buffer, 0);
-            if(resp_flags & ISO15693_3_RESP_FLAG_ERROR) {
+            if(bit_buffer_get_size_bytes(instance->rx_buffer) == 0 ||
+               (bit_buffer_get_byte(instance->rx_buffer, 0) & ISO15693_3_RESP_FLAG_ERROR)) {
                 slix_error = SlixPollerErrorProtocol;
             }
         } else {
-            slix_error = SlixPollerErrorProtocol;
+            slix_error = SlixPollerErrorCommunication;
         }
     }
 
     return slix_error;
 }
 
-SlixPollerError slix_poller_get_nxp_system_info(SlixPoller* instance) {
+SlixPollerError
+    slix_poller_write_block(SlixPoller* instance, uint8_t block_num, const uint8_t* data) {
     furi_assert(instance);
-    bit_buffer_reset(instance->tx_buffer);
 
-    // Flags: Addressed, High data rate
-    uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI |
-                    ISO15693_3_REQ_FLAG_T4_ADDRESSED;
-    bit_buffer_append_byte(instance->tx_buffer, flags);
-    // Command
-    bit_buffer_append_byte(instance->tx_buffer, SLIX_CMD_GET_NXP_SYSTEM_INFORMATION);
-    // Manufacturer code for NXP
-    bit_buffer_append_byte(instance->tx_buffer, SLIX_NXP_MANUFACTURER_CODE);
-    // UID
-    bit_buffer_append_bytes(instance->tx_buffer, instance->slix_data->uid, SLIX_UID_LEN);
-    // Append CRC
-    iso13239_crc_append(Iso13239CrcTypeDefault, instance->tx_buffer);
+    slix_poller_begin_request(instance, ISO15693_3_CMD_WRITE_BLOCK);
+    bit_buffer_append_byte(instance->tx_buffer, block_num);
+    bit_buffer_append_bytes(instance->tx_buffer, data, SLIX_BLOCK_SIZE);
+
+    return slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT);
+}
 
-    // Send request
-    NfcError error = nfc_poller_trx(
-        instance->nfc, instance->tx_buffer, instance->rx_buffer, SLIX_POLLER_MAX_FWT);
+SlixPollerError slix_poller_write_multiple_blocks(
+    SlixPoller* instance,
+    uint8_t first_block,
+    uint8_t block_count,
+    const uint8_t* data) {
+    furi_assert(instance);
+    furi_assert(block_count > 0 && block_count <= SLIX_POLLER_MULTI_BLOCKS_MAX);
 
-    SlixPollerError slix_error = slix_poller_process_nfc_error(error);
+    slix_poller_begin_request(instance, ISO15693_3_CMD_WRITE_MULTI_BLOCKS);
+    // First block number and number of blocks (encoded as count - 1)
+    bit_buffer_append_byte(instance->tx_buffer, first_block);
+    bit_buffer_append_byte(instance->tx_buffer, block_count - 1);
+    bit_buffer_append_bytes(instance->tx_buffer, data, block_count * SLIX_BLOCK_SIZE);
 
-    if(slix_error == SlixPollerErrorNone) {
-        if(iso13239_crc_check(Iso13239CrcTypeDefault, instance->rx_buffer)) {
-            iso13239_crc_trim(instance->rx_buffer);
+    // Every block is programmed before the card answers
+    return slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT * block_count);
+}
 
-            // Response format: flags(1) + data(8)
-            if(bit_buffer_get_size_bytes(instance->rx_buffer) == 9) {
-                const uint8_t* resp_data = bit_buffer_get_data(instance->rx_buffer);
-                if(resp_data[0] & ISO15693_3_RESP_FLAG_ERROR) {
-                    slix_error = SlixPollerErrorProtocol;
-                } else {
-                    // Parse response
-                    instance->slix_data->slix_info.protection_pointer = resp_data[1];
-                    instance->slix_data->slix_info.protection_condition = resp_data[2];
-
-                    uint8_t lock_bits = resp_data[3];
-                    instance->slix_data->iso15693_3_settings.lock_bits.afi =
-                        (lock_bits & (1U << 0));
-                    instance->slix_data->slix_info.lock_eas = (lock_bits & (1U << 1));
-                    instance->slix_data->iso15693_3_settings.lock_bits.dsfid =
-                        (lock_bits & (1U << 2));
-                    instance->slix_data->slix_info.lock_ppl = (lock_bits & (1U << 3));
-
-                    instance->slix_data->slix_info.feature_flags =
-                        bit_lib_bytes_to_num_le(&resp_data[4], 4);
-                }
-            } else {
-                slix_error = SlixPollerErrorProtocol;
-            }
+SlixPollerError slix_poller_read_multiple_blocks(
+    SlixPoller* instance,
+    uint8_t first_block,
+    uint8_t block_count,
+    uint8_t* data) {
+    furi_assert(instance);
+    furi_assert(data);
+    furi_assert(block_count > 0 && block_count <= SLIX_POLLER_MULTI_BLOCKS_MAX);
+
+    // A single block read is sent as READ BLOCK for cards without multi-read
+    if(block_count == 1) {
+        slix_poller_begin_request(instance, ISO15693_3_CMD_READ_BLOCK);
+        bit_buffer_append_byte(instance->tx_buffer, first_block);
+    } else {
+        slix_poller_begin_request(instance, ISO15693_3_CMD_READ_MULTI_BLOCKS);
+        bit_buffer_append_byte(instance->tx_buffer, first_block);
+        bit_buffer_append_byte(instance->tx_buffer, block_count - 1);
+    }
+
+    SlixPollerError slix_error = slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT);
+
+    if(slix_error == SlixPollerErrorNone) {
+        // Response format: flags(1) + data(block_count * block size)
+        const size_t data_size = block_count * SLIX_BLOCK_SIZE;
+        if(bit_buffer_get_size_bytes(instance->rx_buffer) == 1 + data_size) {
+            memcpy(data, &bit_buffer_get_data(instance->rx_buffer)[1], data_size);
         } else {
             slix_error = SlixPollerErrorProtocol;
         }
@@ -127,57 +148,40 @@ SlixPollerError slix_poller_get_nxp_system_info(SlixPoller* instance) {
     return slix_error;
 }
 
-SlixPollerError slix_poller_get_system_info(SlixPoller* instance) {
+SlixPollerError
+    slix_poller_write_system_byte(SlixPoller* instance, uint8_t command, uint8_t value) {
     furi_assert(instance);
-    bit_buffer_reset(instance->tx_buffer);
-
-    // Flags: High data rate. Unaddressed command.
-    uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI;
-    bit_buffer_append_byte(instance->tx_buffer, flags);
-    // Command
-    bit_buffer_append_byte(instance->tx_buffer, ISO15693_3_CMD_GET_SYS_INFO);
-    // Append CRC
-    iso13239_crc_append(Iso13239CrcTypeDefault, instance->tx_buffer);
+    furi_assert(command == ISO15693_3_CMD_WRITE_AFI || command == ISO15693_3_CMD_WRITE_DSFID);
 
-    // Send request
-    NfcError error = nfc_poller_trx(
-        instance->nfc, instance->tx_buffer, instance->rx_buffer, SLIX_POLLER_MAX_FWT);
+    slix_poller_begin_request(instance, command);
+    // AFI or DSFID value
+    bit_buffer_append_byte(instance->tx_buffer, value);
 
-    SlixPollerError slix_error = slix_poller_process_nfc_error(error);
+    return slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT);
+}
 
-    if(slix_error == SlixPollerErrorNone) {
-        if(iso13239_crc_check(Iso13239CrcTypeDefault, instance->rx_buffer)) {
-            iso13239_crc_trim(instance->rx_buffer);
+SlixPollerError slix_poller_get_nxp_system_info(SlixPoller* instance) {
+    furi_assert(instance);
 
-            // Response format: flags(1) + info_flags(1) + uid(8) + optional_data(...)
-            const size_t min_resp_size = 1 + 1 + SLIX_UID_LEN;
-            if(bit_buffer_get_size_bytes(instance->rx_buffer) >= min_resp_size) {
-                const uint8_t* resp_data = bit_buffer_get_data(instance->rx_buffer);
-                if(resp_data[0] & ISO15693_3_RESP_FLAG_ERROR) {
-                    slix_error = SlixPollerErrorProtocol;
-                } else {
-                    // Parse response
-                    Iso15693_3SystemInfo* info = &instance->slix_data->iso15693_3_info;
-                    info->flags = resp_data[1];
-                    const uint8_t* extra_data = &resp_data[1 + 1 + SLIX_UID_LEN];
-
-                    if(info->flags & ISO15693_3_SYSINFO_FLAG_DSFID) {
-                        info->dsfid = *extra_data++;
-                    }
-                    if(info->flags & ISO15693_3_SYSINFO_FLAG_AFI) {
-                        info->afi = *extra_data++;
-                    }
-                    if(info->flags & ISO15693_3_SYSINFO_FLAG_MEMORY) {
-                        info->block_count = *extra_data++ + 1;
-                        info->block_size = (*extra_data++ & 0x1F) + 1;
-                    }
-                    if(info->flags & ISO15693_3_SYSINFO_FLAG_IC_REF) {
-                        info->ic_ref = *extra_data++;
-                    }
-                }
-            } else {
-                slix_error = SlixPollerErrorProtocol;
-            }
+    slix_poller_begin_request(instance, SLIX_CMD_GET_NXP_SYSTEM_INFORMATION);
+
+    SlixPollerError slix_error = slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT);
+
+    if(slix_error == SlixPollerErrorNone) {
+        // Response format: flags(1) + data(8)
+        if(bit_buffer_get_size_bytes(instance->rx_buffer) == 9) {
+            const uint8_t* resp_data = bit_buffer_get_data(instance->rx_buffer);
+            instance->slix_data->slix_info.protection_pointer = resp_data[1];
+            instance->slix_data->slix_info.protection_condition = resp_data[2];
+
+            uint8_t lock_bits = resp_data[3];
+            instance->slix_data->iso15693_3_settings.lock_bits.afi = (lock_bits & (1U << 0));
+            instance->slix_data->slix_info.lock_eas = (lock_bits & (1U << 1));
+            instance->slix_data->iso15693_3_settings.lock_bits.dsfid = (lock_bits & (1U << 2));
+            instance->slix_data->slix_info.lock_ppl = (lock_bits & (1U << 3));
+
+            instance->slix_data->slix_info.feature_flags =
+                bit_lib_bytes_to_num_le(&resp_data[4], 4);
         } else {
             slix_error = SlixPollerErrorProtocol;
         }
@@ -186,40 +190,15 @@ SlixPollerError slix_poller_get_system_info(SlixPoller* instance) {
     return slix_error;
 }
 
-SlixPollerError slix_poller_select(SlixPoller* instance) {
+SlixPollerError slix_poller_get_system_info(SlixPoller* instance) {
     furi_assert(instance);
-    bit_buffer_reset(instance->tx_buffer);
 
-    // Flags: Addressed, High data rate
-    uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI |
-                    ISO15693_3_REQ_FLAG_T4_ADDRESSED;
-    bit_buffer_append_byte(instance->tx_buffer, flags);
-    // Command
-    bit_buffer_append_byte(instance->tx_buffer, ISO15693_3_CMD_SELECT);
-    // UID
-    bit_buffer_append_bytes(instance->tx_buffer, instance->slix_data->uid, SLIX_UID_LEN);
-    // Append CRC
-    iso13239_crc_append(Iso13239CrcTypeDefault, instance->tx_buffer);
+    slix_poller_begin_request(instance, ISO15693_3_CMD_GET_SYS_INFO);
 
-    // Send request
-    NfcError error = nfc_poller_trx(
-        instance->nfc, instance->tx_buffer, instance->rx_buffer, SLIX_POLLER_MAX_FWT);
-
-    SlixPollerError slix_error = slix_poller_process_nfc_error(error);
+    SlixPollerError slix_error = slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT);
 
     if(slix_error == SlixPollerErrorNone) {
-        if(iso13239_crc_check(Iso13239CrcTypeDefault, instance->rx_buffer)) {
-            iso13239_crc_trim(instance->rx_buffer);
-            // Response should be 1 byte (flags)
-            if(bit_buffer_get_size_bytes(instance->rx_buffer) == 1) {
-                uint8_t resp_flags = bit_buffer_get_byte(instance->rx_buffer, 0);
-                if(resp_flags & ISO15693_3_RESP_FLAG_ERROR) {
-                    slix_error = SlixPollerErrorProtocol;
-                }
-            } else {
-                slix_error = SlixPollerErrorProtocol;
-            }
-        } else {
+        if(!slix_parse_system_info_response(instance->slix_data, instance->rx_buffer)) {
             slix_error = SlixPollerErrorProtocol;
         }
     }
@@ -229,43 +208,19 @@ SlixPollerError slix_poller_select(SlixPoller* instance) {
 
 SlixPollerError slix_poller_read_signature(SlixPoller* instance) {
     furi_assert(instance);
-    bit_buffer_reset(instance->tx_buffer);
-
-    // Flags: Addressed, High data rate
-    uint8_t flags = ISO15693_3_REQ_FLAG_SUBCARRIER_1 | ISO15693_3_REQ_FLAG_DATA_RATE_HI |
-                    ISO15693_3_REQ_FLAG_T4_ADDRESSED;
-    bit_buffer_append_byte(instance->tx_buffer, flags);
-    // Command
-    bit_buffer_append_byte(instance->tx_buffer, SLIX_CMD_READ_SIGNATURE);
-    // Manufacturer code for NXP
-    bit_buffer_append_byte(instance->tx_buffer, SLIX_NXP_MANUFACTURER_CODE);
-    // UID
-    bit_buffer_append_bytes(instance->tx_buffer, instance->slix_data->uid, SLIX_UID_LEN);
-    // Append CRC
-    iso13239_crc_append(Iso13239CrcTypeDefault, instance->tx_buffer);
 
-    // Send request (Signature read needs a longer timeout)
-    NfcError error = nfc_poller_trx(
-        instance->nfc, instance->tx_buffer, instance->rx_buffer, SLIX_POLLER_MAX_FWT * 2);
+    slix_poller_begin_request(instance, SLIX_CMD_READ_SIGNATURE);
 
-    SlixPollerError slix_error = slix_poller_process_nfc_error(error);
+    // Signature read needs a longer timeout
+    SlixPollerError slix_error = slix_poller_send_request(instance, SLIX_POLLER_MAX_FWT * 2);
 
     if(slix_error == SlixPollerErrorNone) {
-        if(iso13239_crc_check(Iso13239CrcTypeDefault, instance->rx_buffer)) {
-            iso13239_crc_trim(instance->rx_buffer);
-
-            // Response format: flags(1) + signature(32)
-            if(bit_buffer_get_size_bytes(instance->rx_buffer) == 33) {
-                const uint8_t* resp_data = bit_buffer_get_data(instance->rx_buffer);
-                if(resp_data[0] & ISO15693_3_RESP_FLAG_ERROR) {
-                    slix_error = SlixPollerErrorProtocol;
-                } else {
-                    // Parse response
-                    memcpy(instance->slix_data->signature, &resp_data[1], SLIX_SIGNATURE_SIZE);
-                }
-            } else {
-                slix_error = SlixPollerErrorProtocol;
-            }
+        // Response format: flags(1) + signature(32)
+        if(bit_buffer_get_size_bytes(instance->rx_buffer) == 1 + SLIX_SIGNATURE_SIZE) {
+            memcpy(
+                instance->slix_data->signature,
+                &bit_buffer_get_data(instance->rx_buffer)[1],
+                SLIX_SIGNATURE_SIZE);
         } else {
             slix_error = SlixPollerErrorProtocol;
         }
@@ -274,36 +229,84 @@ SlixPollerError slix_poller_read_signature(SlixPoller* instance) {
     return slix_error;
 }
 
-SlixPollerError slix_poller_inventory(SlixPoller* instance) {
-    furi_assert(instance);
-    bit_buffer_reset(instance->tx_buffer);
-    bit_buffer_reset(instance->rx_buffer);
-
-    // Build and send INVENTORY command
-    slix_build_inventory_request(instance->tx_buffer);
+typedef enum {
+    SlixPollerSlotEmpty,
+    SlixPollerSlotFound,
+    SlixPollerSlotCollision,
+} SlixPollerSlot;
+
+static SlixPollerSlot slix_poller_inventory_slot(
+    Nfc* nfc,
+    BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer,
+    uint64_t mask,
+    uint8_t mask_len,
+    uint8_t* uid) {
+    slix_build_masked_inventory_request(tx_buffer, mask, mask_len);
+
+    NfcError error = nfc_poller_trx(nfc, tx_buffer, rx_buffer, ISO15693_3_FDT_POLL_FC * 2);
+    if(error == NfcErrorTimeout) {
+        return SlixPollerSlotEmpty;
+    }
 
-    NfcError error = nfc_poller_trx(
-        instance->nfc, instance->tx_buffer, instance->rx_buffer, ISO15693_3_FDT_POLL_FC * 2);
+    // Overlapping answers from several cards show up as a framing or CRC error
+    if(error != NfcErrorNone || !iso13239_crc_check(Iso13239CrcTypeDefault, rx_buffer)) {
+        return SlixPollerSlotCollision;
+    }
+    iso13239_crc_trim(rx_buffer);
 
-    SlixPollerError slix_error = slix_poller_process_nfc_error(error);
-    if(slix_error != SlixPollerErrorNone) {
-        return slix_error;
+    // Response format: flags(1) + dsfid(1) + uid(8)
+    if(bit_buffer_get_size_bytes(rx_buffer) != 1 + 1 + SLIX_UID_LEN) {
+        return SlixPollerSlotCollision;
     }
+    const uint8_t* resp_data = bit_buffer_get_data(rx_buffer);
+    if(resp_data[0] & ISO15693_3_RESP_FLAG_ERROR) {
+        return SlixPollerSlotEmpty;
+    }
+    memcpy(uid, &resp_data[2], SLIX_UID_LEN);
 
-    // A valid INVENTORY response is 12 bytes (flags, dsfid, uid, crc)
-    if(bit_buffer_get_size_bytes(instance->rx_buffer) >= 12) {
-        uint8_t flags = bit_buffer_get_byte(instance->rx_buffer, 0);
-        if(!(flags & ISO15693_3_RESP_FLAG_ERROR)) {
-            // Verify that the UID from inventory matches the one from the initial scan
-            const uint8_t* uid_lsb = &bit_buffer_get_data(instance->rx_buffer)[2];
-            if(memcmp(instance->slix_data->uid, uid_lsb, SLIX_UID_LEN) == 0) {
-                return SlixPollerErrorNone;
-            } else {
-                FURI_LOG_W(TAG, "Inventory UID mismatch");
-                return SlixPollerErrorProtocol;
-            }
+    return SlixPollerSlotFound;
+}
+
+size_t slix_poller_inventory_all(
+    Nfc* nfc,
+    BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer,
+    uint8_t (*uids)[SLIX_UID_LEN],
+    size_t uids_max) {
+    furi_assert(nfc);
+    furi_assert(uids);
+
+    // Depth-first walk over UID nibbles: a collision under a mask splits it into
+    // 16 sub-masks, one per value of the next 4 UID bits.
+    uint8_t nibbles[SLIX_POLLER_MASK_LEVELS_MAX + 1] = {0};
+    uint64_t mask = 0;
+    uint8_t level = 0;
+    size_t uids_total = 0;
+
+    while(uids_total < uids_max) {
+        SlixPollerSlot slot = slix_poller_inventory_slot(
+            nfc, tx_buffer, rx_buffer, mask, level * 4, uids[uids_total]);
+
+        if(slot == SlixPollerSlotFound) {
+            uids_total++;
+        } else if(slot == SlixPollerSlotCollision && level < SLIX_POLLER_MASK_LEVELS_MAX) {
+            level++;
+            nibbles[level] = 0;
+            continue;
         }
+
+        // Move on to the next sibling mask, leaving levels whose 16 values are all done
+        while(level > 0 && nibbles[level] == 0x0F) {
+            mask &= ~(0x0FULL << ((level - 1) * 4));
+            level--;
+        }
+        if(level == 0) break;
+
+        nibbles[level]++;
+        mask &= ~(0x0FULL << ((level - 1) * 4));
+        mask |= (uint64_t)nibbles[level] << ((level - 1) * 4);
     }
 
-    return SlixPollerErrorProtocol;
+    return uids_total;
 }
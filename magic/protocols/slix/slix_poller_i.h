@@ -1,6 +1,7 @@
 #pragma once
 
 #include "slix_poller.h"
+#include "../nfc_magic_retry.h"
 #include <nfc/nfc_poller.h>
 #include <nfc/protocols/iso15693_3/iso15693_3_poller.h>
 
@@ -12,18 +13,33 @@ extern "C" {
 #define SLIX_POLLER_MAX_BUFFER_SIZE (64U)
 #define SLIX_POLLER_MAX_FWT         (60000U)
 
+// Largest READ/WRITE MULTIPLE BLOCKS chunk that fits SLIX_POLLER_MAX_BUFFER_SIZE
+#define SLIX_POLLER_MULTI_BLOCKS_MAX (8U)
+
+// Cards handled per activation, and UID nibbles the anticollision can branch on
+#define SLIX_POLLER_UIDS_MAX        (16U)
+#define SLIX_POLLER_MASK_LEVELS_MAX (SLIX_UID_LEN * 2)
+
+#define SLIX_POLLER_ISO_HEADER_SIZE (1 + 1 + SLIX_UID_LEN)
+#define SLIX_POLLER_NXP_HEADER_SIZE (1 + 1 + 1 + SLIX_UID_LEN)
+
 typedef enum {
     SlixPollerErrorNone,
     SlixPollerErrorTimeout,
     SlixPollerErrorProtocol,
+    // Frame arrived damaged, CRC or framing did not check out
+    SlixPollerErrorCommunication,
 } SlixPollerError;
 
 typedef enum {
     SlixPollerStateIdle,
     SlixPollerStateRequestMode,
+    SlixPollerStateInventory,
     SlixPollerStateWipe,
     SlixPollerStateGetInfo,
-    // Add other states like Write here
+    SlixPollerStateDump,
+    SlixPollerStateRequestWriteData,
+    SlixPollerStateWrite,
     SlixPollerStateSuccess,
     SlixPollerStateFail,
 
@@ -35,11 +51,30 @@ struct SlixPoller {
     SlixPollerState state;
 
     SlixData* slix_data;
+    const SlixData* source_data;
+    const NfcMagicFingerprint* fingerprint;
 
     BitBuffer* tx_buffer;
     BitBuffer* rx_buffer;
+    // Addressed request headers, prebuilt once the UID is known
+    uint8_t iso_header[SLIX_POLLER_ISO_HEADER_SIZE];
+    uint8_t nxp_header[SLIX_POLLER_NXP_HEADER_SIZE];
+
+    // Cards found by anticollision, processed one after another in card_state
+    uint8_t uids[SLIX_POLLER_UIDS_MAX][SLIX_UID_LEN];
+    uint8_t uids_total;
+    uint8_t uid_index;
+    // The scanned card decides the result, failures of the others are only reported
+    bool scanned_card_failed;
+    uint8_t others_failed;
+    SlixPollerState card_state;
 
     uint16_t current_block;
+    uint16_t blocks_total;
+    bool memory_size_guessed;
+    bool multi_read_unsupported;
+    bool multi_write_unsupported;
+    NfcMagicRetry retry;
 
     SlixPollerEvent slix_event;
     SlixPollerEventData slix_event_data;
@@ -48,16 +83,46 @@ struct SlixPoller {
     void* context;
 };
 
+void slix_poller_prepare_headers(SlixPoller* instance);
+
 SlixPollerError
     slix_poller_write_block(SlixPoller* instance, uint8_t block_num, const uint8_t* data);
 
+SlixPollerError slix_poller_write_multiple_blocks(
+    SlixPoller* instance,
+    uint8_t first_block,
+    uint8_t block_count,
+    const uint8_t* data);
+
+SlixPollerError slix_poller_read_multiple_blocks(
+    SlixPoller* instance,
+    uint8_t first_block,
+    uint8_t block_count,
+    uint8_t* data);
+
+SlixPollerError
+    slix_poller_write_system_byte(SlixPoller* instance, uint8_t command, uint8_t value);
+
 SlixPollerError slix_poller_get_nxp_system_info(SlixPoller* instance);
 
 SlixPollerError slix_poller_get_system_info(SlixPoller* instance);
 
-SlixPollerError slix_poller_select(SlixPoller* instance);
-
-SlixPollerError slix_poller_inventory(SlixPoller* instance);
+/**
+ * @brief Enumerate every card in the field with masked single-slot INVENTORY requests.
+ *
+ * @param nfc Nfc instance, configured for ISO15693 polling.
+ * @param tx_buffer Scratch transmit buffer.
+ * @param rx_buffer Scratch receive buffer.
+ * @param[out] uids Array receiving the UIDs found.
+ * @param uids_max Capacity of uids, enumeration stops once it is full.
+ * @return Number of UIDs found.
+ */
+size_t slix_poller_inventory_all(
+    Nfc* nfc,
+    BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer,
+    uint8_t (*uids)[SLIX_UID_LEN],
+    size_t uids_max);
 
 SlixPollerError slix_poller_read_signature(SlixPoller* instance);
 
@@ -59,9 +59,6 @@ NfcMagicApp* nfc_magic_app_alloc() {
     // NFC target device
     instance->target_dev = nfc_device_alloc();
 
-    // NFC dump data
-    instance->dump_data = mf_classic_alloc();
-
     // Open GUI record
     instance->gui = furi_record_open(RECORD_GUI);
     view_dispatcher_attach_to_gui(
@@ -76,6 +73,9 @@ NfcMagicApp* nfc_magic_app_alloc() {
     // Open Storage
     instance->storage = furi_record_open(RECORD_STORAGE);
 
+    // Streamed source dump, opened by file select
+    instance->block_source = nfc_magic_block_source_alloc(instance->storage);
+
     // Submenu
     instance->submenu = submenu_alloc();
     view_dispatcher_add_view(
@@ -111,21 +111,11 @@ NfcMagicApp* nfc_magic_app_alloc() {
         instance->view_dispatcher, NfcMagicAppViewWidget, widget_get_view(instance->widget));
 
     instance->gen4_data = gen4_alloc();
+    instance->gen4_profile = gen4_profile_alloc();
     instance->slix_data = slix_alloc();
+    nfc_magic_fingerprint_reset(&instance->fingerprint);
 
-    // Dict attack
-    instance->dict_attack = dict_attack_alloc();
-    view_dispatcher_add_view(
-        instance->view_dispatcher,
-        NfcMagicAppViewDictAttack,
-        dict_attack_get_view(instance->dict_attack));
-
-    // Write problems
-    instance->write_problems = write_problems_alloc();
-    view_dispatcher_add_view(
-        instance->view_dispatcher,
-        NfcMagicAppViewWriteProblems,
-        write_problems_get_view(instance->write_problems));
+    // Dict attack, write problems and dump data are allocated by their scenes
 
     instance->nfc = nfc_alloc();
     instance->scanner = nfc_magic_scanner_alloc(instance->nfc);
@@ -144,8 +134,8 @@ void nfc_magic_app_free(NfcMagicApp* instance) {
     // Nfc target device
     nfc_device_free(instance->target_dev);
 
-    // Nfc dump data
-    mf_classic_free(instance->dump_data);
+    // Nfc original device, left over if the app exits from a shadow write
+    nfc_magic_free_shadow_original(instance);
 
     // Submenu
     view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewMenu);
@@ -171,14 +161,6 @@ void nfc_magic_app_free(NfcMagicApp* instance) {
     view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewWidget);
     widget_free(instance->widget);
 
-    // Dict attack
-    view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewDictAttack);
-    dict_attack_free(instance->dict_attack);
-
-    // Write problems
-    view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewWriteProblems);
-    write_problems_free(instance->write_problems);
-
     // View Dispatcher
     view_dispatcher_free(instance->view_dispatcher);
 
@@ -197,11 +179,15 @@ void nfc_magic_app_free(NfcMagicApp* instance) {
     furi_record_close(RECORD_DIALOGS);
     instance->dialogs = NULL;
 
+    // Streamed source dump
+    nfc_magic_block_source_free(instance->block_source);
+
     // Storage
     furi_record_close(RECORD_STORAGE);
     instance->storage = NULL;
 
     gen4_free(instance->gen4_data);
+    gen4_profile_free(instance->gen4_profile);
     slix_free(instance->slix_data);
 
     nfc_magic_scanner_free(instance->scanner);
@@ -210,6 +196,46 @@ void nfc_magic_app_free(NfcMagicApp* instance) {
     free(instance);
 }
 
+void nfc_magic_app_dict_attack_view_alloc(NfcMagicApp* instance) {
+    furi_assert(instance);
+    furi_assert(instance->dict_attack == NULL);
+
+    instance->dict_attack = dict_attack_alloc();
+    view_dispatcher_add_view(
+        instance->view_dispatcher,
+        NfcMagicAppViewDictAttack,
+        dict_attack_get_view(instance->dict_attack));
+}
+
+void nfc_magic_app_dict_attack_view_free(NfcMagicApp* instance) {
+    furi_assert(instance);
+    furi_assert(instance->dict_attack);
+
+    view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewDictAttack);
+    dict_attack_free(instance->dict_attack);
+    instance->dict_attack = NULL;
+}
+
+void nfc_magic_app_write_problems_view_alloc(NfcMagicApp* instance) {
+    furi_assert(instance);
+    furi_assert(instance->write_problems == NULL);
+
+    instance->write_problems = write_problems_alloc();
+    view_dispatcher_add_view(
+        instance->view_dispatcher,
+        NfcMagicAppViewWriteProblems,
+        write_problems_get_view(instance->write_problems));
+}
+
+void nfc_magic_app_write_problems_view_free(NfcMagicApp* instance) {
+    furi_assert(instance);
+    furi_assert(instance->write_problems);
+
+    view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewWriteProblems);
+    write_problems_free(instance->write_problems);
+    instance->write_problems = NULL;
+}
+
 static const NotificationSequence nfc_magic_sequence_blink_start_cyan = {
     &message_blink_start_10,
     &message_blink_set_color_cyan,
@@ -230,6 +256,36 @@ void nfc_magic_app_blink_stop(NfcMagicApp* instance) {
     notification_message(instance->notifications, &nfc_magic_sequence_blink_stop);
 }
 
+void nfc_magic_app_show_write_progress(NfcMagicApp* instance, const char* header) {
+    furi_assert(instance);
+    furi_assert(header);
+
+    Popup* popup = instance->popup;
+    const NfcMagicAppWriteProgressContext* progress = &instance->write_progress_context;
+
+    popup_set_icon(popup, 12, 23, &I_Loading_24);
+    if((progress->retries > 0) || (progress->resumed_from > 0)) {
+        // Retries tell more about a shaky card than where the write picked up
+        if(progress->retries > 0) {
+            snprintf(
+                instance->text_store,
+                sizeof(instance->text_store),
+                "Retries: %u",
+                progress->retries);
+        } else {
+            snprintf(
+                instance->text_store,
+                sizeof(instance->text_store),
+                "From block %u",
+                progress->resumed_from);
+        }
+        popup_set_header(popup, header, 52, 26, AlignLeft, AlignCenter);
+        popup_set_text(popup, instance->text_store, 52, 44, AlignLeft, AlignTop);
+    } else {
+        popup_set_header(popup, header, 52, 32, AlignLeft, AlignCenter);
+    }
+}
+
 static bool nfc_magic_set_shadow_file_path(FuriString* file_path, FuriString* shadow_file_path) {
     furi_assert(file_path);
     furi_assert(shadow_file_path);
@@ -266,12 +322,11 @@ static bool nfc_magic_has_shadow_file_internal(NfcMagicApp* instance, FuriString
     return has_shadow_file;
 }
 
-bool nfc_magic_load_file(NfcMagicApp* instance, FuriString* path, bool show_dialog) {
+void nfc_magic_get_load_path(NfcMagicApp* instance, FuriString* path, FuriString* load_path) {
     furi_assert(instance);
     furi_assert(path);
-    bool result = false;
+    furi_assert(load_path);
 
-    FuriString* load_path = furi_string_alloc();
     if(nfc_magic_has_shadow_file_internal(instance, path)) {
         nfc_magic_set_shadow_file_path(path, load_path);
     } else if(furi_string_end_with(path, NFC_APP_SHADOW_EXTENSION)) {
@@ -281,8 +336,27 @@ bool nfc_magic_load_file(NfcMagicApp* instance, FuriString* path, bool show_dial
     } else {
         furi_string_set(load_path, path);
     }
+}
 
-    result = nfc_device_load(instance->source_dev, furi_string_get_cstr(load_path));
+bool nfc_magic_load_file(NfcMagicApp* instance, FuriString* path, bool show_dialog) {
+    furi_assert(instance);
+    furi_assert(path);
+    bool result = false;
+
+    FuriString* load_path = furi_string_alloc();
+    nfc_magic_get_load_path(instance, path, load_path);
+
+    // The parsed image replaces a streamed one
+    nfc_magic_block_source_close(instance->block_source);
+
+    const char* load_path_cstr = furi_string_get_cstr(load_path);
+    result = nfc_magic_dump_cache_load(instance->storage, load_path_cstr, instance->source_dev);
+    if(!result) {
+        result = nfc_device_load(instance->source_dev, load_path_cstr);
+        if(result) {
+            nfc_magic_dump_cache_save(instance->storage, load_path_cstr, instance->source_dev);
+        }
+    }
 
     if(result) {
         path_extract_filename(load_path, instance->file_name, true);
@@ -297,6 +371,29 @@ bool nfc_magic_load_file(NfcMagicApp* instance, FuriString* path, bool show_dial
     return result;
 }
 
+bool nfc_magic_open_source_file(NfcMagicApp* instance, FuriString* path, bool show_dialog) {
+    furi_assert(instance);
+    furi_assert(path);
+    bool result = false;
+
+    FuriString* load_path = furi_string_alloc();
+    nfc_magic_get_load_path(instance, path, load_path);
+
+    nfc_device_clear(instance->source_dev);
+    result =
+        nfc_magic_block_source_open(instance->block_source, furi_string_get_cstr(load_path));
+    if(result) {
+        path_extract_filename(load_path, instance->file_name, true);
+    } else {
+        // Other protocols and older formats are parsed as a whole
+        result = nfc_magic_load_file(instance, path, show_dialog);
+    }
+
+    furi_string_free(load_path);
+
+    return result;
+}
+
 bool nfc_magic_load_from_file_select(NfcMagicApp* instance) {
     furi_assert(instance);
 
@@ -310,8 +407,59 @@ bool nfc_magic_load_from_file_select(NfcMagicApp* instance) {
         instance->dialogs, instance->file_path, instance->file_path, &browser_options);
 
     if(result) {
-        result = nfc_magic_load_file(instance, instance->file_path, true);
+        result = nfc_magic_open_source_file(instance, instance->file_path, true);
+    }
+
+    return result;
+}
+
+void nfc_magic_free_shadow_original(NfcMagicApp* instance) {
+    furi_assert(instance);
+
+    if(instance->original_dev) {
+        nfc_device_free(instance->original_dev);
+        instance->original_dev = NULL;
+    }
+}
+
+bool nfc_magic_load_shadow_pair(NfcMagicApp* instance, FuriString* path) {
+    furi_assert(instance);
+    furi_assert(path);
+
+    bool result = false;
+    FuriString* original_path = furi_string_alloc();
+    nfc_magic_free_shadow_original(instance);
+    instance->original_dev = nfc_device_alloc();
+
+    do {
+        if(!nfc_magic_has_shadow_file_internal(instance, path)) {
+            dialog_message_show_storage_error(instance->dialogs, "No shadow file\nfor this dump");
+            break;
+        }
+
+        if(furi_string_end_with(path, NFC_APP_SHADOW_EXTENSION)) {
+            size_t path_len = furi_string_size(path);
+            furi_string_set_n(original_path, path, 0, path_len - 4);
+            furi_string_cat_printf(original_path, "%s", NFC_APP_EXTENSION);
+        } else {
+            furi_string_set(original_path, path);
+        }
+        if(!nfc_device_load(instance->original_dev, furi_string_get_cstr(original_path))) {
+            dialog_message_show_storage_error(instance->dialogs, "Cannot load\nkey file");
+            break;
+        }
+
+        // Source device gets the .shd image
+        if(!nfc_magic_load_file(instance, path, true)) break;
+
+        result = nfc_device_get_protocol(instance->source_dev) ==
+                 nfc_device_get_protocol(instance->original_dev);
+    } while(false);
+
+    if(!result) {
+        nfc_magic_free_shadow_original(instance);
     }
+    furi_string_free(original_path);
 
     return result;
 }
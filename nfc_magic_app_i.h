@@ -2,6 +2,7 @@
 
 #include "nfc_magic_app.h"
 #include "helpers/nfc_magic_custom_events.h"
+#include "helpers/nfc_magic_dump_cache.h"
 
 #include <furi.h>
 #include <gui/gui.h>
@@ -35,10 +36,13 @@
 #include <toolbox/keys_dict.h>
 
 #include "magic/nfc_magic_scanner.h"
+#include "magic/nfc_magic_block_source.h"
 #include "magic/protocols/nfc_magic_protocols.h"
 #include "magic/protocols/gen1a/gen1a_poller.h"
 #include "magic/protocols/gen2/gen2_poller.h"
+#include "magic/protocols/gen2/gen2_nonce_log.h"
 #include "magic/protocols/gen4/gen4_poller.h"
+#include "magic/protocols/gen4/gen4_password_list.h"
 #include "magic/protocols/slix/slix_poller.h"
 
 #include "lib/nfc/protocols/mf_classic/mf_classic_poller.h"
@@ -49,6 +53,8 @@
 
 #define NFC_APP_MF_CLASSIC_DICT_USER_PATH (NFC_APP_FOLDER "/assets/mf_classic_dict_user.nfc")
 #define NFC_APP_MF_CLASSIC_DICT_SYSTEM_PATH (NFC_APP_FOLDER "/assets/mf_classic_dict.nfc")
+#define NFC_APP_GEN2_NONCE_LOG_PATH (NFC_APP_FOLDER "/.gen2_nested.log")
+#define NFC_APP_GEN4_PASSWORDS_PATH (NFC_APP_FOLDER "/assets/gen4_passwords.txt")
 
 #define NFC_MAGIC_APP_NAME_SIZE 22
 #define NFC_MAGIC_APP_TEXT_STORE_SIZE 128
@@ -84,6 +90,8 @@ typedef struct {
     bool is_key_attack;
     uint8_t key_attack_current_sector;
     bool is_card_present;
+    // Set by the Gen2 key check for the keys its offline pass could not find
+    bool is_system_dict_fallback;
 } NfcMagicAppMfClassicDictAttackContext;
 
 typedef struct {
@@ -93,6 +101,15 @@ typedef struct {
     Gen2PollerWriteProblems problems;
 } NfcMagicAppWriteProblemsContext;
 
+typedef struct {
+    uint16_t blocks_written;
+    uint16_t blocks_total;
+    // Block a write picked up from after the card was lost, 0 if it started over
+    uint16_t resumed_from;
+    // Blocks redone after a transient error, over the whole write
+    uint16_t retries;
+} NfcMagicAppWriteProgressContext;
+
 struct NfcMagicApp {
     ViewDispatcher* view_dispatcher;
     Gui* gui;
@@ -103,9 +120,12 @@ struct NfcMagicApp {
     SceneManager* scene_manager;
     NfcDevice* source_dev;
     NfcDevice* target_dev;
+    // Scene-scoped: the .nfc image next to a .shd source, only set during a shadow write
+    NfcDevice* original_dev;
     char text_store[NFC_MAGIC_APP_TEXT_STORE_SIZE + 1];
     FuriString* file_name;
     FuriString* file_path;
+    // Scene-scoped: only valid while the Dump scene is active
     MfClassicData* dump_data;
 
     Nfc* nfc;
@@ -121,16 +141,27 @@ struct NfcMagicApp {
     SlixPoller* slix_poller;
 
     Gen4* gen4_data;
+    Gen4Profile* gen4_profile;
 
     SlixData* slix_data;
+    // Other cards in the field the last SLIX get info could not read
+    uint8_t slix_others_failed;
+    // Scene-scoped: only valid while the Write scene writes a SLIX card
+    SlixData* slix_source_data;
+    // Selected MIFARE Classic/Ultralight dump read from storage, open instead of source_dev
+    NfcMagicBlockSource* block_source;
+    // What the scanner learned about the card last detected
+    NfcMagicFingerprint fingerprint;
 
     Gen4Password gen4_password;
     Gen4Password gen4_password_new;
 
+    // Views below are allocated on scene entry and freed on scene exit
     NfcMagicAppMfClassicDictAttackContext nfc_dict_context;
     DictAttack* dict_attack;
     NfcMagicAppWriteProblemsContext write_problems_context;
     WriteProblems* write_problems;
+    NfcMagicAppWriteProgressContext write_progress_context;
 
     FuriString* text_box_store;
     uint8_t byte_input_store[NFC_MAGIC_APP_BYTE_INPUT_STORE_SIZE];
@@ -161,4 +192,29 @@ void nfc_magic_app_blink_stop(NfcMagicApp* nfc_magic);
 
 void nfc_magic_app_show_loading_popup(void* context, bool show);
 
+// Popup of a running write or wipe, with the retries or the resume point once there are any
+void nfc_magic_app_show_write_progress(NfcMagicApp* instance, const char* header);
+
+void nfc_magic_app_dict_attack_view_alloc(NfcMagicApp* instance);
+
+void nfc_magic_app_dict_attack_view_free(NfcMagicApp* instance);
+
+void nfc_magic_app_write_problems_view_alloc(NfcMagicApp* instance);
+
+void nfc_magic_app_write_problems_view_free(NfcMagicApp* instance);
+
+void nfc_magic_get_load_path(NfcMagicApp* instance, FuriString* path, FuriString* load_path);
+
+// Parses the whole dump into source_dev
+bool nfc_magic_load_file(NfcMagicApp* instance, FuriString* path, bool show_dialog);
+
+// Opens MIFARE Classic and Ultralight dumps as block_source and parses anything else into
+// source_dev, only one of the two holds the dump afterwards
+bool nfc_magic_open_source_file(NfcMagicApp* instance, FuriString* path, bool show_dialog);
+
 bool nfc_magic_load_from_file_select(NfcMagicApp* instance);
+
+// Loads the .shd image into source_dev and allocates original_dev for the .nfc one
+bool nfc_magic_load_shadow_pair(NfcMagicApp* instance, FuriString* path);
+
+void nfc_magic_free_shadow_original(NfcMagicApp* instance);
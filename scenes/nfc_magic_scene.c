@@ -1,7 +1,25 @@
 #include "nfc_magic_scene.h"
+#include "../helpers/nfc_magic_heap_report.h"
+
+#include <furi.h>
+
+// Wrap scene on_enter and on_exit handlers with a heap usage report
+#define ADD_SCENE(prefix, name, id)                                        \
+    static void prefix##_scene_##name##_on_enter_reported(void* context) { \
+        size_t free_before = memmgr_get_free_heap();                       \
+        prefix##_scene_##name##_on_enter(context);                         \
+        nfc_magic_heap_report(#id, "enter", free_before);                  \
+    }                                                                      \
+    static void prefix##_scene_##name##_on_exit_reported(void* context) {  \
+        size_t free_before = memmgr_get_free_heap();                       \
+        prefix##_scene_##name##_on_exit(context);                          \
+        nfc_magic_heap_report(#id, "exit", free_before);                   \
+    }
+#include "nfc_magic_scene_config.h"
+#undef ADD_SCENE
 
 // Generate scene on_enter handlers array
-#define ADD_SCENE(prefix, name, id) prefix##_scene_##name##_on_enter,
+#define ADD_SCENE(prefix, name, id) prefix##_scene_##name##_on_enter_reported,
 void (*const nfc_magic_on_enter_handlers[])(void*) = {
 #include "nfc_magic_scene_config.h"
 };
@@ -15,7 +33,7 @@ bool (*const nfc_magic_on_event_handlers[])(void* context, SceneManagerEvent eve
 #undef ADD_SCENE
 
 // Generate scene on_exit handlers array
-#define ADD_SCENE(prefix, name, id) prefix##_scene_##name##_on_exit,
+#define ADD_SCENE(prefix, name, id) prefix##_scene_##name##_on_exit_reported,
 void (*const nfc_magic_on_exit_handlers[])(void* context) = {
 #include "nfc_magic_scene_config.h"
 };
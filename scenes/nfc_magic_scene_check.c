@@ -23,8 +23,14 @@ void nfc_magic_scene_check_on_enter(void* context) {
 
     nfc_magic_app_blink_start(instance);
 
+    // The password in use goes first, then the ones kept on SD
+    Gen4PasswordList gen4_passwords;
+    gen4_password_list_reset(&gen4_passwords);
+    gen4_password_list_add(&gen4_passwords, &instance->gen4_password);
+    gen4_password_list_load(&gen4_passwords, instance->storage, NFC_APP_GEN4_PASSWORDS_PATH);
+    nfc_magic_scanner_set_gen4_passwords(instance->scanner, &gen4_passwords);
+
     nfc_magic_scanner_start(instance->scanner, nfc_magic_check_worker_callback, instance);
-    nfc_magic_scanner_set_gen4_password(instance->scanner, instance->gen4_password);
 
     view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewPopup);
 }
@@ -12,6 +12,10 @@ ADD_SCENE(nfc_magic, gen4_show_info, Gen4ShowInfo)
 ADD_SCENE(nfc_magic, gen4_select_shd_mode, Gen4SelectShdMode)
 ADD_SCENE(nfc_magic, gen4_set_shd_mode, Gen4SetShdMode)
 ADD_SCENE(nfc_magic, gen4_set_direct_write_block_0_mode, Gen4SetDirectWriteBlock0Mode)
+ADD_SCENE(nfc_magic, gen4_profile_select, Gen4ProfileSelect)
+ADD_SCENE(nfc_magic, gen4_provision, Gen4Provision)
+ADD_SCENE(nfc_magic, gen4_shadow_select, Gen4ShadowSelect)
+ADD_SCENE(nfc_magic, gen4_shadow_write, Gen4ShadowWrite)
 ADD_SCENE(nfc_magic, gen4_fail, Gen4Fail)
 ADD_SCENE(nfc_magic, wipe, Wipe)
 ADD_SCENE(nfc_magic, wipe_fail, WipeFail)
@@ -27,6 +31,7 @@ ADD_SCENE(nfc_magic, not_magic, NotMagic)
 ADD_SCENE(nfc_magic, gen2_menu, Gen2Menu)
 ADD_SCENE(nfc_magic, mf_classic_menu, MfClassicMenu)
 ADD_SCENE(nfc_magic, mf_classic_dict_attack, MfClassicDictAttack)
+ADD_SCENE(nfc_magic, gen2_key_check, Gen2KeyCheck)
 ADD_SCENE(nfc_magic, gen2_write_check, Gen2WriteCheck)
 ADD_SCENE(nfc_magic, mf_classic_write_check, MfClassicWriteCheck)
 ADD_SCENE(nfc_magic, dump, Dump)
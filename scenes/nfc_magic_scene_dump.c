@@ -1,4 +1,5 @@
 #include "../nfc_magic_app_i.h"
+#include "magic/protocols/slix/slix.h"
 
 enum {
     NfcMagicSceneDumpStateCardSearch,
@@ -31,6 +32,40 @@ NfcCommand nfc_magic_scene_dump_gen1_poller_callback(Gen1aPollerEvent event, voi
     return command;
 }
 
+NfcCommand nfc_magic_scene_dump_slix_poller_callback(SlixPollerEvent event, void* context) {
+    NfcMagicApp* instance = context;
+    furi_assert(event.data);
+
+    NfcCommand command = NfcCommandContinue;
+
+    if(event.type == SlixPollerEventTypeCardDetected) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == SlixPollerEventTypeRequestMode) {
+        event.data->request_mode.mode = SlixPollerModeDump;
+    } else if(event.type == SlixPollerEventTypeSuccess) {
+        slix_copy(instance->slix_data, slix_poller_get_data(instance->slix_poller));
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
+        command = NfcCommandStop;
+    } else if(event.type == SlixPollerEventTypeFail) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerFail);
+        command = NfcCommandStop;
+    }
+
+    return command;
+}
+
+// Only a complete dump replaces the source, a failed or cancelled one leaves it as it was
+static void nfc_magic_scene_dump_save(NfcMagicApp* instance) {
+    if(instance->protocol == NfcMagicProtocolGen1) {
+        nfc_device_set_data(instance->source_dev, NfcProtocolMfClassic, instance->dump_data);
+    } else if(instance->protocol == NfcMagicProtocolSlix) {
+        slix_save_to_device(instance->slix_data, instance->source_dev);
+    }
+}
+
 static void nfc_magic_scene_dump_setup_view(NfcMagicApp* instance) {
     Popup* popup = instance->popup;
     popup_reset(popup);
@@ -58,9 +93,15 @@ void nfc_magic_scene_dump_on_enter(void* context) {
     nfc_magic_app_blink_start(instance);
 
     if(instance->protocol == NfcMagicProtocolGen1) {
+        instance->dump_data = mf_classic_alloc();
         instance->gen1a_poller = gen1a_poller_alloc(instance->nfc);
         gen1a_poller_start(
             instance->gen1a_poller, nfc_magic_scene_dump_gen1_poller_callback, instance);
+    } else if(instance->protocol == NfcMagicProtocolSlix) {
+        instance->slix_poller = slix_poller_alloc(instance->nfc);
+        slix_poller_set_data(instance->slix_poller, instance->slix_data);
+        slix_poller_start(
+            instance->slix_poller, nfc_magic_scene_dump_slix_poller_callback, instance);
     }
 }
 
@@ -80,6 +121,7 @@ bool nfc_magic_scene_dump_on_event(void* context, SceneManagerEvent event) {
             nfc_magic_scene_dump_setup_view(instance);
             consumed = true;
         } else if(event.event == NfcMagicCustomEventWorkerSuccess) {
+            nfc_magic_scene_dump_save(instance);
             scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen1SaveName);
             consumed = true;
         } else if(event.event == NfcMagicCustomEventWorkerFail) {
@@ -97,9 +139,13 @@ void nfc_magic_scene_dump_on_exit(void* context) {
     if(instance->protocol == NfcMagicProtocolGen1) {
         gen1a_poller_stop(instance->gen1a_poller);
         gen1a_poller_free(instance->gen1a_poller);
-    }
 
-    nfc_device_set_data(instance->source_dev, NfcProtocolMfClassic, instance->dump_data);
+        mf_classic_free(instance->dump_data);
+        instance->dump_data = NULL;
+    } else if(instance->protocol == NfcMagicProtocolSlix) {
+        slix_poller_stop(instance->slix_poller);
+        slix_poller_free(instance->slix_poller);
+    }
 
     scene_manager_set_scene_state(
         instance->scene_manager, NfcMagicSceneDump, NfcMagicSceneDumpStateCardSearch);
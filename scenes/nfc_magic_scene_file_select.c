@@ -1,17 +1,33 @@
 #include "../nfc_magic_app_i.h"
 #include <nfc/protocols/mf_classic/mf_classic.h>
+#include "magic/protocols/slix/slix.h"
 
+static bool nfc_magic_scene_file_select_is_mfu_type_suitable(MfUltralightType mfu_type) {
+    return (mfu_type != MfUltralightTypeNTAGI2C1K) && (mfu_type != MfUltralightTypeNTAGI2C2K) &&
+           (mfu_type != MfUltralightTypeNTAGI2CPlus1K) &&
+           (mfu_type != MfUltralightTypeNTAGI2CPlus2K);
+}
+
+// Only the header of a streamed dump is known here, its blocks are read by the write
 static bool nfc_magic_scene_file_select_is_file_suitable(NfcMagicApp* instance) {
-    NfcProtocol protocol = nfc_device_get_protocol(instance->source_dev);
+    NfcMagicBlockSource* source = instance->block_source;
+    bool is_streamed = nfc_magic_block_source_is_open(source);
+    NfcProtocol protocol = NfcProtocolInvalid;
     size_t uid_len = 0;
-    nfc_device_get_uid(instance->source_dev, &uid_len);
+    if(is_streamed) {
+        protocol = nfc_magic_block_source_get_protocol(source);
+        uid_len = nfc_magic_block_source_get_iso14443_3a_data(source)->uid_len;
+    } else {
+        protocol = nfc_device_get_protocol(instance->source_dev);
+        nfc_device_get_uid(instance->source_dev, &uid_len);
+    }
 
     bool suitable = false;
     if(instance->protocol == NfcMagicProtocolGen1) {
-        if((uid_len == 4 || uid_len == 7) && (protocol == NfcProtocolMfClassic)) {
-            const MfClassicData* mfc_data =
-                nfc_device_get_data(instance->source_dev, NfcProtocolMfClassic);
-            if(mfc_data->type == MfClassicType1k) {
+        // Gen1a writes from the streamed dump only
+        if(is_streamed && (uid_len == 4 || uid_len == 7) &&
+           (protocol == NfcProtocolMfClassic)) {
+            if(nfc_magic_block_source_get_type(source) == MfClassicType1k) {
                 suitable = true;
             }
         }
@@ -19,25 +35,31 @@ static bool nfc_magic_scene_file_select_is_file_suitable(NfcMagicApp* instance)
         if(protocol == NfcProtocolMfClassic) {
             suitable = true;
         } else if(protocol == NfcProtocolMfUltralight) {
-            const MfUltralightData* mfu_data =
-                nfc_device_get_data(instance->source_dev, NfcProtocolMfUltralight);
-            const Iso14443_3aData* iso3_data = mfu_data->iso14443_3a_data;
-            if(iso3_data->uid_len == 7) {
-                MfUltralightType mfu_type = mfu_data->type;
-                suitable = (mfu_type != MfUltralightTypeNTAGI2C1K) &&
-                           (mfu_type != MfUltralightTypeNTAGI2C2K) &&
-                           (mfu_type != MfUltralightTypeNTAGI2CPlus1K) &&
-                           (mfu_type != MfUltralightTypeNTAGI2CPlus2K);
+            if(uid_len == 7) {
+                MfUltralightType mfu_type = MfUltralightTypeNum;
+                if(is_streamed) {
+                    mfu_type = nfc_magic_block_source_get_mfu_type(source);
+                } else {
+                    const MfUltralightData* mfu_data =
+                        nfc_device_get_data(instance->source_dev, NfcProtocolMfUltralight);
+                    mfu_type = mfu_data->type;
+                }
+                suitable = nfc_magic_scene_file_select_is_mfu_type_suitable(mfu_type);
             }
         }
     } else if(instance->protocol == NfcMagicProtocolGen2) {
-        if(protocol == NfcProtocolMfClassic) {
+        // Gen2 writes from the streamed dump only
+        if(is_streamed && (protocol == NfcProtocolMfClassic)) {
             suitable = true;
         }
     } else if(instance->protocol == NfcMagicProtocolClassic) {
-        if(protocol == NfcProtocolMfClassic) {
+        if(is_streamed && (protocol == NfcProtocolMfClassic)) {
             suitable = true;
         }
+    } else if(instance->protocol == NfcMagicProtocolSlix) {
+        SlixData* slix_data = slix_alloc();
+        suitable = slix_load_from_device(slix_data, instance->source_dev);
+        slix_free(slix_data);
     }
 
     return suitable;
@@ -0,0 +1,139 @@
+#include "../nfc_magic_app_i.h"
+
+enum {
+    NfcMagicSceneGen2KeyCheckStateCardSearch,
+    NfcMagicSceneGen2KeyCheckStateCardFound,
+};
+
+NfcCommand nfc_magic_scene_gen2_key_check_poller_callback(Gen2PollerEvent event, void* context) {
+    NfcMagicApp* instance = context;
+    furi_assert(event.data);
+
+    NfcCommand command = NfcCommandContinue;
+
+    if(event.type == Gen2PollerEventTypeDetected) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen2PollerEventTypeRequestMode) {
+        event.data->poller_mode.mode = Gen2PollerModeCheckKeys;
+    } else if(event.type == Gen2PollerEventTypeRequestKeys) {
+        event.data->request_keys.mfc_data =
+            nfc_device_get_data(instance->target_dev, NfcProtocolMfClassic);
+        event.data->request_keys.dict = instance->nfc_dict_context.dict;
+    } else if(event.type == Gen2PollerEventTypeSuccess) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
+        command = NfcCommandStop;
+    } else if(event.type == Gen2PollerEventTypeFail) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerFail);
+        command = NfcCommandStop;
+    }
+
+    return command;
+}
+
+static void nfc_magic_scene_gen2_key_check_setup_view(NfcMagicApp* instance) {
+    Popup* popup = instance->popup;
+    popup_reset(popup);
+    uint32_t state =
+        scene_manager_get_scene_state(instance->scene_manager, NfcMagicSceneGen2KeyCheck);
+
+    if(state == NfcMagicSceneGen2KeyCheckStateCardSearch) {
+        popup_set_icon(instance->popup, 0, 8, &I_NFC_manual_60x50);
+        popup_set_text(
+            instance->popup, "Apply the\nsame card\nto the back", 128, 32, AlignRight, AlignCenter);
+    } else {
+        popup_set_icon(popup, 12, 23, &I_Loading_24);
+        popup_set_header(popup, "Checking keys\nDon't move...", 52, 32, AlignLeft, AlignCenter);
+    }
+
+    view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewPopup);
+}
+
+// Nonces that fail the PRNG check and keys missing from the offline pass get the RF dictionary
+static void nfc_magic_scene_gen2_key_check_finish(NfcMagicApp* instance) {
+    const MfClassicData* mfc_data =
+        nfc_device_get_data(instance->target_dev, NfcProtocolMfClassic);
+    uint8_t sectors_read = 0;
+    uint8_t keys_found = 0;
+    mf_classic_get_read_sectors_and_keys(mfc_data, &sectors_read, &keys_found);
+    uint8_t keys_total = mf_classic_get_total_sectors_num(mfc_data->type) * 2;
+
+    if(keys_found < keys_total) {
+        instance->nfc_dict_context.is_system_dict_fallback = true;
+        scene_manager_search_and_switch_to_previous_scene(
+            instance->scene_manager, NfcMagicSceneMfClassicDictAttack);
+    } else {
+        scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen2WriteCheck);
+    }
+}
+
+void nfc_magic_scene_gen2_key_check_on_enter(void* context) {
+    NfcMagicApp* instance = context;
+
+    scene_manager_set_scene_state(
+        instance->scene_manager,
+        NfcMagicSceneGen2KeyCheck,
+        NfcMagicSceneGen2KeyCheckStateCardSearch);
+    nfc_magic_scene_gen2_key_check_setup_view(instance);
+
+    nfc_magic_app_blink_start(instance);
+
+    // The whole dictionary is checked offline against nonces from the card
+    instance->nfc_dict_context.dict = keys_dict_alloc(
+        NFC_APP_MF_CLASSIC_DICT_SYSTEM_PATH, KeysDictModeOpenExisting, sizeof(MfClassicKey));
+
+    instance->gen2_poller = gen2_poller_alloc(instance->nfc);
+    gen2_poller_start(
+        instance->gen2_poller, nfc_magic_scene_gen2_key_check_poller_callback, instance);
+}
+
+bool nfc_magic_scene_gen2_key_check_on_event(void* context, SceneManagerEvent event) {
+    NfcMagicApp* instance = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == NfcMagicCustomEventCardDetected) {
+            scene_manager_set_scene_state(
+                instance->scene_manager,
+                NfcMagicSceneGen2KeyCheck,
+                NfcMagicSceneGen2KeyCheckStateCardFound);
+            nfc_magic_scene_gen2_key_check_setup_view(instance);
+            consumed = true;
+        } else if(event.event == NfcMagicCustomEventWorkerSuccess) {
+            // Up to three nonces per key not in the dictionary are kept for recovery on a computer
+            const Gen2NestedNt* nested_nts = NULL;
+            size_t nested_nt_num = gen2_poller_get_nested_nts(instance->gen2_poller, &nested_nts);
+            gen2_nonce_log_save(
+                instance->storage, NFC_APP_GEN2_NONCE_LOG_PATH, nested_nts, nested_nt_num);
+            nfc_device_set_data(
+                instance->target_dev,
+                NfcProtocolMfClassic,
+                gen2_poller_get_data(instance->gen2_poller));
+            nfc_magic_scene_gen2_key_check_finish(instance);
+            consumed = true;
+        } else if(event.event == NfcMagicCustomEventWorkerFail) {
+            nfc_magic_scene_gen2_key_check_finish(instance);
+            consumed = true;
+        }
+    }
+
+    return consumed;
+}
+
+void nfc_magic_scene_gen2_key_check_on_exit(void* context) {
+    NfcMagicApp* instance = context;
+
+    gen2_poller_stop(instance->gen2_poller);
+    gen2_poller_free(instance->gen2_poller);
+    keys_dict_free(instance->nfc_dict_context.dict);
+    scene_manager_set_scene_state(
+        instance->scene_manager,
+        NfcMagicSceneGen2KeyCheck,
+        NfcMagicSceneGen2KeyCheckStateCardSearch);
+    // Clear view
+    popup_reset(instance->popup);
+
+    nfc_magic_app_blink_stop(instance);
+}
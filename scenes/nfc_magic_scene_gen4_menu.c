@@ -2,6 +2,8 @@
 
 enum SubmenuIndex {
     SubmenuIndexWrite,
+    SubmenuIndexProvision,
+    SubmenuIndexWriteShadow,
     SubmenuIndexChangePassword,
     SubmenuIndexSetShadowMode,
     SubmenuIndexSetDirectWriteBlock0Mode,
@@ -21,6 +23,18 @@ void nfc_magic_scene_gen4_menu_on_enter(void* context) {
     Submenu* submenu = instance->submenu;
     submenu_add_item(
         submenu, "Write", SubmenuIndexWrite, nfc_magic_scene_gen4_menu_submenu_callback, instance);
+    submenu_add_item(
+        submenu,
+        "Provision from profile",
+        SubmenuIndexProvision,
+        nfc_magic_scene_gen4_menu_submenu_callback,
+        instance);
+    submenu_add_item(
+        submenu,
+        "Write shadow data",
+        SubmenuIndexWriteShadow,
+        nfc_magic_scene_gen4_menu_submenu_callback,
+        instance);
     submenu_add_item(
         submenu,
         "Change password",
@@ -76,6 +90,12 @@ bool nfc_magic_scene_gen4_menu_on_event(void* context, SceneManagerEvent event)
         if(event.event == SubmenuIndexWrite) {
             scene_manager_next_scene(instance->scene_manager, NfcMagicSceneFileSelect);
             consumed = true;
+        } else if(event.event == SubmenuIndexProvision) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen4ProfileSelect);
+            consumed = true;
+        } else if(event.event == SubmenuIndexWriteShadow) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen4ShadowSelect);
+            consumed = true;
         } else if(event.event == SubmenuIndexChangePassword) {
             scene_manager_next_scene(instance->scene_manager, NfcMagicSceneKeyInput);
             consumed = true;
@@ -0,0 +1,54 @@
+#include "../nfc_magic_app_i.h"
+
+static bool nfc_magic_scene_gen4_profile_select_load(NfcMagicApp* instance) {
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(&browser_options, GEN4_PROFILE_EXTENSION, &I_Nfc_10px);
+    browser_options.base_path = NFC_APP_FOLDER;
+    browser_options.hide_dot_files = true;
+
+    FuriString* profile_path = furi_string_alloc_set(NFC_APP_FOLDER);
+    bool loaded = false;
+
+    do {
+        // Input events and views are managed by file_browser
+        if(!dialog_file_browser_show(
+               instance->dialogs, profile_path, profile_path, &browser_options)) {
+            break;
+        }
+        if(!gen4_profile_load(
+               instance->gen4_profile, instance->storage, furi_string_get_cstr(profile_path))) {
+            dialog_message_show_storage_error(instance->dialogs, "Cannot load\nprofile file");
+            break;
+        }
+        loaded = nfc_magic_load_file(instance, instance->gen4_profile->dump_path, true);
+    } while(false);
+
+    furi_string_free(profile_path);
+
+    return loaded;
+}
+
+void nfc_magic_scene_gen4_profile_select_on_enter(void* context) {
+    NfcMagicApp* instance = context;
+
+    if(nfc_magic_scene_gen4_profile_select_load(instance)) {
+        NfcProtocol protocol = nfc_device_get_protocol(instance->source_dev);
+        if((protocol == NfcProtocolMfClassic) || (protocol == NfcProtocolMfUltralight)) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen4Provision);
+        } else {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneWrongCard);
+        }
+    } else {
+        scene_manager_previous_scene(instance->scene_manager);
+    }
+}
+
+bool nfc_magic_scene_gen4_profile_select_on_event(void* context, SceneManagerEvent event) {
+    UNUSED(context);
+    UNUSED(event);
+    return false;
+}
+
+void nfc_magic_scene_gen4_profile_select_on_exit(void* context) {
+    UNUSED(context);
+}
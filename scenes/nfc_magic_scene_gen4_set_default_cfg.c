@@ -61,6 +61,7 @@ void nfc_magic_scene_gen4_set_default_cfg_on_enter(void* context) {
 
     instance->gen4_poller = gen4_poller_alloc(instance->nfc);
     gen4_poller_set_password(instance->gen4_poller, instance->gen4_password);
+    gen4_poller_set_config_cache(instance->gen4_poller, instance->gen4_data);
     gen4_poller_start(
         instance->gen4_poller, nfc_mafic_scene_gen4_set_default_cfg_poller_callback, instance);
 }
@@ -64,6 +64,7 @@ void nfc_magic_scene_gen4_set_direct_write_block_0_mode_on_enter(void* context)
 
     instance->gen4_poller = gen4_poller_alloc(instance->nfc);
     gen4_poller_set_password(instance->gen4_poller, instance->gen4_password);
+    gen4_poller_set_config_cache(instance->gen4_poller, instance->gen4_data);
 
     gen4_poller_struct_set_direct_write_block_0_mode(
         instance->gen4_poller, direct_write_block_0_mode);
@@ -0,0 +1,44 @@
+#include "../nfc_magic_app_i.h"
+
+static bool nfc_magic_scene_gen4_shadow_select_load(NfcMagicApp* instance) {
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(&browser_options, NFC_APP_EXTENSION, &I_Nfc_10px);
+    browser_options.base_path = NFC_APP_FOLDER;
+    browser_options.hide_dot_files = true;
+
+    // Input events and views are managed by file_browser
+    bool result = dialog_file_browser_show(
+        instance->dialogs, instance->file_path, instance->file_path, &browser_options);
+
+    if(result) {
+        result = nfc_magic_load_shadow_pair(instance, instance->file_path);
+    }
+
+    return result;
+}
+
+void nfc_magic_scene_gen4_shadow_select_on_enter(void* context) {
+    NfcMagicApp* instance = context;
+
+    if(nfc_magic_scene_gen4_shadow_select_load(instance)) {
+        NfcProtocol protocol = nfc_device_get_protocol(instance->source_dev);
+        if((protocol == NfcProtocolMfClassic) || (protocol == NfcProtocolMfUltralight)) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen4ShadowWrite);
+        } else {
+            nfc_magic_free_shadow_original(instance);
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneWrongCard);
+        }
+    } else {
+        scene_manager_previous_scene(instance->scene_manager);
+    }
+}
+
+bool nfc_magic_scene_gen4_shadow_select_on_event(void* context, SceneManagerEvent event) {
+    UNUSED(context);
+    UNUSED(event);
+    return false;
+}
+
+void nfc_magic_scene_gen4_shadow_select_on_exit(void* context) {
+    UNUSED(context);
+}
@@ -0,0 +1,145 @@
+#include "../nfc_magic_app_i.h"
+
+enum {
+    NfcMagicSceneGen4ShadowWriteStateCardSearch,
+    NfcMagicSceneGen4ShadowWriteStateCardFound,
+    NfcMagicSceneGen4ShadowWriteStateDone,
+};
+
+NfcCommand
+    nfc_magic_scene_gen4_shadow_write_poller_callback(Gen4PollerEvent event, void* context) {
+    NfcMagicApp* instance = context;
+    furi_assert(event.data);
+
+    NfcCommand command = NfcCommandContinue;
+
+    if(event.type == Gen4PollerEventTypeCardDetected) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen4PollerEventTypeRequestMode) {
+        event.data->request_mode.mode = Gen4PollerModeWriteShadow;
+    } else if(event.type == Gen4PollerEventTypeRequestDataToWrite) {
+        // Card holds the .shd image, the .nfc one is what it restores to
+        NfcProtocol protocol = nfc_device_get_protocol(instance->original_dev);
+        event.data->request_data.protocol = protocol;
+        event.data->request_data.data = nfc_device_get_data(instance->original_dev, protocol);
+        event.data->request_data.diff_base = nfc_device_get_data(instance->source_dev, protocol);
+    } else if(event.type == Gen4PollerEventTypeProgress) {
+        instance->write_progress_context.blocks_written = event.data->progress.blocks_written;
+        instance->write_progress_context.blocks_total = event.data->progress.blocks_total;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen4PollerEventTypeSuccess) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
+        command = NfcCommandStop;
+    } else if(event.type == Gen4PollerEventTypeFail) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerFail);
+        command = NfcCommandStop;
+    }
+
+    return command;
+}
+
+static void nfc_magic_scene_gen4_shadow_write_setup_view(NfcMagicApp* instance) {
+    Popup* popup = instance->popup;
+    popup_reset(popup);
+    uint32_t state =
+        scene_manager_get_scene_state(instance->scene_manager, NfcMagicSceneGen4ShadowWrite);
+
+    if(state == NfcMagicSceneGen4ShadowWriteStateCardSearch) {
+        popup_set_icon(instance->popup, 0, 8, &I_NFC_manual_60x50);
+        popup_set_text(
+            instance->popup, "Apply the\nsame card\nto the back", 128, 32, AlignRight, AlignCenter);
+    } else {
+        NfcMagicAppWriteProgressContext* progress = &instance->write_progress_context;
+        snprintf(
+            instance->text_store,
+            sizeof(instance->text_store),
+            "%u/%u blocks",
+            progress->blocks_written,
+            progress->blocks_total);
+        popup_set_icon(popup, 12, 23, &I_Loading_24);
+        popup_set_header(popup, "Writing\nDon't move...", 52, 26, AlignLeft, AlignCenter);
+        popup_set_text(popup, instance->text_store, 52, 44, AlignLeft, AlignTop);
+    }
+
+    view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewPopup);
+}
+
+void nfc_magic_scene_gen4_shadow_write_on_enter(void* context) {
+    NfcMagicApp* instance = context;
+
+    memset(&instance->write_progress_context, 0, sizeof(NfcMagicAppWriteProgressContext));
+    scene_manager_set_scene_state(
+        instance->scene_manager,
+        NfcMagicSceneGen4ShadowWrite,
+        NfcMagicSceneGen4ShadowWriteStateCardSearch);
+    nfc_magic_scene_gen4_shadow_write_setup_view(instance);
+
+    nfc_magic_app_blink_start(instance);
+
+    instance->gen4_poller = gen4_poller_alloc(instance->nfc);
+    gen4_poller_set_password(instance->gen4_poller, instance->gen4_password);
+    gen4_poller_set_config_cache(instance->gen4_poller, instance->gen4_data);
+    gen4_poller_struct_set_shadow_mode(instance->gen4_poller, Gen4ShadowModeRestore);
+    gen4_poller_start(
+        instance->gen4_poller, nfc_magic_scene_gen4_shadow_write_poller_callback, instance);
+}
+
+bool nfc_magic_scene_gen4_shadow_write_on_event(void* context, SceneManagerEvent event) {
+    NfcMagicApp* instance = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if((event.event == NfcMagicCustomEventCardDetected) ||
+           (event.event == NfcMagicCustomEventWorkerProgress)) {
+            scene_manager_set_scene_state(
+                instance->scene_manager,
+                NfcMagicSceneGen4ShadowWrite,
+                NfcMagicSceneGen4ShadowWriteStateCardFound);
+            nfc_magic_scene_gen4_shadow_write_setup_view(instance);
+            consumed = true;
+        } else if(event.event == NfcMagicCustomEventCardLost) {
+            scene_manager_set_scene_state(
+                instance->scene_manager,
+                NfcMagicSceneGen4ShadowWrite,
+                NfcMagicSceneGen4ShadowWriteStateCardSearch);
+            nfc_magic_scene_gen4_shadow_write_setup_view(instance);
+            consumed = true;
+        } else if(event.event == NfcMagicCustomEventWorkerSuccess) {
+            // A failed write keeps the images for a retry, a finished one is done with them
+            scene_manager_set_scene_state(
+                instance->scene_manager,
+                NfcMagicSceneGen4ShadowWrite,
+                NfcMagicSceneGen4ShadowWriteStateDone);
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneSuccess);
+            consumed = true;
+        } else if(event.event == NfcMagicCustomEventWorkerFail) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneWriteFail);
+            consumed = true;
+        }
+    }
+
+    return consumed;
+}
+
+void nfc_magic_scene_gen4_shadow_write_on_exit(void* context) {
+    NfcMagicApp* instance = context;
+
+    gen4_poller_stop(instance->gen4_poller);
+    gen4_poller_free(instance->gen4_poller);
+    if(scene_manager_get_scene_state(instance->scene_manager, NfcMagicSceneGen4ShadowWrite) ==
+       NfcMagicSceneGen4ShadowWriteStateDone) {
+        nfc_magic_free_shadow_original(instance);
+    }
+    scene_manager_set_scene_state(
+        instance->scene_manager,
+        NfcMagicSceneGen4ShadowWrite,
+        NfcMagicSceneGen4ShadowWriteStateCardSearch);
+    // Clear view
+    popup_reset(instance->popup);
+
+    nfc_magic_app_blink_stop(instance);
+}
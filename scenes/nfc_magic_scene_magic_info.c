@@ -34,8 +34,13 @@ void nfc_magic_scene_magic_info_on_enter(void* context) {
     widget_add_text_box_element(
         widget, 0, 10, 128, 54, AlignLeft, AlignTop, furi_string_get_cstr(message), false);
 
+    instance->fingerprint = *nfc_magic_scanner_get_fingerprint(instance->scanner);
+
     if(instance->protocol == NfcMagicProtocolGen4) {
         gen4_copy(instance->gen4_data, nfc_magic_scanner_get_gen4_data(instance->scanner));
+        // Operations on this card go on with the password it answered to
+        gen4_password_copy(
+            &instance->gen4_password, nfc_magic_scanner_get_gen4_password(instance->scanner));
 
         furi_string_printf(
             message,
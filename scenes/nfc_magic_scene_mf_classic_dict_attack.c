@@ -179,10 +179,14 @@ static void nfc_magic_scene_mf_classic_dict_attack_prepare_view(NfcMagicApp* ins
 void nfc_magic_scene_mf_classic_dict_attack_on_enter(void* context) {
     NfcMagicApp* instance = context;
 
+    nfc_magic_app_dict_attack_view_alloc(instance);
+
+    // The fallback only runs the system dictionary over the keys that are still missing
     scene_manager_set_scene_state(
         instance->scene_manager,
         NfcMagicSceneMfClassicDictAttack,
-        DictAttackStateUserDictInProgress);
+        instance->nfc_dict_context.is_system_dict_fallback ? DictAttackStateSystemDictInProgress :
+                                                             DictAttackStateUserDictInProgress);
     nfc_magic_scene_mf_classic_dict_attack_prepare_view(instance);
     dict_attack_set_card_state(instance->dict_attack, true);
     view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewDictAttack);
@@ -203,6 +207,30 @@ static void nfc_magic_scene_mf_classic_dict_attack_notify_read(NfcMagicApp* inst
     }
 }
 
+// Gen2 cards let the remaining keys be checked offline once the user dict found any key.
+// Keys the offline check already missed go through the RF pass instead, never back to it.
+static bool nfc_magic_scene_mf_classic_dict_attack_is_key_check_possible(NfcMagicApp* instance) {
+    bool is_possible = false;
+
+    if((instance->protocol == NfcMagicProtocolGen2) &&
+       !instance->nfc_dict_context.is_system_dict_fallback) {
+        const MfClassicData* mfc_data = nfc_poller_get_data(instance->poller);
+        is_possible = gen2_poller_is_key_check_possible(mfc_data);
+    }
+
+    return is_possible;
+}
+
+static uint32_t nfc_magic_scene_mf_classic_dict_attack_get_gen2_scene(NfcMagicApp* instance) {
+    uint32_t scene = NfcMagicSceneGen2WriteCheck;
+
+    if(nfc_magic_scene_mf_classic_dict_attack_is_key_check_possible(instance)) {
+        scene = NfcMagicSceneGen2KeyCheck;
+    }
+
+    return scene;
+}
+
 bool nfc_magic_scene_mf_classic_dict_attack_on_event(void* context, SceneManagerEvent event) {
     NfcMagicApp* instance = context;
     bool consumed = false;
@@ -211,7 +239,11 @@ bool nfc_magic_scene_mf_classic_dict_attack_on_event(void* context, SceneManager
         scene_manager_get_scene_state(instance->scene_manager, NfcMagicSceneMfClassicDictAttack);
     if(event.type == SceneManagerEventTypeCustom) {
         if(event.event == NfcMagicAppCustomEventDictAttackComplete) {
-            if(state == DictAttackStateUserDictInProgress) {
+            if((state == DictAttackStateUserDictInProgress) &&
+               nfc_magic_scene_mf_classic_dict_attack_is_key_check_possible(instance)) {
+                scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen2KeyCheck);
+                consumed = true;
+            } else if(state == DictAttackStateUserDictInProgress) {
                 nfc_poller_stop(instance->poller);
                 nfc_poller_free(instance->poller);
                 keys_dict_free(instance->nfc_dict_context.dict);
@@ -226,6 +258,7 @@ bool nfc_magic_scene_mf_classic_dict_attack_on_event(void* context, SceneManager
             } else {
                 nfc_magic_scene_mf_classic_dict_attack_notify_read(instance);
                 if(instance->protocol == NfcMagicProtocolGen2) {
+                    // The system dictionary already went over RF, nothing is left to check
                     scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen2WriteCheck);
                 } else {
                     scene_manager_next_scene(
@@ -246,7 +279,10 @@ bool nfc_magic_scene_mf_classic_dict_attack_on_event(void* context, SceneManager
             const MfClassicData* mfc_data = nfc_poller_get_data(instance->poller);
             nfc_device_set_data(instance->target_dev, NfcProtocolMfClassic, mfc_data);
             if(state == DictAttackStateUserDictInProgress) {
-                if(instance->nfc_dict_context.is_card_present) {
+                if(instance->nfc_dict_context.is_card_present &&
+                   nfc_magic_scene_mf_classic_dict_attack_is_key_check_possible(instance)) {
+                    scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen2KeyCheck);
+                } else if(instance->nfc_dict_context.is_card_present) {
                     nfc_poller_stop(instance->poller);
                     nfc_poller_free(instance->poller);
                     keys_dict_free(instance->nfc_dict_context.dict);
@@ -261,7 +297,8 @@ bool nfc_magic_scene_mf_classic_dict_attack_on_event(void* context, SceneManager
                     nfc_magic_scene_mf_classic_dict_attack_notify_read(instance);
                     if(instance->protocol == NfcMagicProtocolGen2) {
                         scene_manager_next_scene(
-                            instance->scene_manager, NfcMagicSceneGen2WriteCheck);
+                            instance->scene_manager,
+                            nfc_magic_scene_mf_classic_dict_attack_get_gen2_scene(instance));
                     } else {
                         scene_manager_next_scene(
                             instance->scene_manager, NfcMagicSceneMfClassicWriteCheck);
@@ -272,7 +309,9 @@ bool nfc_magic_scene_mf_classic_dict_attack_on_event(void* context, SceneManager
             } else if(state == DictAttackStateSystemDictInProgress) {
                 nfc_magic_scene_mf_classic_dict_attack_notify_read(instance);
                 if(instance->protocol == NfcMagicProtocolGen2) {
-                    scene_manager_next_scene(instance->scene_manager, NfcMagicSceneGen2WriteCheck);
+                    scene_manager_next_scene(
+                        instance->scene_manager,
+                        nfc_magic_scene_mf_classic_dict_attack_get_gen2_scene(instance));
                 } else {
                     scene_manager_next_scene(
                         instance->scene_manager, NfcMagicSceneMfClassicWriteCheck);
@@ -296,7 +335,7 @@ void nfc_magic_scene_mf_classic_dict_attack_on_exit(void* context) {
     nfc_poller_stop(instance->poller);
     nfc_poller_free(instance->poller);
 
-    dict_attack_reset(instance->dict_attack);
+    nfc_magic_app_dict_attack_view_free(instance);
     scene_manager_set_scene_state(
         instance->scene_manager,
         NfcMagicSceneMfClassicDictAttack,
@@ -313,6 +352,7 @@ void nfc_magic_scene_mf_classic_dict_attack_on_exit(void* context) {
     instance->nfc_dict_context.is_key_attack = false;
     instance->nfc_dict_context.key_attack_current_sector = 0;
     instance->nfc_dict_context.is_card_present = false;
+    instance->nfc_dict_context.is_system_dict_fallback = false;
 
     nfc_magic_app_blink_stop(instance);
     notification_message(instance->notifications, &sequence_display_backlight_enforce_auto);
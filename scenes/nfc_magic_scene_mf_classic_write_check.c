@@ -57,10 +57,12 @@ void nfc_magic_scene_mf_classic_write_check_view_callback(WriteProblemsEvent eve
 void nfc_magic_scene_mf_classic_write_check_on_enter(void* context) {
     NfcMagicApp* instance = context;
 
+    nfc_magic_app_write_problems_view_alloc(instance);
+
     Gen2PollerWriteProblems problems = gen2_poller_check_target_problems(instance->target_dev);
     if(!instance->gen2_poller_is_wipe_mode) {
         problems.all_problems |=
-            gen2_poller_check_source_problems(instance->source_dev).all_problems;
+            gen2_poller_check_source_problems(instance->block_source).all_problems;
     }
     FURI_LOG_D("GEN2", "Problems: %d", problems.all_problems);
 
@@ -120,5 +122,5 @@ void nfc_magic_scene_mf_classic_write_check_on_exit(void* context) {
     instance->write_problems_context.problems_total = 0;
     instance->write_problems_context.problems.all_problems = 0;
 
-    write_problems_reset(instance->write_problems);
+    nfc_magic_app_write_problems_view_free(instance);
 }
@@ -16,8 +16,13 @@ NfcCommand nfc_magic_scene_slix_get_info_poller_callback(SlixPollerEvent event,
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
     } else if(event.type == SlixPollerEventTypeRequestMode) {
         event.data->request_mode.mode = SlixPollerModeGetInfo;
+    } else if(event.type == SlixPollerEventTypeCardDone) {
+        // Every card in the field is read, the scanned one comes first and is shown
+        if(event.data->card_done.card_index == 0) {
+            slix_copy(instance->slix_data, slix_poller_get_data(instance->slix_poller));
+        }
     } else if(event.type == SlixPollerEventTypeSuccess) {
-        slix_copy(instance->slix_data, slix_poller_get_data(instance->slix_poller));
+        instance->slix_others_failed = event.data->result.others_failed;
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
         command = NfcCommandStop;
@@ -59,8 +64,9 @@ void nfc_magic_scene_slix_get_info_on_enter(void* context) {
 
     nfc_magic_app_blink_start(instance);
 
+    instance->slix_others_failed = 0;
     instance->slix_poller = slix_poller_alloc(instance->nfc);
-    slix_poller_set_data(instance->slix_poller, instance->slix_data);
+    slix_poller_set_fingerprint(instance->slix_poller, &instance->fingerprint);
     slix_poller_start(
         instance->slix_poller, nfc_magic_scene_slix_get_info_poller_callback, instance);
 }
@@ -1,7 +1,9 @@
 #include "../nfc_magic_app_i.h"
 
 enum SubmenuIndex {
+    SubmenuIndexWrite,
     SubmenuIndexWipe,
+    SubmenuIndexDump,
     SubmenuIndexMoreInfo,
 };
 
@@ -19,8 +21,12 @@ void nfc_magic_scene_slix_menu_on_enter(void* context) {
     NfcMagicApp* instance = context;
 
     Submenu* submenu = instance->submenu;
+    submenu_add_item(
+        submenu, "Write", SubmenuIndexWrite, nfc_magic_scene_slix_menu_submenu_callback, instance);
     submenu_add_item(
         submenu, "Wipe", SubmenuIndexWipe, nfc_magic_scene_slix_menu_submenu_callback, instance);
+    submenu_add_item(
+        submenu, "Dump", SubmenuIndexDump, nfc_magic_scene_slix_menu_submenu_callback, instance);
     submenu_add_item(
         submenu,
         "More Info",
@@ -44,9 +50,15 @@ bool nfc_magic_scene_slix_menu_on_event(void* context, SceneManagerEvent event)
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        if(event.event == SubmenuIndexWipe) {
+        if(event.event == SubmenuIndexWrite) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneFileSelect);
+            consumed = true;
+        } else if(event.event == SubmenuIndexWipe) {
             scene_manager_next_scene(instance->scene_manager, NfcMagicSceneWipe);
             consumed = true;
+        } else if(event.event == SubmenuIndexDump) {
+            scene_manager_next_scene(instance->scene_manager, NfcMagicSceneDump);
+            consumed = true;
         } else if(event.event == SubmenuIndexMoreInfo) {
             scene_manager_next_scene(instance->scene_manager, NfcMagicSceneSlixGetInfo);
             consumed = true;
@@ -72,6 +72,13 @@ void nfc_magic_scene_slix_show_info_on_enter(void* context) {
     widget_add_string_element(
         widget, 3, 47, AlignLeft, AlignTop, FontSecondary, furi_string_get_cstr(temp_str));
 
+    // Only the scanned card is shown, the others are read too and may have failed
+    if(instance->slix_others_failed > 0) {
+        furi_string_printf(temp_str, "Other cards failed: %d", instance->slix_others_failed);
+        widget_add_string_element(
+            widget, 3, 57, AlignLeft, AlignTop, FontSecondary, furi_string_get_cstr(temp_str));
+    }
+
     furi_string_free(temp_str);
     view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewWidget);
 }
@@ -14,6 +14,16 @@ NfcCommand nfc_magic_scene_wipe_gen1_poller_callback(Gen1aPollerEvent event, voi
     if(event.type == Gen1aPollerEventTypeDetected) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen1aPollerEventTypeCardLost) {
+        view_dispatcher_send_custom_event(instance->view_dispatcher, NfcMagicCustomEventCardLost);
+    } else if(event.type == Gen1aPollerEventTypeResumed) {
+        instance->write_progress_context.resumed_from = event.data->resumed.block;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen1aPollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == Gen1aPollerEventTypeRequestMode) {
         event.data->request_mode.mode = Gen1aPollerModeWipe;
     } else if(event.type == Gen1aPollerEventTypeSuccess) {
@@ -37,6 +47,16 @@ NfcCommand nfc_magic_scene_wipe_gen2_poller_callback(Gen2PollerEvent event, void
     if(event.type == Gen2PollerEventTypeDetected) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen2PollerEventTypeCardLost) {
+        view_dispatcher_send_custom_event(instance->view_dispatcher, NfcMagicCustomEventCardLost);
+    } else if(event.type == Gen2PollerEventTypeResumed) {
+        instance->write_progress_context.resumed_from = event.data->resumed.block;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen2PollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == Gen2PollerEventTypeRequestMode) {
         event.data->poller_mode.mode = Gen2PollerModeWipe;
     } else if(event.type == Gen2PollerEventTypeRequestTargetData) {
@@ -65,6 +85,16 @@ NfcCommand nfc_magic_scene_wipe_gen4_poller_callback(Gen4PollerEvent event, void
     if(event.type == Gen4PollerEventTypeCardDetected) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen4PollerEventTypeCardLost) {
+        view_dispatcher_send_custom_event(instance->view_dispatcher, NfcMagicCustomEventCardLost);
+    } else if(event.type == Gen4PollerEventTypeResumed) {
+        instance->write_progress_context.resumed_from = event.data->resumed.block;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen4PollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == Gen4PollerEventTypeRequestMode) {
         event.data->request_mode.mode = Gen4PollerModeWipe;
     } else if(event.type == Gen4PollerEventTypeSuccess) {
@@ -90,6 +120,10 @@ NfcCommand nfc_magic_scene_wipe_slix_poller_callback(SlixPollerEvent event, void
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
     } else if(event.type == SlixPollerEventTypeRequestMode) {
         event.data->request_mode.mode = SlixPollerModeWipe;
+    } else if(event.type == SlixPollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == SlixPollerEventTypeSuccess) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
@@ -113,8 +147,7 @@ static void nfc_magic_scene_wipe_setup_view(NfcMagicApp* instance) {
         popup_set_text(
             instance->popup, "Apply the\nsame card\nto the back", 128, 32, AlignRight, AlignCenter);
     } else {
-        popup_set_icon(popup, 12, 23, &I_Loading_24);
-        popup_set_header(popup, "Wiping\nDon't move...", 52, 32, AlignLeft, AlignCenter);
+        nfc_magic_app_show_write_progress(instance, "Wiping\nDon't move...");
     }
 
     view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewPopup);
@@ -123,6 +156,7 @@ static void nfc_magic_scene_wipe_setup_view(NfcMagicApp* instance) {
 void nfc_magic_scene_wipe_on_enter(void* context) {
     NfcMagicApp* instance = context;
 
+    memset(&instance->write_progress_context, 0, sizeof(NfcMagicAppWriteProgressContext));
     scene_manager_set_scene_state(
         instance->scene_manager, NfcMagicSceneWipe, NfcMagicSceneWipeStateCardSearch);
     nfc_magic_scene_wipe_setup_view(instance);
@@ -131,6 +165,7 @@ void nfc_magic_scene_wipe_on_enter(void* context) {
 
     if(instance->protocol == NfcMagicProtocolGen1) {
         instance->gen1a_poller = gen1a_poller_alloc(instance->nfc);
+        gen1a_poller_set_skip_unchanged(instance->gen1a_poller, true);
         gen1a_poller_start(
             instance->gen1a_poller, nfc_magic_scene_wipe_gen1_poller_callback, instance);
     } else if(instance->protocol == NfcMagicProtocolGen2) {
@@ -144,11 +179,13 @@ void nfc_magic_scene_wipe_on_enter(void* context) {
     } else if(instance->protocol == NfcMagicProtocolGen4) {
         instance->gen4_poller = gen4_poller_alloc(instance->nfc);
         gen4_poller_set_password(instance->gen4_poller, instance->gen4_password);
+        gen4_poller_set_config_cache(instance->gen4_poller, instance->gen4_data);
+        gen4_poller_set_fingerprint(instance->gen4_poller, &instance->fingerprint);
         gen4_poller_start(
             instance->gen4_poller, nfc_magic_scene_wipe_gen4_poller_callback, instance);
     } else if(instance->protocol == NfcMagicProtocolSlix) {
         instance->slix_poller = slix_poller_alloc(instance->nfc);
-        slix_poller_set_data(instance->slix_poller, instance->slix_data);
+        slix_poller_set_fingerprint(instance->slix_poller, &instance->fingerprint);
         slix_poller_start(
             instance->slix_poller, nfc_magic_scene_wipe_slix_poller_callback, instance);
     }
@@ -159,7 +196,8 @@ bool nfc_magic_scene_wipe_on_event(void* context, SceneManagerEvent event) {
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        if(event.event == NfcMagicCustomEventCardDetected) {
+        if((event.event == NfcMagicCustomEventCardDetected) ||
+           (event.event == NfcMagicCustomEventWorkerProgress)) {
             scene_manager_set_scene_state(
                 instance->scene_manager, NfcMagicSceneWipe, NfcMagicSceneWipeStateCardFound);
             nfc_magic_scene_wipe_setup_view(instance);
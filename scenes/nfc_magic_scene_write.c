@@ -1,4 +1,5 @@
 #include "../nfc_magic_app_i.h"
+#include "magic/protocols/slix/slix.h"
 
 enum {
     NfcMagicSceneWriteStateCardSearch,
@@ -14,12 +15,20 @@ NfcCommand nfc_magic_scene_write_gen1_poller_callback(Gen1aPollerEvent event, vo
     if(event.type == Gen1aPollerEventTypeDetected) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen1aPollerEventTypeCardLost) {
+        view_dispatcher_send_custom_event(instance->view_dispatcher, NfcMagicCustomEventCardLost);
+    } else if(event.type == Gen1aPollerEventTypeResumed) {
+        instance->write_progress_context.resumed_from = event.data->resumed.block;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen1aPollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == Gen1aPollerEventTypeRequestMode) {
         event.data->request_mode.mode = Gen1aPollerModeWrite;
     } else if(event.type == Gen1aPollerEventTypeRequestDataToWrite) {
-        const MfClassicData* mfc_data =
-            nfc_device_get_data(instance->source_dev, NfcProtocolMfClassic);
-        event.data->data_to_write.mfc_data = mfc_data;
+        event.data->data_to_write.block_source = instance->block_source;
     } else if(event.type == Gen1aPollerEventTypeSuccess) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
@@ -42,12 +51,20 @@ NfcCommand nfc_magic_scene_write_gen2_poller_callback(Gen2PollerEvent event, voi
     if(event.type == Gen2PollerEventTypeDetected) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen2PollerEventTypeCardLost) {
+        view_dispatcher_send_custom_event(instance->view_dispatcher, NfcMagicCustomEventCardLost);
+    } else if(event.type == Gen2PollerEventTypeResumed) {
+        instance->write_progress_context.resumed_from = event.data->resumed.block;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen2PollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == Gen2PollerEventTypeRequestMode) {
         event.data->poller_mode.mode = Gen2PollerModeWrite;
     } else if(event.type == Gen2PollerEventTypeRequestDataToWrite) {
-        const MfClassicData* mfc_data =
-            nfc_device_get_data(instance->source_dev, NfcProtocolMfClassic);
-        event.data->data_to_write.mfc_data = mfc_data;
+        event.data->data_to_write.block_source = instance->block_source;
     } else if(event.type == Gen2PollerEventTypeRequestTargetData) {
         const MfClassicData* mfc_data =
             nfc_device_get_data(instance->target_dev, NfcProtocolMfClassic);
@@ -74,12 +91,29 @@ NfcCommand nfc_magic_scene_write_gen4_poller_callback(Gen4PollerEvent event, voi
     if(event.type == Gen4PollerEventTypeCardDetected) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == Gen4PollerEventTypeCardLost) {
+        view_dispatcher_send_custom_event(instance->view_dispatcher, NfcMagicCustomEventCardLost);
+    } else if(event.type == Gen4PollerEventTypeResumed) {
+        instance->write_progress_context.resumed_from = event.data->resumed.block;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == Gen4PollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
     } else if(event.type == Gen4PollerEventTypeRequestMode) {
         event.data->request_mode.mode = Gen4PollerModeWrite;
     } else if(event.type == Gen4PollerEventTypeRequestDataToWrite) {
-        NfcProtocol protocol = nfc_device_get_protocol(instance->source_dev);
-        event.data->request_data.protocol = protocol;
-        event.data->request_data.data = nfc_device_get_data(instance->source_dev, protocol);
+        if(nfc_magic_block_source_is_open(instance->block_source)) {
+            event.data->request_data.protocol =
+                nfc_magic_block_source_get_protocol(instance->block_source);
+            event.data->request_data.data = NULL;
+            event.data->request_data.block_source = instance->block_source;
+        } else {
+            NfcProtocol protocol = nfc_device_get_protocol(instance->source_dev);
+            event.data->request_data.protocol = protocol;
+            event.data->request_data.data = nfc_device_get_data(instance->source_dev, protocol);
+        }
     } else if(event.type == Gen4PollerEventTypeSuccess) {
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
@@ -93,6 +127,36 @@ NfcCommand nfc_magic_scene_write_gen4_poller_callback(Gen4PollerEvent event, voi
     return command;
 }
 
+NfcCommand nfc_magic_scene_write_slix_poller_callback(SlixPollerEvent event, void* context) {
+    NfcMagicApp* instance = context;
+    furi_assert(event.data);
+
+    NfcCommand command = NfcCommandContinue;
+
+    if(event.type == SlixPollerEventTypeCardDetected) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventCardDetected);
+    } else if(event.type == SlixPollerEventTypeRequestMode) {
+        event.data->request_mode.mode = SlixPollerModeWrite;
+    } else if(event.type == SlixPollerEventTypeRequestDataToWrite) {
+        event.data->data_to_write.slix_data = instance->slix_source_data;
+    } else if(event.type == SlixPollerEventTypeRetry) {
+        instance->write_progress_context.retries = event.data->retry.stats.retries;
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerProgress);
+    } else if(event.type == SlixPollerEventTypeSuccess) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
+        command = NfcCommandStop;
+    } else if(event.type == SlixPollerEventTypeFail) {
+        view_dispatcher_send_custom_event(
+            instance->view_dispatcher, NfcMagicCustomEventWorkerFail);
+        command = NfcCommandStop;
+    }
+
+    return command;
+}
+
 static void nfc_magic_scene_write_setup_view(NfcMagicApp* instance) {
     Popup* popup = instance->popup;
     popup_reset(popup);
@@ -103,8 +167,7 @@ static void nfc_magic_scene_write_setup_view(NfcMagicApp* instance) {
         popup_set_text(
             instance->popup, "Apply the\nsame card\nto the back", 128, 32, AlignRight, AlignCenter);
     } else {
-        popup_set_icon(popup, 12, 23, &I_Loading_24);
-        popup_set_header(popup, "Writing\nDon't move...", 52, 32, AlignLeft, AlignCenter);
+        nfc_magic_app_show_write_progress(instance, "Writing\nDon't move...");
     }
 
     view_dispatcher_switch_to_view(instance->view_dispatcher, NfcMagicAppViewPopup);
@@ -113,6 +176,7 @@ static void nfc_magic_scene_write_setup_view(NfcMagicApp* instance) {
 void nfc_magic_scene_write_on_enter(void* context) {
     NfcMagicApp* instance = context;
 
+    memset(&instance->write_progress_context, 0, sizeof(NfcMagicAppWriteProgressContext));
     scene_manager_set_scene_state(
         instance->scene_manager, NfcMagicSceneWrite, NfcMagicSceneWriteStateCardSearch);
     nfc_magic_scene_write_setup_view(instance);
@@ -131,9 +195,19 @@ void nfc_magic_scene_write_on_enter(void* context) {
         instance->gen2_poller = gen2_poller_alloc(instance->nfc);
         gen2_poller_start(
             instance->gen2_poller, nfc_magic_scene_write_gen2_poller_callback, instance);
+    } else if(instance->protocol == NfcMagicProtocolSlix) {
+        instance->slix_source_data = slix_alloc();
+        slix_load_from_device(instance->slix_source_data, instance->source_dev);
+        instance->slix_poller = slix_poller_alloc(instance->nfc);
+        slix_poller_set_data(instance->slix_poller, instance->slix_data);
+        slix_poller_set_fingerprint(instance->slix_poller, &instance->fingerprint);
+        slix_poller_start(
+            instance->slix_poller, nfc_magic_scene_write_slix_poller_callback, instance);
     } else {
         instance->gen4_poller = gen4_poller_alloc(instance->nfc);
         gen4_poller_set_password(instance->gen4_poller, instance->gen4_password);
+        gen4_poller_set_config_cache(instance->gen4_poller, instance->gen4_data);
+        gen4_poller_set_fingerprint(instance->gen4_poller, &instance->fingerprint);
         gen4_poller_start(
             instance->gen4_poller, nfc_magic_scene_write_gen4_poller_callback, instance);
     }
@@ -144,7 +218,8 @@ bool nfc_magic_scene_write_on_event(void* context, SceneManagerEvent event) {
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        if(event.event == NfcMagicCustomEventCardDetected) {
+        if((event.event == NfcMagicCustomEventCardDetected) ||
+           (event.event == NfcMagicCustomEventWorkerProgress)) {
             scene_manager_set_scene_state(
                 instance->scene_manager, NfcMagicSceneWrite, NfcMagicSceneWriteStateCardFound);
             nfc_magic_scene_write_setup_view(instance);
@@ -180,6 +255,11 @@ void nfc_magic_scene_write_on_exit(void* context) {
     } else if(instance->protocol == NfcMagicProtocolGen4) {
         gen4_poller_stop(instance->gen4_poller);
         gen4_poller_free(instance->gen4_poller);
+    } else if(instance->protocol == NfcMagicProtocolSlix) {
+        slix_poller_stop(instance->slix_poller);
+        slix_poller_free(instance->slix_poller);
+        slix_free(instance->slix_source_data);
+        instance->slix_source_data = NULL;
     }
     scene_manager_set_scene_state(
         instance->scene_manager, NfcMagicSceneWrite, NfcMagicSceneWriteStateCardSearch);
@@ -0,0 +1,199 @@
+#include "crypto1_recovery.h"
+
+#include <furi.h>
+
+#include <getopt.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// Keys per second of the offline checks and of the state recovery, per core and in total
+
+typedef uint64_t (*Crypto1BenchRound)(void* context, uint64_t seed);
+
+typedef struct {
+    const char* name;
+    Crypto1BenchRound round;
+    void* (*alloc)(void);
+    void (*free)(void* context);
+} Crypto1BenchCase;
+
+typedef struct {
+    const Crypto1BenchCase* bench_case;
+    atomic_bool* stop;
+    uint64_t seed;
+    uint64_t keys;
+} Crypto1BenchWorker;
+
+// Fixed nested nonce, the keys never match so every check runs to the end
+#define CRYPTO1_BENCH_CUID (0x1A2B3C4D)
+#define CRYPTO1_BENCH_NT_ENC (0x5E6F7081)
+#define CRYPTO1_BENCH_NT_PARITY (0x5)
+#define CRYPTO1_BENCH_SCALAR_KEYS (4096)
+#define CRYPTO1_BENCH_BATCH_ROUNDS (128)
+
+// Results land here so the calls being measured are not optimised out
+static volatile uint64_t crypto1_bench_sink;
+
+static uint64_t crypto1_bench_scalar(void* context, uint64_t seed) {
+    UNUSED(context);
+    uint64_t found = 0;
+    for(uint64_t key = seed; key < seed + CRYPTO1_BENCH_SCALAR_KEYS; key++) {
+        found += crypto1_check_nested_nt(
+            key, CRYPTO1_BENCH_CUID, CRYPTO1_BENCH_NT_ENC, CRYPTO1_BENCH_NT_PARITY);
+    }
+    crypto1_bench_sink += found;
+
+    return CRYPTO1_BENCH_SCALAR_KEYS;
+}
+
+static uint64_t crypto1_bench_batch(void* context, uint64_t seed) {
+    UNUSED(context);
+    uint64_t keys[CRYPTO1_BATCH_WIDTH];
+    Crypto1BatchLane found = CRYPTO1_BATCH_LANE(0);
+    for(size_t round = 0; round < CRYPTO1_BENCH_BATCH_ROUNDS; round++) {
+        for(size_t i = 0; i < CRYPTO1_BATCH_WIDTH; i++) {
+            keys[i] = seed + round * CRYPTO1_BATCH_WIDTH + i;
+        }
+        found |= crypto1_batch_check_nested_nt(
+            keys,
+            CRYPTO1_BATCH_WIDTH,
+            CRYPTO1_BENCH_CUID,
+            CRYPTO1_BENCH_NT_ENC,
+            CRYPTO1_BENCH_NT_PARITY);
+    }
+
+    crypto1_bench_sink += !crypto1_batch_lane_is_empty(found);
+
+    return CRYPTO1_BENCH_BATCH_ROUNDS * CRYPTO1_BATCH_WIDTH;
+}
+
+static void* crypto1_bench_recovery_alloc(void) {
+    return crypto1_recovery_alloc();
+}
+
+static void crypto1_bench_recovery_free(void* context) {
+    crypto1_recovery_free(context);
+}
+
+static uint64_t crypto1_bench_recovery(void* context, uint64_t seed) {
+    const Crypto1* states = NULL;
+    uint32_t ks = seed * 0x9E3779B1U;
+    uint32_t in = (seed >> 32) ^ CRYPTO1_BENCH_CUID;
+    size_t states_num = crypto1_recovery_lfsr32(context, ks, in, &states);
+
+    // A recovered state only becomes a key to check once it is rolled back
+    uint64_t keys = 0;
+    for(size_t i = 0; i < states_num; i++) {
+        keys ^= crypto1_recovery_get_key(&states[i], in);
+    }
+
+    crypto1_bench_sink += keys;
+
+    return states_num;
+}
+
+static const Crypto1BenchCase crypto1_bench_cases[] = {
+    {"scalar check", crypto1_bench_scalar, NULL, NULL},
+    {"batch check", crypto1_bench_batch, NULL, NULL},
+    {"lfsr recovery",
+     crypto1_bench_recovery,
+     crypto1_bench_recovery_alloc,
+     crypto1_bench_recovery_free},
+};
+
+static void* crypto1_bench_worker(void* context) {
+    Crypto1BenchWorker* worker = context;
+    const Crypto1BenchCase* bench_case = worker->bench_case;
+    void* case_context = bench_case->alloc ? bench_case->alloc() : NULL;
+
+    uint64_t seed = worker->seed;
+    while(!atomic_load(worker->stop)) {
+        worker->keys += bench_case->round(case_context, seed);
+        seed += 0x100000001ULL;
+    }
+
+    if(bench_case->free) bench_case->free(case_context);
+    return NULL;
+}
+
+static double
+    crypto1_bench_run(const Crypto1BenchCase* bench_case, size_t threads_num, double seconds) {
+    atomic_bool stop;
+    atomic_init(&stop, false);
+    Crypto1BenchWorker* workers = calloc(threads_num, sizeof(Crypto1BenchWorker));
+    pthread_t* threads = calloc(threads_num, sizeof(pthread_t));
+    furi_check(workers && threads);
+
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(size_t i = 0; i < threads_num; i++) {
+        workers[i].bench_case = bench_case;
+        workers[i].stop = &stop;
+        workers[i].seed = (uint64_t)i << 40;
+        furi_check(pthread_create(&threads[i], NULL, crypto1_bench_worker, &workers[i]) == 0);
+    }
+    usleep(seconds * 1e6);
+    atomic_store(&stop, true);
+
+    uint64_t keys = 0;
+    for(size_t i = 0; i < threads_num; i++) {
+        pthread_join(threads[i], NULL);
+        keys += workers[i].keys;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    free(threads);
+    free(workers);
+
+    return keys / elapsed;
+}
+
+int main(int argc, char* argv[]) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads_num = (cores > 0) ? cores : 1;
+    double seconds = 2.0;
+
+    int opt = 0;
+    while((opt = getopt(argc, argv, "t:s:")) != -1) {
+        switch(opt) {
+        case 't':
+            threads_num = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seconds = strtod(optarg, NULL);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-t threads] [-s seconds per run]\n", argv[0]);
+            return 1;
+        }
+    }
+    if((threads_num == 0) || (seconds <= 0)) {
+        fprintf(stderr, "Usage: %s [-t threads] [-s seconds per run]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-14s %16s %16s %16s\n", "", "keys/s 1 core", "keys/s total", "keys/s per core");
+    for(size_t i = 0; i < COUNT_OF(crypto1_bench_cases); i++) {
+        const Crypto1BenchCase* bench_case = &crypto1_bench_cases[i];
+        double single = crypto1_bench_run(bench_case, 1, seconds);
+        double total = crypto1_bench_run(bench_case, threads_num, seconds);
+        printf(
+            "%-14s %16.0f %16.0f %16.0f\n",
+            bench_case->name,
+            single,
+            total,
+            total / threads_num);
+    }
+    printf(
+        "%zu threads, %.1f s per run, %zu keys per batch\n",
+        threads_num,
+        seconds,
+        CRYPTO1_BATCH_WIDTH);
+
+    return 0;
+}
@@ -0,0 +1,307 @@
+#include "crypto1_recovery.h"
+
+#include <furi.h>
+
+// Algorithm from https://github.com/RfidResearchGroup/proxmark3.git (crapto1.c)
+
+#define LF_POLY_ODD (0x29CE5C)
+#define LF_POLY_EVEN (0x870804)
+
+#define BEBIT(x, n) FURI_BIT(x, (n) ^ 24)
+
+#define CRYPTO1_RECOVERY_TABLE_SIZE (1U << 21)
+#define CRYPTO1_RECOVERY_STATES_MAX (1U << 18)
+#define CRYPTO1_RECOVERY_BUCKETS (0x100)
+#define CRYPTO1_RECOVERY_BUCKET_SIZE (1U << 14)
+
+typedef struct {
+    uint32_t* head;
+    uint32_t* tail;
+} Crypto1RecoveryRange;
+
+typedef struct {
+    Crypto1RecoveryRange ranges[2][CRYPTO1_RECOVERY_BUCKETS];
+    uint32_t ranges_num;
+} Crypto1RecoveryIntersection;
+
+struct Crypto1Recovery {
+    uint32_t* odd;
+    uint32_t* even;
+    Crypto1* states;
+    // Out of place bucket sort, indexed by [list][contribution bits]
+    uint32_t* buckets[2][CRYPTO1_RECOVERY_BUCKETS];
+    uint32_t* bucket_ends[2][CRYPTO1_RECOVERY_BUCKETS];
+};
+
+static inline uint32_t crypto1_recovery_filter(uint32_t in) {
+    uint32_t out = 0;
+    out = 0xf22c0 >> (in & 0xf) & 16;
+    out |= 0x6c9c0 >> (in >> 4 & 0xf) & 8;
+    out |= 0x3c8b0 >> (in >> 8 & 0xf) & 4;
+    out |= 0x1e458 >> (in >> 12 & 0xf) & 2;
+    out |= 0x0d938 >> (in >> 16 & 0xf) & 1;
+    return FURI_BIT(0xEC57E80A, out);
+}
+
+static inline uint32_t crypto1_recovery_parity(uint32_t in) {
+    return __builtin_parity(in);
+}
+
+Crypto1Recovery* crypto1_recovery_alloc(void) {
+    Crypto1Recovery* instance = calloc(1, sizeof(Crypto1Recovery));
+    furi_check(instance);
+
+    instance->odd = malloc(sizeof(uint32_t) * CRYPTO1_RECOVERY_TABLE_SIZE);
+    instance->even = malloc(sizeof(uint32_t) * CRYPTO1_RECOVERY_TABLE_SIZE);
+    instance->states = malloc(sizeof(Crypto1) * CRYPTO1_RECOVERY_STATES_MAX);
+    furi_check(instance->odd && instance->even && instance->states);
+    for(size_t i = 0; i < 2; i++) {
+        for(size_t j = 0; j < CRYPTO1_RECOVERY_BUCKETS; j++) {
+            instance->buckets[i][j] = malloc(sizeof(uint32_t) * CRYPTO1_RECOVERY_BUCKET_SIZE);
+            furi_check(instance->buckets[i][j]);
+        }
+    }
+
+    return instance;
+}
+
+void crypto1_recovery_free(Crypto1Recovery* instance) {
+    furi_assert(instance);
+
+    for(size_t i = 0; i < 2; i++) {
+        for(size_t j = 0; j < CRYPTO1_RECOVERY_BUCKETS; j++) {
+            free(instance->buckets[i][j]);
+        }
+    }
+    free(instance->states);
+    free(instance->even);
+    free(instance->odd);
+    free(instance);
+}
+
+// Partial linear feedback contributions of a half state, kept in its top byte
+static inline void
+    crypto1_recovery_update_contribution(uint32_t* item, uint32_t mask1, uint32_t mask2) {
+    uint32_t p = *item >> 25;
+    p = p << 1 | crypto1_recovery_parity(*item & mask1);
+    p = p << 1 | crypto1_recovery_parity(*item & mask2);
+    *item = p << 24 | (*item & 0xffffff);
+}
+
+// Extend every half state by one bit, keeping those that still produce the keystream bit
+static void crypto1_recovery_extend_table(
+    uint32_t* tbl,
+    uint32_t** end,
+    uint32_t bit,
+    uint32_t mask1,
+    uint32_t mask2,
+    uint32_t in) {
+    in <<= 24;
+    for(*tbl <<= 1; tbl <= *end; *++tbl <<= 1) {
+        if(crypto1_recovery_filter(*tbl) ^ crypto1_recovery_filter(*tbl | 1)) {
+            *tbl |= crypto1_recovery_filter(*tbl) ^ bit;
+            crypto1_recovery_update_contribution(tbl, mask1, mask2);
+            *tbl ^= in;
+        } else if(crypto1_recovery_filter(*tbl) == bit) {
+            *++*end = tbl[1];
+            tbl[1] = tbl[0] | 1;
+            crypto1_recovery_update_contribution(tbl, mask1, mask2);
+            *tbl++ ^= in;
+            crypto1_recovery_update_contribution(tbl, mask1, mask2);
+            *tbl ^= in;
+        } else {
+            *tbl-- = *(*end)--;
+        }
+    }
+}
+
+// Same as crypto1_recovery_extend_table, before the feedback contributions matter
+static void crypto1_recovery_extend_table_simple(uint32_t* tbl, uint32_t** end, uint32_t bit) {
+    for(*tbl <<= 1; tbl <= *end; *++tbl <<= 1) {
+        if(crypto1_recovery_filter(*tbl) ^ crypto1_recovery_filter(*tbl | 1)) {
+            *tbl |= crypto1_recovery_filter(*tbl) ^ bit;
+        } else if(crypto1_recovery_filter(*tbl) == bit) {
+            *++*end = *++tbl;
+            *tbl = tbl[-1] | 1;
+        } else {
+            *tbl-- = *(*end)--;
+        }
+    }
+}
+
+// Group both lists by contribution bits and keep only the groups present in both
+static void crypto1_recovery_intersect(
+    Crypto1Recovery* instance,
+    uint32_t* even_head,
+    uint32_t* even_tail,
+    uint32_t* odd_head,
+    uint32_t* odd_tail,
+    Crypto1RecoveryIntersection* intersection) {
+    uint32_t* heads[2] = {even_head, odd_head};
+    uint32_t* tails[2] = {even_tail, odd_tail};
+
+    for(size_t i = 0; i < 2; i++) {
+        for(size_t j = 0; j < CRYPTO1_RECOVERY_BUCKETS; j++) {
+            instance->bucket_ends[i][j] = instance->buckets[i][j];
+        }
+        for(uint32_t* item = heads[i]; item <= tails[i]; item++) {
+            *(instance->bucket_ends[i][*item >> 24]++) = *item;
+        }
+    }
+
+    for(size_t i = 0; i < 2; i++) {
+        uint32_t* out = heads[i];
+        uint32_t ranges_num = 0;
+        for(size_t j = 0; j < CRYPTO1_RECOVERY_BUCKETS; j++) {
+            if((instance->bucket_ends[0][j] == instance->buckets[0][j]) ||
+               (instance->bucket_ends[1][j] == instance->buckets[1][j])) {
+                continue;
+            }
+            intersection->ranges[i][ranges_num].head = out;
+            for(uint32_t* item = instance->buckets[i][j]; item < instance->bucket_ends[i][j];
+                item++) {
+                *out++ = *item;
+            }
+            intersection->ranges[i][ranges_num].tail = out - 1;
+            ranges_num++;
+        }
+        intersection->ranges_num = ranges_num;
+    }
+}
+
+// Narrow both half state lists 4 keystream bits at a time, then pair the survivors up
+static Crypto1* crypto1_recovery_recover(
+    Crypto1Recovery* instance,
+    uint32_t* odd_head,
+    uint32_t* odd_tail,
+    uint32_t oks,
+    uint32_t* even_head,
+    uint32_t* even_tail,
+    uint32_t eks,
+    int rem,
+    Crypto1* states,
+    uint32_t in) {
+    if(rem == -1) {
+        for(uint32_t* e = even_head; e <= even_tail; e++) {
+            *e = *e << 1 ^ crypto1_recovery_parity(*e & LF_POLY_EVEN) ^ !!(in & 4);
+            for(uint32_t* o = odd_head; o <= odd_tail; o++) {
+                furi_check(states < instance->states + CRYPTO1_RECOVERY_STATES_MAX);
+                states->even = *o;
+                states->odd = *e ^ crypto1_recovery_parity(*o & LF_POLY_ODD);
+                states++;
+            }
+        }
+        return states;
+    }
+
+    for(uint8_t i = 0; i < 4 && rem--; i++) {
+        oks >>= 1;
+        eks >>= 1;
+        in >>= 2;
+        crypto1_recovery_extend_table(
+            odd_head, &odd_tail, oks & 1, LF_POLY_EVEN << 1 | 1, LF_POLY_ODD << 1, 0);
+        if(odd_head > odd_tail) return states;
+
+        crypto1_recovery_extend_table(
+            even_head, &even_tail, eks & 1, LF_POLY_ODD, LF_POLY_EVEN << 1 | 1, in & 3);
+        if(even_head > even_tail) return states;
+    }
+
+    Crypto1RecoveryIntersection intersection;
+    crypto1_recovery_intersect(instance, even_head, even_tail, odd_head, odd_tail, &intersection);
+
+    for(int32_t i = (int32_t)intersection.ranges_num - 1; i >= 0; i--) {
+        states = crypto1_recovery_recover(
+            instance,
+            intersection.ranges[1][i].head,
+            intersection.ranges[1][i].tail,
+            oks,
+            intersection.ranges[0][i].head,
+            intersection.ranges[0][i].tail,
+            eks,
+            rem,
+            states,
+            in);
+    }
+
+    return states;
+}
+
+size_t crypto1_recovery_lfsr32(
+    Crypto1Recovery* instance,
+    uint32_t ks,
+    uint32_t in,
+    const Crypto1** states) {
+    furi_assert(instance);
+    furi_assert(states);
+
+    // Odd keystream bits come from the odd half of the state, even ones from the even half
+    uint32_t oks = 0;
+    uint32_t eks = 0;
+    for(int8_t i = 31; i >= 0; i -= 2) {
+        oks = oks << 1 | BEBIT(ks, i);
+    }
+    for(int8_t i = 30; i >= 0; i -= 2) {
+        eks = eks << 1 | BEBIT(ks, i);
+    }
+
+    // Every 20 bit half state whose filter gives the first bit of its keystream half
+    uint32_t* odd_tail = instance->odd - 1;
+    uint32_t* even_tail = instance->even - 1;
+    for(int32_t i = 1 << 20; i >= 0; i--) {
+        if(crypto1_recovery_filter(i) == (oks & 1)) *++odd_tail = i;
+        if(crypto1_recovery_filter(i) == (eks & 1)) *++even_tail = i;
+    }
+
+    for(uint8_t i = 0; i < 4; i++) {
+        crypto1_recovery_extend_table_simple(instance->odd, &odd_tail, (oks >>= 1) & 1);
+        crypto1_recovery_extend_table_simple(instance->even, &even_tail, (eks >>= 1) & 1);
+    }
+
+    // The lists now cover 10 keystream bits, from here on the fed word matters too
+    in = (in >> 16 & 0xff) | (in << 16) | (in & 0xff00);
+    Crypto1* states_end = crypto1_recovery_recover(
+        instance,
+        instance->odd,
+        odd_tail,
+        oks,
+        instance->even,
+        even_tail,
+        eks,
+        11,
+        instance->states,
+        in << 1);
+
+    *states = instance->states;
+    return states_end - instance->states;
+}
+
+static void crypto1_recovery_rollback_bit(Crypto1* state, uint32_t in) {
+    state->odd &= 0xffffff;
+    FURI_SWAP(state->odd, state->even);
+
+    uint32_t out = state->even & 1;
+    out ^= LF_POLY_EVEN & (state->even >>= 1);
+    out ^= LF_POLY_ODD & state->odd;
+    out ^= !!in;
+
+    state->even |= crypto1_recovery_parity(out) << 23;
+}
+
+uint64_t crypto1_recovery_get_key(const Crypto1* state, uint32_t in) {
+    furi_assert(state);
+
+    Crypto1 rollback = *state;
+    for(int8_t i = 31; i >= 0; i--) {
+        crypto1_recovery_rollback_bit(&rollback, BEBIT(in, i));
+    }
+
+    // Inverse of crypto1_init
+    uint64_t key = 0;
+    for(int8_t i = 23; i >= 0; i--) {
+        key = key << 1 | FURI_BIT(rollback.odd, i ^ 3);
+        key = key << 1 | FURI_BIT(rollback.even, i ^ 3);
+    }
+
+    return key;
+}
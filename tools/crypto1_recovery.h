@@ -0,0 +1,44 @@
+#pragma once
+
+#include <magic/protocols/gen2/crypto1.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Crypto1 state recovery from 32 keystream bits, lfsr_recovery32 of crapto1 (proxmark3).
+// Host only: a workspace takes about 50 MB, allocate one per thread and reuse it.
+
+typedef struct Crypto1Recovery Crypto1Recovery;
+
+Crypto1Recovery* crypto1_recovery_alloc(void);
+
+void crypto1_recovery_free(Crypto1Recovery* instance);
+
+/**
+ * @brief Find every cipher state that outputs ks while in is fed unencrypted.
+ *
+ * @param instance Workspace.
+ * @param ks 32 keystream bits, in crypto1_word() bit order.
+ * @param in Word fed while ks was generated.
+ * @param states Set to the recovered states, right after the 32 bits. Valid until the next call.
+ * @return Number of states.
+ */
+size_t crypto1_recovery_lfsr32(
+    Crypto1Recovery* instance,
+    uint32_t ks,
+    uint32_t in,
+    const Crypto1** states);
+
+/**
+ * @brief Roll a state back over one word and return the key it was initialised with.
+ *
+ * @param state State right after the word.
+ * @param in Word fed unencrypted at that time.
+ * @return 48 bit key.
+ */
+uint64_t crypto1_recovery_get_key(const Crypto1* state, uint32_t in);
+
+#ifdef __cplusplus
+}
+#endif
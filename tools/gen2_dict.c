@@ -0,0 +1,110 @@
+#include "gen2_dict.h"
+
+#include <furi.h>
+#include <magic/protocols/gen2/crypto1.h>
+
+#include <ctype.h>
+#include <stdio.h>
+
+#define GEN2_DICT_LINE_MAX (256)
+#define GEN2_DICT_KEY_DIGITS (12)
+
+bool gen2_dict_parse_line(const char* line, uint64_t* key) {
+    furi_assert(line);
+    furi_assert(key);
+
+    while(isspace((unsigned char)*line)) line++;
+
+    uint64_t value = 0;
+    size_t digits = 0;
+    for(; isxdigit((unsigned char)*line); line++, digits++) {
+        char c = tolower((unsigned char)*line);
+        value = (value << 4) | (uint64_t)(isdigit((unsigned char)c) ? c - '0' : c - 'a' + 10);
+    }
+    while(isspace((unsigned char)*line)) line++;
+
+    bool parsed = (digits == GEN2_DICT_KEY_DIGITS) && (*line == '\0');
+    if(parsed) {
+        *key = value;
+    }
+
+    return parsed;
+}
+
+bool gen2_dict_load(const char* path, Gen2Dict* dict) {
+    furi_assert(path);
+    furi_assert(dict);
+
+    memset(dict, 0, sizeof(Gen2Dict));
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        perror(path);
+        return false;
+    }
+
+    char line[GEN2_DICT_LINE_MAX];
+    while(fgets(line, sizeof(line), file)) {
+        uint64_t key = 0;
+        if(!gen2_dict_parse_line(line, &key)) continue;
+
+        if(dict->keys_num == dict->keys_capacity) {
+            dict->keys_capacity = dict->keys_capacity ? dict->keys_capacity * 2 : 256;
+            dict->keys = realloc(dict->keys, sizeof(uint64_t) * dict->keys_capacity);
+            furi_check(dict->keys);
+        }
+        dict->keys[dict->keys_num++] = key;
+    }
+    fclose(file);
+
+    return true;
+}
+
+void gen2_dict_free(Gen2Dict* dict) {
+    furi_assert(dict);
+
+    free(dict->keys);
+    memset(dict, 0, sizeof(Gen2Dict));
+}
+
+size_t gen2_dict_check(
+    const Gen2NestedNonce* nonces,
+    size_t nonces_num,
+    const Gen2Dict* dict,
+    uint64_t* keys,
+    size_t keys_max) {
+    furi_assert(nonces);
+    furi_assert(nonces_num > 0);
+    furi_assert(dict);
+    furi_assert(keys || (keys_max == 0));
+
+    size_t keys_num = 0;
+    for(size_t offset = 0; offset < dict->keys_num; offset += CRYPTO1_BATCH_WIDTH) {
+        const uint64_t* batch = &dict->keys[offset];
+        size_t batch_num = MIN(dict->keys_num - offset, (size_t)CRYPTO1_BATCH_WIDTH);
+
+        Crypto1BatchLane passed = crypto1_batch_check_nested_nt(
+            batch, batch_num, nonces[0].cuid, nonces[0].nt1_enc, nonces[0].par1);
+        for(size_t i = 1; (i < nonces_num) && !crypto1_batch_lane_is_empty(passed); i++) {
+            passed &= crypto1_batch_check_nested_nt(
+                batch, batch_num, nonces[i].cuid, nonces[i].nt1_enc, nonces[i].par1);
+        }
+
+        for(size_t lane = 0; lane < batch_num; lane++) {
+            if(!crypto1_batch_lane_get(passed, lane)) continue;
+
+            bool is_valid = true;
+            for(size_t i = 0; (i < nonces_num) && is_valid; i++) {
+                is_valid = crypto1_check_nested_nt(
+                    batch[lane], nonces[i].cuid, nonces[i].nt1_enc, nonces[i].par1);
+            }
+            if(is_valid) {
+                if(keys_num < keys_max) {
+                    keys[keys_num] = batch[lane];
+                }
+                keys_num++;
+            }
+        }
+    }
+
+    return keys_num;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "gen2_nested.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Offline dictionary check for the nonces the Gen2 key check saves to .gen2_nested.log
+
+typedef struct {
+    uint64_t* keys;
+    size_t keys_num;
+    size_t keys_capacity;
+} Gen2Dict;
+
+/**
+ * @brief Parse one line of a key dictionary, 12 hex digits as in mf_classic_dict.nfc.
+ *
+ * @return true if the line holds a key, false for comments, blank and malformed lines.
+ */
+bool gen2_dict_parse_line(const char* line, uint64_t* key);
+
+/**
+ * @brief Load a key dictionary, lines that hold no key are skipped.
+ *
+ * @return true if the file could be read.
+ */
+bool gen2_dict_load(const char* path, Gen2Dict* dict);
+
+void gen2_dict_free(Gen2Dict* dict);
+
+/**
+ * @brief Find the dictionary keys that decrypt every nonce of a group to a PRNG nonce.
+ *
+ * Keys are filtered a batch at a time, every lane that passes is checked again on its own.
+ *
+ * @param nonces Nonces of one card, sector and key type.
+ * @param nonces_num Number of nonces, at least one.
+ * @param dict Keys to check.
+ * @param keys Keys that passed, up to keys_max are stored.
+ * @param keys_max Size of keys.
+ * @return Number of keys that passed, may be more than were stored.
+ */
+size_t gen2_dict_check(
+    const Gen2NestedNonce* nonces,
+    size_t nonces_num,
+    const Gen2Dict* dict,
+    uint64_t* keys,
+    size_t keys_max);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+#include "gen2_dict.h"
+
+#include <furi.h>
+
+#include <stdio.h>
+#include <time.h>
+
+// Checks a key dictionary against the nonces the Gen2 key check saved to
+// /ext/nfc/.gen2_nested.log, without a card. Keys it prints can be added to the user dictionary.
+
+#define GEN2_DICT_CHECK_KEYS_PRINT_MAX (8)
+
+static double gen2_dict_check_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void gen2_dict_check_group(
+    const Gen2NestedNonce* nonces,
+    size_t nonces_num,
+    const Gen2Dict* dict) {
+    const Gen2NestedNonce* first = &nonces[0];
+    printf(
+        "Sec %u key %c cuid %08X: %zu nonce%s\n",
+        first->sector,
+        (first->key_type == MfClassicKeyTypeA) ? 'A' : 'B',
+        first->cuid,
+        nonces_num,
+        (nonces_num == 1) ? "" : "s");
+
+    uint64_t keys[GEN2_DICT_CHECK_KEYS_PRINT_MAX];
+    double start = gen2_dict_check_now();
+    size_t keys_num = gen2_dict_check(nonces, nonces_num, dict, keys, COUNT_OF(keys));
+    double elapsed = gen2_dict_check_now() - start;
+
+    if(keys_num == 0) {
+        printf("  Not in the dictionary, try gen2_recover\n");
+    } else if(keys_num == 1) {
+        printf("  Key: %012llX\n", (unsigned long long)keys[0]);
+    } else {
+        // One nonce lets about one key in a million through, more nonces sort them out
+        printf("  %zu keys match, capture more nonces to tell them apart:\n", keys_num);
+        for(size_t i = 0; i < MIN(keys_num, COUNT_OF(keys)); i++) {
+            printf("    %012llX\n", (unsigned long long)keys[i]);
+        }
+    }
+    printf(
+        "  %zu keys in %.3f s (%.0f keys/s)\n",
+        dict->keys_num,
+        elapsed,
+        elapsed > 0 ? dict->keys_num * nonces_num / elapsed : 0.0);
+}
+
+int main(int argc, char* argv[]) {
+    if(argc != 3) {
+        fprintf(stderr, "Usage: %s <dictionary> <nonce log>\n", argv[0]);
+        return 1;
+    }
+
+    Gen2Dict dict;
+    if(!gen2_dict_load(argv[1], &dict)) return 1;
+    if(dict.keys_num == 0) {
+        fprintf(stderr, "%s: no keys\n", argv[1]);
+        gen2_dict_free(&dict);
+        return 1;
+    }
+
+    Gen2NestedLog log;
+    if(!gen2_nested_log_load(argv[2], &log)) {
+        gen2_dict_free(&dict);
+        return 1;
+    }
+
+    for(size_t i = 0; i < log.nonces_num;) {
+        size_t group_num = gen2_nested_log_get_group_size(&log, i);
+        gen2_dict_check_group(&log.nonces[i], group_num, &dict);
+        i += group_num;
+    }
+
+    gen2_nested_log_free(&log);
+    gen2_dict_free(&dict);
+
+    return 0;
+}
@@ -0,0 +1,408 @@
+#include "gen2_nested.h"
+#include "crypto1_recovery.h"
+
+#include <furi.h>
+#include <nfc/helpers/nfc_util.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+#define BEBIT(x, n) FURI_BIT(x, (n) ^ 24)
+
+// Distances still to search, the owner takes from the front and thieves halve it from the back
+typedef struct {
+    pthread_mutex_t mutex;
+    uint32_t begin;
+    uint32_t end;
+} Gen2NestedQueue;
+
+typedef struct {
+    const Gen2NestedNonce* nonces;
+    size_t nonces_num;
+    const Gen2NestedOptions* options;
+    Gen2NestedQueue* queues;
+    size_t queues_num;
+    pthread_mutex_t result_mutex;
+    Gen2NestedResult* result;
+    atomic_bool stop;
+} Gen2NestedSearch;
+
+typedef struct {
+    Gen2NestedSearch* search;
+    size_t index;
+} Gen2NestedWorker;
+
+// Every PRNG nonce and its position in the sequence, indexed by its upper half which is unique
+typedef struct {
+    uint32_t nt;
+    uint32_t index;
+} Gen2NestedPrngEntry;
+
+static Gen2NestedPrngEntry gen2_nested_prng_table[1U << 16];
+static pthread_once_t gen2_nested_prng_table_once = PTHREAD_ONCE_INIT;
+
+static void gen2_nested_prng_table_init(void) {
+    uint32_t nt = prng_successor(0x01200145, 32);
+    for(uint32_t i = 0; i < GEN2_NESTED_PRNG_PERIOD; i++) {
+        furi_check(gen2_nested_prng_table[nt >> 16].nt == 0);
+        gen2_nested_prng_table[nt >> 16].nt = nt;
+        gen2_nested_prng_table[nt >> 16].index = i;
+        nt = prng_successor(nt, 1);
+    }
+}
+
+static const Gen2NestedPrngEntry* gen2_nested_get_prng_entry(uint32_t nt) {
+    pthread_once(&gen2_nested_prng_table_once, gen2_nested_prng_table_init);
+
+    return &gen2_nested_prng_table[nt >> 16];
+}
+
+bool gen2_nested_parse_line(const char* line, Gen2NestedNonce* nonce) {
+    furi_assert(line);
+    furi_assert(nonce);
+
+    unsigned sector = 0;
+    char key = 0;
+    unsigned cuid = 0;
+    unsigned nt0 = 0;
+    unsigned nt1 = 0;
+    unsigned par1 = 0;
+    bool parsed = false;
+
+    do {
+        if(sscanf(
+               line,
+               "Sec %u key %c cuid %x nt0 %x nt1 %x par1 %x",
+               &sector,
+               &key,
+               &cuid,
+               &nt0,
+               &nt1,
+               &par1) != 6)
+            break;
+        if((key != 'A') && (key != 'B')) break;
+        if((sector > 0xff) || (par1 > 0x0f)) break;
+
+        nonce->sector = sector;
+        nonce->key_type = (key == 'A') ? MfClassicKeyTypeA : MfClassicKeyTypeB;
+        nonce->cuid = cuid;
+        nonce->nt0 = nt0;
+        nonce->nt1_enc = nt1;
+        nonce->par1 = par1;
+        parsed = true;
+    } while(false);
+
+    return parsed;
+}
+
+bool gen2_nested_is_prng_nonce(uint32_t nt) {
+    // Zero never comes out of the PRNG, and is what empty entries hold
+    return nt && (gen2_nested_get_prng_entry(nt)->nt == nt);
+}
+
+uint32_t gen2_nested_distance(uint32_t from, uint32_t to) {
+    furi_assert(gen2_nested_is_prng_nonce(from));
+    furi_assert(gen2_nested_is_prng_nonce(to));
+
+    uint32_t from_index = gen2_nested_get_prng_entry(from)->index;
+    uint32_t to_index = gen2_nested_get_prng_entry(to)->index;
+    return (to_index + GEN2_NESTED_PRNG_PERIOD - from_index) % GEN2_NESTED_PRNG_PERIOD;
+}
+
+#define GEN2_NESTED_LOG_LINE_MAX (256)
+
+static bool gen2_nested_is_same_group(const Gen2NestedNonce* a, const Gen2NestedNonce* b) {
+    return (a->cuid == b->cuid) && (a->sector == b->sector) && (a->key_type == b->key_type);
+}
+
+// Stable, so the groups and the nonces inside them keep the order of the log
+static void gen2_nested_log_group(Gen2NestedLog* log) {
+    bool* grouped = calloc(log->nonces_num + 1, sizeof(bool));
+    Gen2NestedNonce* nonces = calloc(log->nonces_num + 1, sizeof(Gen2NestedNonce));
+    furi_check(grouped && nonces);
+
+    size_t nonces_num = 0;
+    for(size_t i = 0; i < log->nonces_num; i++) {
+        if(grouped[i]) continue;
+
+        for(size_t j = i; j < log->nonces_num; j++) {
+            if(!grouped[j] && gen2_nested_is_same_group(&log->nonces[i], &log->nonces[j])) {
+                nonces[nonces_num++] = log->nonces[j];
+                grouped[j] = true;
+            }
+        }
+    }
+    memcpy(log->nonces, nonces, sizeof(Gen2NestedNonce) * log->nonces_num);
+
+    free(nonces);
+    free(grouped);
+}
+
+bool gen2_nested_log_load(const char* path, Gen2NestedLog* log) {
+    furi_assert(path);
+    furi_assert(log);
+
+    memset(log, 0, sizeof(Gen2NestedLog));
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        perror(path);
+        return false;
+    }
+
+    char line[GEN2_NESTED_LOG_LINE_MAX];
+    size_t line_num = 0;
+    while(fgets(line, sizeof(line), file)) {
+        line_num++;
+        Gen2NestedNonce nonce;
+        if(!gen2_nested_parse_line(line, &nonce)) {
+            fprintf(stderr, "%s:%zu: skipping malformed line\n", path, line_num);
+            continue;
+        }
+        if(!gen2_nested_is_prng_nonce(nonce.nt0)) {
+            fprintf(
+                stderr,
+                "%s:%zu: nt0 %08X is not a PRNG nonce, skipping\n",
+                path,
+                line_num,
+                nonce.nt0);
+            continue;
+        }
+
+        if(log->nonces_num == log->nonces_capacity) {
+            log->nonces_capacity = log->nonces_capacity ? log->nonces_capacity * 2 : 64;
+            log->nonces = realloc(log->nonces, sizeof(Gen2NestedNonce) * log->nonces_capacity);
+            furi_check(log->nonces);
+        }
+        log->nonces[log->nonces_num++] = nonce;
+    }
+    fclose(file);
+    gen2_nested_log_group(log);
+
+    return true;
+}
+
+void gen2_nested_log_free(Gen2NestedLog* log) {
+    furi_assert(log);
+
+    free(log->nonces);
+    memset(log, 0, sizeof(Gen2NestedLog));
+}
+
+size_t gen2_nested_log_get_group_size(const Gen2NestedLog* log, size_t index) {
+    furi_assert(log);
+    furi_assert(index < log->nonces_num);
+
+    size_t group_num = 1;
+    while((index + group_num < log->nonces_num) &&
+          gen2_nested_is_same_group(&log->nonces[index], &log->nonces[index + group_num])) {
+        group_num++;
+    }
+
+    return group_num;
+}
+
+static bool gen2_nested_take(Gen2NestedSearch* search, size_t index, uint32_t* dist) {
+    Gen2NestedQueue* queue = &search->queues[index];
+    bool taken = false;
+
+    pthread_mutex_lock(&queue->mutex);
+    if(queue->begin < queue->end) {
+        *dist = queue->begin++;
+        taken = true;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+
+    // Out of work: steal the back half of the first queue that still has some
+    for(size_t i = 1; (i < search->queues_num) && !taken; i++) {
+        Gen2NestedQueue* victim = &search->queues[(index + i) % search->queues_num];
+        uint32_t begin = 0;
+        uint32_t end = 0;
+
+        pthread_mutex_lock(&victim->mutex);
+        if(victim->begin < victim->end) {
+            begin = victim->begin + (victim->end - victim->begin) / 2;
+            end = victim->end;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->mutex);
+        if(begin == end) continue;
+
+        pthread_mutex_lock(&queue->mutex);
+        queue->begin = begin + 1;
+        queue->end = end;
+        pthread_mutex_unlock(&queue->mutex);
+        *dist = begin;
+        taken = true;
+    }
+
+    return taken;
+}
+
+// Parity of the first three bytes only needs the keystream, drops 7 of 8 distances
+static bool gen2_nested_check_parity(uint32_t nt, uint32_t ks, uint8_t parity) {
+    bool is_valid = true;
+    for(uint8_t i = 0; (i < 3) && is_valid; i++) {
+        uint8_t nt_byte = nt >> (24 - 8 * i);
+        is_valid = FURI_BIT(parity, i) == (nfc_util_odd_parity8(nt_byte) ^ BEBIT(ks, 8 * (i + 1)));
+    }
+
+    return is_valid;
+}
+
+static bool gen2_nested_check_distance(Gen2NestedSearch* search, uint32_t nt0, uint32_t nt1) {
+    if(!gen2_nested_is_prng_nonce(nt0) || !gen2_nested_is_prng_nonce(nt1)) return false;
+
+    uint32_t dist = gen2_nested_distance(nt0, nt1);
+    return (dist >= search->options->dist_min) && (dist <= search->options->dist_max);
+}
+
+static void gen2_nested_add_key(Gen2NestedSearch* search, uint64_t key) {
+    Gen2NestedResult* result = search->result;
+
+    pthread_mutex_lock(&search->result_mutex);
+    if(result->keys_num < GEN2_NESTED_KEYS_MAX) {
+        result->keys[result->keys_num] = key;
+    }
+    result->keys_num++;
+    if(!search->options->find_all && (search->nonces_num >= 3)) {
+        atomic_store(&search->stop, true);
+    }
+    pthread_mutex_unlock(&search->result_mutex);
+}
+
+// Confirm a batch of candidate keys against every other nonce of the group
+static void gen2_nested_verify(Gen2NestedSearch* search, const uint64_t* keys, size_t keys_num) {
+    Crypto1BatchLane passed = crypto1_batch_lane_mask(keys_num);
+
+    for(size_t i = 1; (i < search->nonces_num) && !crypto1_batch_lane_is_empty(passed); i++) {
+        const Gen2NestedNonce* nonce = &search->nonces[i];
+        passed &= crypto1_batch_check_nested_nt(
+            keys, keys_num, nonce->cuid, nonce->nt1_enc, nonce->par1);
+    }
+
+    for(size_t lane = 0; lane < keys_num; lane++) {
+        if(!crypto1_batch_lane_get(passed, lane)) continue;
+
+        bool is_valid = true;
+        for(size_t i = 1; (i < search->nonces_num) && is_valid; i++) {
+            const Gen2NestedNonce* nonce = &search->nonces[i];
+            uint32_t nt1 = crypto1_decrypt_nested_nt(keys[lane], nonce->cuid, nonce->nt1_enc);
+            is_valid = gen2_nested_check_distance(search, nonce->nt0, nt1);
+        }
+        if(is_valid) {
+            gen2_nested_add_key(search, keys[lane]);
+        }
+    }
+}
+
+static void* gen2_nested_worker(void* context) {
+    Gen2NestedWorker* worker = context;
+    Gen2NestedSearch* search = worker->search;
+    const Gen2NestedNonce* nonce = &search->nonces[0];
+    Crypto1Recovery* recovery = crypto1_recovery_alloc();
+    uint64_t recoveries = 0;
+    uint64_t candidates = 0;
+
+    // Consecutive distances are one PRNG step apart, only a jump needs the full walk
+    uint32_t dist = 0;
+    uint32_t last_dist = UINT32_MAX;
+    uint32_t nt1 = 0;
+
+    while(!atomic_load(&search->stop) && gen2_nested_take(search, worker->index, &dist)) {
+        nt1 = (dist == last_dist + 1) ? prng_successor(nt1, 1) : prng_successor(nonce->nt0, dist);
+        last_dist = dist;
+
+        uint32_t ks = nonce->nt1_enc ^ nt1;
+        if(!gen2_nested_check_parity(nt1, ks, nonce->par1)) continue;
+
+        const Crypto1* states = NULL;
+        size_t states_num = crypto1_recovery_lfsr32(recovery, ks, nt1 ^ nonce->cuid, &states);
+        recoveries++;
+
+        uint64_t keys[CRYPTO1_BATCH_WIDTH];
+        size_t keys_num = 0;
+        for(size_t i = 0; i < states_num; i++) {
+            // The bit after the word encrypts the parity of the last byte
+            Crypto1 next = states[i];
+            uint8_t ks_next = crypto1_bit(&next, 0, 0);
+            if(FURI_BIT(nonce->par1, 3) != (nfc_util_odd_parity8(nt1) ^ ks_next)) continue;
+
+            keys[keys_num++] = crypto1_recovery_get_key(&states[i], nt1 ^ nonce->cuid);
+            if(keys_num == CRYPTO1_BATCH_WIDTH) {
+                gen2_nested_verify(search, keys, keys_num);
+                keys_num = 0;
+            }
+        }
+        if(keys_num) {
+            gen2_nested_verify(search, keys, keys_num);
+        }
+        candidates += states_num;
+    }
+
+    crypto1_recovery_free(recovery);
+
+    pthread_mutex_lock(&search->result_mutex);
+    search->result->recoveries += recoveries;
+    search->result->candidates += candidates;
+    pthread_mutex_unlock(&search->result_mutex);
+
+    return NULL;
+}
+
+bool gen2_nested_recover(
+    const Gen2NestedNonce* nonces,
+    size_t nonces_num,
+    const Gen2NestedOptions* options,
+    Gen2NestedResult* result) {
+    furi_assert(nonces);
+    furi_assert(nonces_num > 0);
+    furi_assert(options);
+    furi_assert(options->threads > 0);
+    furi_assert(options->dist_min <= options->dist_max);
+    furi_assert(options->dist_max < GEN2_NESTED_PRNG_PERIOD);
+    furi_assert(result);
+
+    memset(result, 0, sizeof(Gen2NestedResult));
+
+    Gen2NestedSearch search = {
+        .nonces = nonces,
+        .nonces_num = nonces_num,
+        .options = options,
+        .queues_num = options->threads,
+        .result = result,
+    };
+    atomic_init(&search.stop, false);
+    pthread_mutex_init(&search.result_mutex, NULL);
+
+    // Split the window evenly, stealing evens out whatever the parity filter leaves uneven
+    uint32_t window = options->dist_max - options->dist_min + 1;
+    search.queues = calloc(search.queues_num, sizeof(Gen2NestedQueue));
+    Gen2NestedWorker* workers = calloc(search.queues_num, sizeof(Gen2NestedWorker));
+    pthread_t* threads = calloc(search.queues_num, sizeof(pthread_t));
+    furi_check(search.queues && workers && threads);
+
+    for(size_t i = 0; i < search.queues_num; i++) {
+        pthread_mutex_init(&search.queues[i].mutex, NULL);
+        search.queues[i].begin = options->dist_min + (uint64_t)window * i / search.queues_num;
+        search.queues[i].end = options->dist_min + (uint64_t)window * (i + 1) / search.queues_num;
+        workers[i].search = &search;
+        workers[i].index = i;
+    }
+    for(size_t i = 0; i < search.queues_num; i++) {
+        furi_check(pthread_create(&threads[i], NULL, gen2_nested_worker, &workers[i]) == 0);
+    }
+    for(size_t i = 0; i < search.queues_num; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for(size_t i = 0; i < search.queues_num; i++) {
+        pthread_mutex_destroy(&search.queues[i].mutex);
+    }
+    pthread_mutex_destroy(&search.result_mutex);
+    free(threads);
+    free(workers);
+    free(search.queues);
+
+    return result->keys_num > 0;
+}
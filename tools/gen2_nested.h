@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nfc/protocols/mf_classic/mf_classic.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Offline nested key recovery for the nonces the Gen2 key check saves to .gen2_nested.log
+
+// The tag PRNG is a 16 bit LFSR, nonces repeat after this many steps
+#define GEN2_NESTED_PRNG_PERIOD (65535U)
+#define GEN2_NESTED_KEYS_MAX (64U)
+
+typedef struct {
+    uint8_t sector;
+    MfClassicKeyType key_type;
+    uint32_t cuid;
+    // Plain nt of the known key auth, then the encrypted nested nt and its parity bits
+    uint32_t nt0;
+    uint32_t nt1_enc;
+    uint8_t par1;
+} Gen2NestedNonce;
+
+typedef struct {
+    Gen2NestedNonce* nonces;
+    size_t nonces_num;
+    size_t nonces_capacity;
+} Gen2NestedLog;
+
+typedef struct {
+    // PRNG steps from nt0 to the plain nt1, both ends included
+    uint32_t dist_min;
+    uint32_t dist_max;
+    size_t threads;
+    // Keep searching after a key matched every nonce of a group of three or more
+    bool find_all;
+} Gen2NestedOptions;
+
+typedef struct {
+    uint64_t keys[GEN2_NESTED_KEYS_MAX];
+    // Keys that matched every nonce, may be more than were stored
+    size_t keys_num;
+    uint64_t recoveries;
+    uint64_t candidates;
+} Gen2NestedResult;
+
+/**
+ * @brief Parse one line of the nonce log.
+ *
+ * @return true if the line holds a nonce.
+ */
+bool gen2_nested_parse_line(const char* line, Gen2NestedNonce* nonce);
+
+/**
+ * @brief Load a nonce log, malformed lines and nonces that did not come from the PRNG are skipped.
+ *
+ * Nonces of one card, sector and key type end up next to each other, groups keep the order in
+ * which they first appear.
+ *
+ * @return true if the file could be read.
+ */
+bool gen2_nested_log_load(const char* path, Gen2NestedLog* log);
+
+void gen2_nested_log_free(Gen2NestedLog* log);
+
+/**
+ * @brief Number of nonces in the group that starts at index.
+ */
+size_t gen2_nested_log_get_group_size(const Gen2NestedLog* log, size_t index);
+
+/**
+ * @brief Whether nt is an output of the tag PRNG.
+ */
+bool gen2_nested_is_prng_nonce(uint32_t nt);
+
+/**
+ * @brief PRNG steps from one nonce to another.
+ *
+ * @return Distance modulo GEN2_NESTED_PRNG_PERIOD, both must be PRNG nonces.
+ */
+uint32_t gen2_nested_distance(uint32_t from, uint32_t to);
+
+/**
+ * @brief Recover the key behind nested nonces of one sector, key type and card.
+ *
+ * The first nonce is searched over the distance window, every other one has to confirm the key.
+ *
+ * @param nonces Nonces of the group.
+ * @param nonces_num Number of nonces, at least one.
+ * @param options Search options.
+ * @param result Keys found and search counters.
+ * @return true if at least one key matched every nonce.
+ */
+bool gen2_nested_recover(
+    const Gen2NestedNonce* nonces,
+    size_t nonces_num,
+    const Gen2NestedOptions* options,
+    Gen2NestedResult* result);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,119 @@
+#include "gen2_nested.h"
+
+#include <furi.h>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// Recovers the keys behind the nonces the Gen2 key check saved to /ext/nfc/.gen2_nested.log
+
+#define GEN2_RECOVER_KEYS_PRINT_MAX (8)
+
+static void gen2_recover_usage(const char* name) {
+    fprintf(
+        stderr,
+        "Usage: %s [-t threads] [-d min:max] [-a] <nonce log>\n"
+        "  -t  worker threads, default: one per core\n"
+        "  -d  PRNG distance window from nt0 to nt1, default: 0:%u (whole period)\n"
+        "  -a  keep searching after a key matched three or more nonces\n",
+        name,
+        GEN2_NESTED_PRNG_PERIOD - 1);
+}
+
+static double gen2_recover_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void gen2_recover_group(
+    const Gen2NestedNonce* nonces,
+    size_t nonces_num,
+    const Gen2NestedOptions* options) {
+    const Gen2NestedNonce* first = &nonces[0];
+    printf(
+        "Sec %u key %c cuid %08X: %zu nonce%s\n",
+        first->sector,
+        (first->key_type == MfClassicKeyTypeA) ? 'A' : 'B',
+        first->cuid,
+        nonces_num,
+        (nonces_num == 1) ? "" : "s");
+    if(nonces_num < 2) {
+        printf("  Skipped: one nonce leaves thousands of keys, run the key check again\n");
+        return;
+    }
+
+    Gen2NestedResult result;
+    double start = gen2_recover_now();
+    gen2_nested_recover(nonces, nonces_num, options, &result);
+    double elapsed = gen2_recover_now() - start;
+
+    if(result.keys_num == 0) {
+        printf("  No key, try a wider -d window\n");
+    } else if(result.keys_num == 1) {
+        printf("  Key: %012llX\n", (unsigned long long)result.keys[0]);
+    } else {
+        printf("  %zu keys match, capture more nonces or narrow -d:\n", result.keys_num);
+        for(size_t i = 0; i < MIN(result.keys_num, (size_t)GEN2_RECOVER_KEYS_PRINT_MAX); i++) {
+            printf("    %012llX\n", (unsigned long long)result.keys[i]);
+        }
+    }
+    printf(
+        "  %llu recoveries, %llu candidates in %.2f s (%.0f keys/s)\n",
+        (unsigned long long)result.recoveries,
+        (unsigned long long)result.candidates,
+        elapsed,
+        elapsed > 0 ? result.candidates / elapsed : 0.0);
+}
+
+int main(int argc, char* argv[]) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    Gen2NestedOptions options = {
+        .dist_min = 0,
+        .dist_max = GEN2_NESTED_PRNG_PERIOD - 1,
+        .threads = (cores > 0) ? cores : 1,
+        .find_all = false,
+    };
+
+    int opt = 0;
+    while((opt = getopt(argc, argv, "t:d:a")) != -1) {
+        switch(opt) {
+        case 't':
+            options.threads = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            if(sscanf(optarg, "%u:%u", &options.dist_min, &options.dist_max) != 2) {
+                gen2_recover_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'a':
+            options.find_all = true;
+            break;
+        default:
+            gen2_recover_usage(argv[0]);
+            return 1;
+        }
+    }
+    if((optind != argc - 1) || (options.threads == 0) ||
+       (options.dist_min > options.dist_max) ||
+       (options.dist_max >= GEN2_NESTED_PRNG_PERIOD)) {
+        gen2_recover_usage(argv[0]);
+        return 1;
+    }
+
+    Gen2NestedLog log;
+    if(!gen2_nested_log_load(argv[optind], &log)) return 1;
+
+    for(size_t i = 0; i < log.nonces_num;) {
+        size_t group_num = gen2_nested_log_get_group_size(&log, i);
+        gen2_recover_group(&log.nonces[i], group_num, &options);
+        i += group_num;
+    }
+    gen2_nested_log_free(&log);
+
+    return 0;
+}
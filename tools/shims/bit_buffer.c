@@ -0,0 +1,101 @@
+#include <toolbox/bit_buffer.h>
+
+#include <furi.h>
+
+struct BitBuffer {
+    uint8_t* data;
+    uint8_t* parity;
+    size_t capacity_bytes;
+    size_t size_bits;
+};
+
+BitBuffer* bit_buffer_alloc(size_t capacity_bytes) {
+    furi_check(capacity_bytes > 0);
+
+    BitBuffer* buf = calloc(1, sizeof(BitBuffer));
+    buf->data = calloc(capacity_bytes, 1);
+    buf->parity = calloc((capacity_bytes + 7) / 8, 1);
+    buf->capacity_bytes = capacity_bytes;
+
+    return buf;
+}
+
+void bit_buffer_free(BitBuffer* buf) {
+    furi_check(buf);
+
+    free(buf->data);
+    free(buf->parity);
+    free(buf);
+}
+
+void bit_buffer_reset(BitBuffer* buf) {
+    furi_check(buf);
+
+    memset(buf->data, 0, buf->capacity_bytes);
+    memset(buf->parity, 0, (buf->capacity_bytes + 7) / 8);
+    buf->size_bits = 0;
+}
+
+size_t bit_buffer_get_size(const BitBuffer* buf) {
+    furi_check(buf);
+
+    return buf->size_bits;
+}
+
+size_t bit_buffer_get_size_bytes(const BitBuffer* buf) {
+    furi_check(buf);
+
+    return (buf->size_bits + 7) / 8;
+}
+
+void bit_buffer_set_size(BitBuffer* buf, size_t new_size) {
+    furi_check(buf);
+    furi_check(new_size <= buf->capacity_bytes * 8);
+
+    buf->size_bits = new_size;
+}
+
+void bit_buffer_set_size_bytes(BitBuffer* buf, size_t new_size_bytes) {
+    bit_buffer_set_size(buf, new_size_bytes * 8);
+}
+
+const uint8_t* bit_buffer_get_data(const BitBuffer* buf) {
+    furi_check(buf);
+
+    return buf->data;
+}
+
+const uint8_t* bit_buffer_get_parity(const BitBuffer* buf) {
+    furi_check(buf);
+
+    return buf->parity;
+}
+
+uint8_t bit_buffer_get_byte(const BitBuffer* buf, size_t index) {
+    furi_check(buf);
+    furi_check(index < buf->capacity_bytes);
+
+    return buf->data[index];
+}
+
+void bit_buffer_set_byte(BitBuffer* buf, size_t index, uint8_t byte) {
+    furi_check(buf);
+    furi_check(index < buf->capacity_bytes);
+
+    buf->data[index] = byte;
+}
+
+void bit_buffer_set_byte_with_parity(BitBuffer* buf, size_t index, uint8_t byte, bool parity) {
+    bit_buffer_set_byte(buf, index, byte);
+    buf->parity[index / 8] &= ~(1U << (index % 8));
+    buf->parity[index / 8] |= (uint8_t)parity << (index % 8);
+}
+
+void bit_buffer_copy_bytes(BitBuffer* buf, const uint8_t* data, size_t size_bytes) {
+    furi_check(buf);
+    furi_check(data);
+    furi_check(size_bytes <= buf->capacity_bytes);
+
+    memcpy(buf->data, data, size_bytes);
+    buf->size_bits = size_bytes * 8;
+}
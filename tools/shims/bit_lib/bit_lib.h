@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint64_t bit_lib_bytes_to_num_be(const uint8_t* src, uint8_t len) {
+    uint64_t res = 0;
+    for(uint8_t i = 0; i < len; i++) {
+        res = res << 8 | src[i];
+    }
+
+    return res;
+}
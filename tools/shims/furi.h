@@ -0,0 +1,39 @@
+#pragma once
+
+// Host stand-in for the parts of furi the portable protocol code uses
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define furi_assert(x) assert(x)
+#define furi_check(x)  assert(x)
+
+#define FURI_BIT(x, n) (((x) >> (n)) & 1)
+#define FURI_SWAP(a, b)     \
+    do {                    \
+        typeof(a) tmp_ = a; \
+        a = b;              \
+        b = tmp_;           \
+    } while(0)
+#define FURI_PACKED __attribute__((packed))
+#define UNUSED(x)   (void)(x)
+
+#ifndef COUNT_OF
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#endif
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define FURI_LOG_E(tag, ...) ((void)(tag))
+#define FURI_LOG_W(tag, ...) ((void)(tag))
+#define FURI_LOG_I(tag, ...) ((void)(tag))
+#define FURI_LOG_D(tag, ...) ((void)(tag))
+#define FURI_LOG_T(tag, ...) ((void)(tag))
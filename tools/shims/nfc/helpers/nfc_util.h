@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+static inline uint8_t nfc_util_even_parity32(uint32_t data) {
+    return __builtin_parity(data);
+}
+
+static inline uint8_t nfc_util_odd_parity8(uint8_t data) {
+    return !__builtin_parity(data);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Host stand-in with the MIFARE Classic types the access decoder uses
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MF_CLASSIC_ACCESS_BYTES_SIZE (4)
+
+typedef enum {
+    MfClassicKeyTypeA,
+    MfClassicKeyTypeB,
+} MfClassicKeyType;
+
+typedef enum {
+    MfClassicActionDataRead,
+    MfClassicActionDataWrite,
+    MfClassicActionDataInc,
+    MfClassicActionDataDec,
+
+    MfClassicActionKeyARead,
+    MfClassicActionKeyAWrite,
+    MfClassicActionKeyBRead,
+    MfClassicActionKeyBWrite,
+    MfClassicActionACRead,
+    MfClassicActionACWrite,
+} MfClassicAction;
+
+typedef struct {
+    uint8_t data[MF_CLASSIC_ACCESS_BYTES_SIZE];
+} MfClassicAccessBits;
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for the firmware BitBuffer, data and parity bits kept per byte
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct BitBuffer BitBuffer;
+
+BitBuffer* bit_buffer_alloc(size_t capacity_bytes);
+
+void bit_buffer_free(BitBuffer* buf);
+
+void bit_buffer_reset(BitBuffer* buf);
+
+size_t bit_buffer_get_size(const BitBuffer* buf);
+
+size_t bit_buffer_get_size_bytes(const BitBuffer* buf);
+
+void bit_buffer_set_size(BitBuffer* buf, size_t new_size);
+
+void bit_buffer_set_size_bytes(BitBuffer* buf, size_t new_size_bytes);
+
+const uint8_t* bit_buffer_get_data(const BitBuffer* buf);
+
+const uint8_t* bit_buffer_get_parity(const BitBuffer* buf);
+
+uint8_t bit_buffer_get_byte(const BitBuffer* buf, size_t index);
+
+void bit_buffer_set_byte(BitBuffer* buf, size_t index, uint8_t byte);
+
+void bit_buffer_set_byte_with_parity(BitBuffer* buf, size_t index, uint8_t byte, bool parity);
+
+void bit_buffer_copy_bytes(BitBuffer* buf, const uint8_t* data, size_t size_bytes);
@@ -0,0 +1,20 @@
+#pragma once
+
+// Minimal check helpers shared by the host tests
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int test_failures = 0;
+
+#define TEST_CHECK(cond, ...)                                          \
+    do {                                                               \
+        if(!(cond)) {                                                  \
+            fprintf(stderr, "%s:%d: check failed: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                              \
+            fprintf(stderr, "\n");                                     \
+            test_failures++;                                           \
+        }                                                              \
+    } while(0)
+
+#define TEST_RESULT() (test_failures ? (fprintf(stderr, "%d failures\n", test_failures), 1) : 0)
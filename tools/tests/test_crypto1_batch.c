@@ -0,0 +1,122 @@
+#include "test.h"
+#include "test_nonce.h"
+
+// The bitsliced batch has to give exactly what the scalar cipher gives for every lane
+
+#define TEST_ROUNDS (2000)
+
+static void test_batch_word(void) {
+    for(size_t round = 0; round < TEST_ROUNDS; round++) {
+        size_t keys_num = 1 + round % CRYPTO1_BATCH_WIDTH;
+        uint64_t keys[CRYPTO1_BATCH_WIDTH];
+        for(size_t i = 0; i < keys_num; i++) {
+            keys[i] = test_random_key();
+        }
+
+        Crypto1Batch batch;
+        crypto1_batch_init(&batch, keys, keys_num);
+        Crypto1 scalar[CRYPTO1_BATCH_WIDTH];
+        for(size_t i = 0; i < keys_num; i++) {
+            crypto1_init(&scalar[i], keys[i]);
+        }
+
+        // Feed a few words so the register wraps its head more than once
+        for(uint8_t word = 0; word < 4; word++) {
+            uint32_t in = test_random();
+            bool is_encrypted = (word & 1) != 0;
+            Crypto1BatchLane ks[32];
+            crypto1_batch_word(&batch, in, is_encrypted, ks);
+
+            for(size_t i = 0; i < keys_num; i++) {
+                uint32_t expected = crypto1_word(&scalar[i], in, is_encrypted);
+                uint32_t actual = 0;
+                for(uint8_t bit = 0; bit < 32; bit++) {
+                    actual |= (uint32_t)crypto1_batch_lane_get(ks[bit], i) << (24 ^ bit);
+                }
+                TEST_CHECK(
+                    actual == expected,
+                    "round %zu lane %zu word %u: %08X != %08X",
+                    round,
+                    i,
+                    word,
+                    actual,
+                    expected);
+            }
+        }
+
+        Crypto1BatchLane ks_next = crypto1_batch_bit(&batch, CRYPTO1_BATCH_LANE(0), false);
+        for(size_t i = 0; i < keys_num; i++) {
+            uint8_t expected = crypto1_bit(&scalar[i], 0, 0);
+            TEST_CHECK(
+                crypto1_batch_lane_get(ks_next, i) == expected,
+                "round %zu lane %zu: next bit",
+                round,
+                i);
+        }
+    }
+}
+
+static void test_check_nested_nt(
+    const uint64_t* keys,
+    size_t keys_num,
+    uint32_t cuid,
+    const TestNestedNonce* nonce) {
+    Crypto1BatchLane mask = crypto1_batch_check_nested_nt(
+        keys, keys_num, cuid, nonce->nt_enc, nonce->nt_enc_parity);
+
+    for(size_t i = 0; i < CRYPTO1_BATCH_WIDTH; i++) {
+        bool expected = (i < keys_num) &&
+                        crypto1_check_nested_nt(
+                            keys[i], cuid, nonce->nt_enc, nonce->nt_enc_parity);
+        TEST_CHECK(
+            crypto1_batch_lane_get(mask, i) == expected,
+            "key %012llX cuid %08X nt_enc %08X lane %zu",
+            (unsigned long long)keys[i % keys_num],
+            cuid,
+            nonce->nt_enc,
+            i);
+    }
+}
+
+static void test_batch_check_nested_nt(void) {
+    size_t hits = 0;
+    size_t parity_only = 0;
+
+    for(size_t round = 0; round < TEST_ROUNDS; round++) {
+        size_t keys_num = 1 + round % CRYPTO1_BATCH_WIDTH;
+        uint64_t keys[CRYPTO1_BATCH_WIDTH];
+        for(size_t i = 0; i < keys_num; i++) {
+            keys[i] = test_random_key();
+        }
+
+        uint32_t cuid = test_random();
+        size_t key_index = test_random() % keys_num;
+        TestNestedNonce nonce =
+            test_nested_nonce(keys[key_index], cuid, test_random_prng_nonce());
+        test_check_nested_nt(keys, keys_num, cuid, &nonce);
+        hits += crypto1_check_nested_nt(keys[key_index], cuid, nonce.nt_enc, nonce.nt_enc_parity);
+
+        // Nonce that is not a PRNG output: parity can still pass, the PRNG check must not
+        TestNestedNonce bad_nonce = test_nested_nonce(keys[key_index], cuid, test_random());
+        test_check_nested_nt(keys, keys_num, cuid, &bad_nonce);
+
+        // Same nonce with every parity pattern, some lanes pass parity by chance
+        for(uint8_t parity = 0; parity < 16; parity++) {
+            TestNestedNonce nonce_parity = nonce;
+            nonce_parity.nt_enc_parity = parity;
+            test_check_nested_nt(keys, keys_num, cuid, &nonce_parity);
+            parity_only += parity != nonce.nt_enc_parity;
+        }
+    }
+
+    // Make sure the positive path was actually exercised
+    TEST_CHECK(hits == TEST_ROUNDS, "genuine nonces accepted %zu/%d", hits, TEST_ROUNDS);
+    TEST_CHECK(parity_only > 0, "parity variations not exercised");
+}
+
+int main(void) {
+    test_batch_word();
+    test_batch_check_nested_nt();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,175 @@
+#include "test.h"
+#include "test_nonce.h"
+
+#include <bit_lib/bit_lib.h>
+#include <furi.h>
+
+// crypto1_encrypt and crypto1_encrypt_reader_nonce against the byte-at-a-time code they replaced
+
+#define TEST_ROUNDS (2000)
+#define TEST_FRAME_MAX (18)
+
+// Keystream bit of the current state, without advancing it
+static uint8_t reference_filter(const Crypto1* crypto) {
+    Crypto1 peek = *crypto;
+    return crypto1_bit(&peek, 0, 0);
+}
+
+static void
+    reference_encrypt(Crypto1* crypto, uint8_t* keystream, const BitBuffer* buff, BitBuffer* out) {
+    size_t bits = bit_buffer_get_size(buff);
+    bit_buffer_set_size(out, bits);
+    const uint8_t* plain_data = bit_buffer_get_data(buff);
+    if(bits < 8) {
+        uint8_t encrypted_byte = 0;
+        for(size_t i = 0; i < bits; i++) {
+            encrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(plain_data[0], i)) << i;
+        }
+        bit_buffer_set_byte(out, 0, encrypted_byte);
+    } else {
+        for(size_t i = 0; i < bits / 8; i++) {
+            uint8_t encrypted_byte =
+                crypto1_byte(crypto, keystream ? keystream[i] : 0, 0) ^ plain_data[i];
+            bool parity_bit =
+                ((reference_filter(crypto) ^ nfc_util_odd_parity8(plain_data[i])) & 0x01);
+            bit_buffer_set_byte_with_parity(out, i, encrypted_byte, parity_bit);
+        }
+    }
+}
+
+static void reference_encrypt_reader_nonce(
+    Crypto1* crypto,
+    uint64_t key,
+    uint32_t cuid,
+    uint8_t* nt,
+    uint8_t* nr,
+    BitBuffer* out,
+    bool is_nested) {
+    bit_buffer_set_size_bytes(out, 8);
+    uint32_t nt_num = bit_lib_bytes_to_num_be(nt, sizeof(uint32_t));
+
+    crypto1_init(crypto, key);
+    if(is_nested) {
+        nt_num = crypto1_word(crypto, nt_num ^ cuid, 1) ^ nt_num;
+    } else {
+        crypto1_word(crypto, nt_num ^ cuid, 0);
+    }
+
+    for(size_t i = 0; i < 4; i++) {
+        uint8_t byte = crypto1_byte(crypto, nr[i], 0) ^ nr[i];
+        bool parity_bit = ((reference_filter(crypto) ^ nfc_util_odd_parity8(nr[i])) & 0x01);
+        bit_buffer_set_byte_with_parity(out, i, byte, parity_bit);
+        nr[i] = byte;
+    }
+
+    nt_num = prng_successor(nt_num, 32);
+    for(size_t i = 4; i < 8; i++) {
+        nt_num = prng_successor(nt_num, 8);
+        uint8_t byte = crypto1_byte(crypto, 0, 0) ^ (uint8_t)(nt_num);
+        bool parity_bit = ((reference_filter(crypto) ^ nfc_util_odd_parity8(nt_num)) & 0x01);
+        bit_buffer_set_byte_with_parity(out, i, byte, parity_bit);
+    }
+}
+
+static bool test_buffers_equal(const BitBuffer* a, const BitBuffer* b) {
+    size_t bits = bit_buffer_get_size(a);
+    if(bits != bit_buffer_get_size(b)) return false;
+
+    size_t bytes = bit_buffer_get_size_bytes(a);
+    if(memcmp(bit_buffer_get_data(a), bit_buffer_get_data(b), bytes) != 0) return false;
+
+    // Parity only exists for whole bytes
+    const uint8_t* parity_a = bit_buffer_get_parity(a);
+    const uint8_t* parity_b = bit_buffer_get_parity(b);
+    for(size_t i = 0; i < bits / 8; i++) {
+        if(FURI_BIT(parity_a[i / 8], i % 8) != FURI_BIT(parity_b[i / 8], i % 8)) return false;
+    }
+
+    return true;
+}
+
+static void test_encrypt(void) {
+    BitBuffer* plain = bit_buffer_alloc(TEST_FRAME_MAX);
+    BitBuffer* expected = bit_buffer_alloc(TEST_FRAME_MAX);
+    BitBuffer* actual = bit_buffer_alloc(TEST_FRAME_MAX);
+
+    for(size_t round = 0; round < TEST_ROUNDS; round++) {
+        uint64_t key = test_random_key();
+        uint8_t data[TEST_FRAME_MAX];
+        uint8_t keystream[TEST_FRAME_MAX];
+        for(size_t i = 0; i < TEST_FRAME_MAX; i++) {
+            data[i] = test_random();
+            keystream[i] = test_random();
+        }
+
+        // Short frames (ACK/NAK, 4 bits), then every whole byte length
+        size_t bits = (round % 4 == 0) ? (1 + round / 4 % 7) : 8 * (1 + round % TEST_FRAME_MAX);
+        bit_buffer_reset(plain);
+        bit_buffer_copy_bytes(plain, data, (bits + 7) / 8);
+        bit_buffer_set_size(plain, bits);
+
+        bool with_keystream = (round % 3) == 0;
+        Crypto1 crypto_expected;
+        crypto1_init(&crypto_expected, key);
+        // Start from an arbitrary point of the stream, not just right after init
+        crypto1_word(&crypto_expected, test_random(), round & 1);
+        Crypto1 crypto_actual = crypto_expected;
+
+        bit_buffer_reset(expected);
+        bit_buffer_reset(actual);
+        reference_encrypt(&crypto_expected, with_keystream ? keystream : NULL, plain, expected);
+        crypto1_encrypt(&crypto_actual, with_keystream ? keystream : NULL, plain, actual);
+
+        TEST_CHECK(test_buffers_equal(expected, actual), "round %zu bits %zu: frame", round, bits);
+        TEST_CHECK(
+            crypto_expected.odd == crypto_actual.odd && crypto_expected.even == crypto_actual.even,
+            "round %zu bits %zu: state",
+            round,
+            bits);
+    }
+
+    bit_buffer_free(plain);
+    bit_buffer_free(expected);
+    bit_buffer_free(actual);
+}
+
+static void test_encrypt_reader_nonce(void) {
+    BitBuffer* expected = bit_buffer_alloc(8);
+    BitBuffer* actual = bit_buffer_alloc(8);
+
+    for(size_t round = 0; round < TEST_ROUNDS; round++) {
+        uint64_t key = test_random_key();
+        uint32_t cuid = test_random();
+        uint32_t nt_num = test_random_prng_nonce();
+        uint8_t nt[4] = {nt_num >> 24, nt_num >> 16, nt_num >> 8, nt_num};
+        uint8_t nr_expected[4] = {test_random(), test_random(), test_random(), test_random()};
+        uint8_t nr_actual[4];
+        memcpy(nr_actual, nr_expected, sizeof(nr_actual));
+        bool is_nested = (round & 1) != 0;
+
+        Crypto1 crypto_expected;
+        Crypto1 crypto_actual;
+        bit_buffer_reset(expected);
+        bit_buffer_reset(actual);
+        reference_encrypt_reader_nonce(
+            &crypto_expected, key, cuid, nt, nr_expected, expected, is_nested);
+        crypto1_encrypt_reader_nonce(&crypto_actual, key, cuid, nt, nr_actual, actual, is_nested);
+
+        TEST_CHECK(test_buffers_equal(expected, actual), "round %zu: frame", round);
+        TEST_CHECK(memcmp(nr_expected, nr_actual, sizeof(nr_actual)) == 0, "round %zu: nr", round);
+        TEST_CHECK(
+            crypto_expected.odd == crypto_actual.odd && crypto_expected.even == crypto_actual.even,
+            "round %zu: state",
+            round);
+    }
+
+    bit_buffer_free(expected);
+    bit_buffer_free(actual);
+}
+
+int main(void) {
+    test_encrypt();
+    test_encrypt_reader_nonce();
+
+    return TEST_RESULT();
+}
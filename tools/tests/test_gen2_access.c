@@ -0,0 +1,137 @@
+#include "test.h"
+
+#include <magic/protocols/gen2/gen2_access.h>
+
+// Reference: the switch based checks gen2_access replaced, kept verbatim in behaviour
+
+static uint8_t reference_trailer_conditions(const uint8_t* ab) {
+    return ((ab[1] >> 5) & 0x04) | ((ab[2] >> 2) & 0x02) | ((ab[2] >> 7) & 0x01);
+}
+
+static uint8_t reference_data_conditions(const uint8_t* ab, uint8_t sector_block) {
+    switch(sector_block) {
+    case 0x00:
+        return ((ab[1] >> 2) & 0x04) | ((ab[2] << 1) & 0x02) | ((ab[2] >> 4) & 0x01);
+    case 0x01:
+        return ((ab[1] >> 3) & 0x04) | ((ab[2] >> 0) & 0x02) | ((ab[2] >> 5) & 0x01);
+    default:
+        return ((ab[1] >> 4) & 0x04) | ((ab[2] >> 1) & 0x02) | ((ab[2] >> 6) & 0x01);
+    }
+}
+
+static bool
+    reference_trailer_allowed(uint8_t AC, MfClassicKeyType key_type, MfClassicAction action) {
+    switch(action) {
+    case MfClassicActionKeyARead:
+        return false;
+    case MfClassicActionKeyAWrite:
+    case MfClassicActionKeyBWrite:
+        return (key_type == MfClassicKeyTypeA && (AC == 0x00 || AC == 0x01)) ||
+               (key_type == MfClassicKeyTypeB &&
+                (AC == 0x00 || AC == 0x04 || AC == 0x03 || AC == 0x01));
+    case MfClassicActionKeyBRead:
+        return (key_type == MfClassicKeyTypeA && (AC == 0x00 || AC == 0x02 || AC == 0x01)) ||
+               (key_type == MfClassicKeyTypeB && (AC == 0x00 || AC == 0x02 || AC == 0x01));
+    case MfClassicActionACRead:
+        return (key_type == MfClassicKeyTypeA) || (key_type == MfClassicKeyTypeB);
+    case MfClassicActionACWrite:
+        return (key_type == MfClassicKeyTypeA && (AC == 0x01)) ||
+               (key_type == MfClassicKeyTypeB && (AC == 0x01 || AC == 0x03 || AC == 0x05));
+    default:
+        return false;
+    }
+}
+
+static bool reference_data_allowed(uint8_t AC, MfClassicKeyType key_type, MfClassicAction action) {
+    switch(action) {
+    case MfClassicActionDataRead:
+        return (key_type == MfClassicKeyTypeA && !(AC == 0x03 || AC == 0x05 || AC == 0x07)) ||
+               (key_type == MfClassicKeyTypeB && !(AC == 0x07));
+    case MfClassicActionDataWrite:
+        return (key_type == MfClassicKeyTypeA && (AC == 0x00)) ||
+               (key_type == MfClassicKeyTypeB &&
+                (AC == 0x00 || AC == 0x04 || AC == 0x06 || AC == 0x03));
+    case MfClassicActionDataInc:
+        return (key_type == MfClassicKeyTypeA && (AC == 0x00)) ||
+               (key_type == MfClassicKeyTypeB && (AC == 0x00 || AC == 0x06));
+    case MfClassicActionDataDec:
+        return (key_type == MfClassicKeyTypeA && (AC == 0x00 || AC == 0x06 || AC == 0x01)) ||
+               (key_type == MfClassicKeyTypeB && (AC == 0x00 || AC == 0x06 || AC == 0x01));
+    default:
+        return false;
+    }
+}
+
+static void test_conditions(void) {
+    // Only bytes 7 and 8 carry the positive C1C2C3 bits, walk all of them
+    for(uint32_t byte7 = 0; byte7 < 0x100; byte7++) {
+        for(uint32_t byte8 = 0; byte8 < 0x100; byte8++) {
+            MfClassicAccessBits access_bits = {{0xff, byte7, byte8, 0x69}};
+            const uint8_t* ab = access_bits.data;
+
+            for(uint8_t sector_block = 0; sector_block < GEN2_ACCESS_TRAILER_INDEX;
+                sector_block++) {
+                uint8_t expected = reference_data_conditions(ab, sector_block);
+                uint8_t actual = gen2_access_get_conditions(&access_bits, sector_block);
+                TEST_CHECK(
+                    actual == expected,
+                    "bytes %02X %02X block %u: %u != %u",
+                    (unsigned)byte7,
+                    (unsigned)byte8,
+                    sector_block,
+                    actual,
+                    expected);
+            }
+
+            uint8_t expected = reference_trailer_conditions(ab);
+            uint8_t actual = gen2_access_get_conditions(&access_bits, GEN2_ACCESS_TRAILER_INDEX);
+            TEST_CHECK(
+                actual == expected,
+                "bytes %02X %02X trailer: %u != %u",
+                (unsigned)byte7,
+                (unsigned)byte8,
+                actual,
+                expected);
+        }
+    }
+}
+
+static void test_permissions(void) {
+    for(uint8_t conditions = 0; conditions < 8; conditions++) {
+        for(MfClassicKeyType key_type = MfClassicKeyTypeA; key_type <= MfClassicKeyTypeB;
+            key_type++) {
+            for(MfClassicAction action = MfClassicActionDataRead;
+                action <= MfClassicActionACWrite;
+                action++) {
+                bool expected = reference_data_allowed(conditions, key_type, action);
+                bool actual = gen2_access_is_allowed(conditions, false, key_type, action);
+                TEST_CHECK(
+                    actual == expected,
+                    "data AC %u key %d action %d: %d != %d",
+                    conditions,
+                    key_type,
+                    action,
+                    actual,
+                    expected);
+
+                expected = reference_trailer_allowed(conditions, key_type, action);
+                actual = gen2_access_is_allowed(conditions, true, key_type, action);
+                TEST_CHECK(
+                    actual == expected,
+                    "trailer AC %u key %d action %d: %d != %d",
+                    conditions,
+                    key_type,
+                    action,
+                    actual,
+                    expected);
+            }
+        }
+    }
+}
+
+int main(void) {
+    test_conditions();
+    test_permissions();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,122 @@
+#include "test.h"
+#include "test_nonce.h"
+
+#include <gen2_dict.h>
+#include <furi.h>
+
+// Dictionary keys checked against nested nonces the way the Gen2 key check logs them
+
+#define TEST_DICT_KEYS (1000)
+#define TEST_LOG_PATH "test_gen2_dict.log"
+
+static Gen2NestedNonce test_capture(uint64_t key, uint32_t cuid, uint8_t sector) {
+    uint32_t nt0 = test_random_prng_nonce();
+    TestNestedNonce nested = test_nested_nonce(key, cuid, prng_successor(nt0, 160));
+
+    return (Gen2NestedNonce){
+        .sector = sector,
+        .key_type = MfClassicKeyTypeA,
+        .cuid = cuid,
+        .nt0 = nt0,
+        .nt1_enc = nested.nt_enc,
+        .par1 = nested.nt_enc_parity,
+    };
+}
+
+static void test_parse_line(void) {
+    uint64_t key = 0;
+    TEST_CHECK(gen2_dict_parse_line("A0a1A2a3A4a5\n", &key), "key not parsed");
+    TEST_CHECK(key == 0xa0a1a2a3a4a5ULL, "key %012llX", (unsigned long long)key);
+    TEST_CHECK(gen2_dict_parse_line("  FFFFFFFFFFFF \r\n", &key), "padded key");
+
+    TEST_CHECK(!gen2_dict_parse_line("# FFFFFFFFFFFF\n", &key), "comment");
+    TEST_CHECK(!gen2_dict_parse_line("\n", &key), "blank line");
+    TEST_CHECK(!gen2_dict_parse_line("FFFFFFFFFF\n", &key), "short key");
+    TEST_CHECK(!gen2_dict_parse_line("FFFFFFFFFFFFFF\n", &key), "long key");
+    TEST_CHECK(!gen2_dict_parse_line("FFFFFFFFFFFG\n", &key), "bad digit");
+}
+
+static void test_check(size_t nonces_num) {
+    Gen2Dict dict = {
+        .keys = calloc(TEST_DICT_KEYS, sizeof(uint64_t)),
+        .keys_num = TEST_DICT_KEYS,
+    };
+    for(size_t i = 0; i < dict.keys_num; i++) {
+        dict.keys[i] = test_random_key();
+    }
+    // Last batch and off a lane boundary for every lane width
+    size_t key_index = TEST_DICT_KEYS - 3;
+    uint64_t key = dict.keys[key_index];
+
+    uint32_t cuid = test_random();
+    Gen2NestedNonce nonces[3];
+    for(size_t i = 0; i < nonces_num; i++) {
+        nonces[i] = test_capture(key, cuid, 3);
+    }
+
+    uint64_t found[4];
+    size_t found_num = gen2_dict_check(nonces, nonces_num, &dict, found, COUNT_OF(found));
+    TEST_CHECK(
+        found_num == 1 && found[0] == key,
+        "%zu nonces: %zu keys, first %012llX, expected %012llX",
+        nonces_num,
+        found_num,
+        (unsigned long long)found[0],
+        (unsigned long long)key);
+
+    // Without the key only chance matches are left, one nonce lets about one in a million in
+    dict.keys[key_index] = test_random_key();
+    found_num = gen2_dict_check(nonces, nonces_num, &dict, found, COUNT_OF(found));
+    TEST_CHECK(found_num == 0, "%zu nonces: %zu keys without the key", nonces_num, found_num);
+
+    free(dict.keys);
+}
+
+static void test_log_load(void) {
+    uint64_t key_a = test_random_key();
+    uint64_t key_b = test_random_key();
+    uint32_t cuid = test_random();
+    Gen2NestedNonce nonces[] = {
+        test_capture(key_a, cuid, 1),
+        test_capture(key_b, cuid, 2),
+        test_capture(key_a, cuid, 1),
+    };
+
+    FILE* file = fopen(TEST_LOG_PATH, "w");
+    TEST_CHECK(file, "can't create %s", TEST_LOG_PATH);
+    if(!file) return;
+    for(size_t i = 0; i < COUNT_OF(nonces); i++) {
+        fprintf(
+            file,
+            "Sec %u key A cuid %08x nt0 %08x nt1 %08x par1 %x\n",
+            nonces[i].sector,
+            nonces[i].cuid,
+            nonces[i].nt0,
+            nonces[i].nt1_enc,
+            nonces[i].par1);
+    }
+    fprintf(file, "garbage\n");
+    fclose(file);
+
+    Gen2NestedLog log;
+    TEST_CHECK(gen2_nested_log_load(TEST_LOG_PATH, &log), "log not loaded");
+    TEST_CHECK(log.nonces_num == COUNT_OF(nonces), "%zu nonces", log.nonces_num);
+    if(log.nonces_num == COUNT_OF(nonces)) {
+        // Sector 1 first, its two nonces next to each other
+        TEST_CHECK(gen2_nested_log_get_group_size(&log, 0) == 2, "first group size");
+        TEST_CHECK(log.nonces[1].nt0 == nonces[2].nt0, "group order");
+        TEST_CHECK(gen2_nested_log_get_group_size(&log, 2) == 1, "second group size");
+        TEST_CHECK(log.nonces[2].sector == 2, "second group sector %u", log.nonces[2].sector);
+    }
+    gen2_nested_log_free(&log);
+    remove(TEST_LOG_PATH);
+}
+
+int main(void) {
+    test_parse_line();
+    test_check(1);
+    test_check(3);
+    test_log_load();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,89 @@
+#include "test.h"
+#include "test_nonce.h"
+
+#include <gen2_nested.h>
+
+// End to end: nonces captured the way the Gen2 key check does, recovered by the host search
+
+#define TEST_DIST (1337)
+
+static Gen2NestedNonce
+    test_capture(uint64_t key, uint32_t cuid, uint8_t sector, uint32_t dist, uint32_t nt0) {
+    uint32_t nt1 = prng_successor(nt0, dist);
+    TestNestedNonce nested = test_nested_nonce(key, cuid, nt1);
+
+    return (Gen2NestedNonce){
+        .sector = sector,
+        .key_type = MfClassicKeyTypeB,
+        .cuid = cuid,
+        .nt0 = nt0,
+        .nt1_enc = nested.nt_enc,
+        .par1 = nested.nt_enc_parity,
+    };
+}
+
+static void test_parse_line(void) {
+    Gen2NestedNonce nonce;
+    bool parsed = gen2_nested_parse_line(
+        "Sec 5 key B cuid 1a2b3c4d nt0 01200145 nt1 deadbeef par1 a\n", &nonce);
+    TEST_CHECK(parsed, "log line not parsed");
+    TEST_CHECK(nonce.sector == 5, "sector %u", nonce.sector);
+    TEST_CHECK(nonce.key_type == MfClassicKeyTypeB, "key type %d", nonce.key_type);
+    TEST_CHECK(nonce.cuid == 0x1a2b3c4d, "cuid %08X", nonce.cuid);
+    TEST_CHECK(nonce.nt0 == 0x01200145, "nt0 %08X", nonce.nt0);
+    TEST_CHECK(nonce.nt1_enc == 0xdeadbeef, "nt1 %08X", nonce.nt1_enc);
+    TEST_CHECK(nonce.par1 == 0xa, "par1 %X", nonce.par1);
+
+    TEST_CHECK(!gen2_nested_parse_line("Sec 5 key C cuid 0 nt0 0 nt1 0 par1 0", &nonce), "key C");
+    TEST_CHECK(!gen2_nested_parse_line("garbage", &nonce), "garbage");
+}
+
+static void test_distance(void) {
+    for(size_t i = 0; i < 100; i++) {
+        uint32_t nt0 = test_random_prng_nonce();
+        uint32_t dist = test_random() % GEN2_NESTED_PRNG_PERIOD;
+        uint32_t nt1 = prng_successor(nt0, dist);
+        TEST_CHECK(gen2_nested_is_prng_nonce(nt0), "nt0 %08X", nt0);
+        TEST_CHECK(gen2_nested_distance(nt0, nt1) == dist, "nt0 %08X dist %u", nt0, dist);
+    }
+    TEST_CHECK(!gen2_nested_is_prng_nonce(0), "zero nonce");
+    TEST_CHECK(!gen2_nested_is_prng_nonce(0xdeadbeef), "random nonce");
+}
+
+static void test_recover(size_t nonces_num, size_t threads) {
+    uint64_t key = test_random_key();
+    uint32_t cuid = test_random();
+    Gen2NestedNonce nonces[3];
+    for(size_t i = 0; i < nonces_num; i++) {
+        // Timing jitter moves the nested nonce a few steps between captures
+        nonces[i] = test_capture(key, cuid, 4, TEST_DIST + i * 3, test_random_prng_nonce());
+    }
+
+    Gen2NestedOptions options = {
+        .dist_min = TEST_DIST - 16,
+        .dist_max = TEST_DIST + 16,
+        .threads = threads,
+        .find_all = true,
+    };
+    Gen2NestedResult result;
+    bool found = gen2_nested_recover(nonces, nonces_num, &options, &result);
+
+    TEST_CHECK(found, "%zu nonces: key %012llX not found", nonces_num, (unsigned long long)key);
+    TEST_CHECK(
+        result.keys_num == 1 && result.keys[0] == key,
+        "%zu nonces: %zu keys, first %012llX, expected %012llX",
+        nonces_num,
+        result.keys_num,
+        (unsigned long long)result.keys[0],
+        (unsigned long long)key);
+    TEST_CHECK(result.recoveries > 0, "no recoveries counted");
+}
+
+int main(void) {
+    test_parse_line();
+    test_distance();
+    test_recover(2, 1);
+    test_recover(3, 4);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,39 @@
+#include "test.h"
+
+#include <magic/protocols/gen4/gen4.h>
+
+#include <string.h>
+
+// Packing probe: only bytes of the pages after the first one may decide it
+
+static void test_mfu_frame_proves_packing(void) {
+    uint8_t data[GEN4_BLOCK_SIZE];
+    for(size_t i = 0; i < sizeof(data); i++) {
+        data[i] = 0xA0 + i;
+    }
+
+    uint8_t before[GEN4_BLOCK_SIZE];
+    memcpy(before, data, sizeof(before));
+    TEST_CHECK(!gen4_mfu_frame_proves_packing(before, data), "same frame");
+
+    // Page N is written whatever the firmware does with the rest
+    for(size_t i = 0; i < GEN4_MFU_PAGE_SIZE; i++) {
+        memcpy(before, data, sizeof(before));
+        before[i] ^= 0xff;
+        TEST_CHECK(!gen4_mfu_frame_proves_packing(before, data), "page N byte %zu", i);
+    }
+    memset(before, 0, GEN4_MFU_PAGE_SIZE);
+    TEST_CHECK(!gen4_mfu_frame_proves_packing(before, data), "whole page N");
+
+    for(size_t i = GEN4_MFU_PAGE_SIZE; i < GEN4_BLOCK_SIZE; i++) {
+        memcpy(before, data, sizeof(before));
+        before[i] ^= 0x01;
+        TEST_CHECK(gen4_mfu_frame_proves_packing(before, data), "pages N+1..N+3 byte %zu", i);
+    }
+}
+
+int main(void) {
+    test_mfu_frame_proves_packing();
+
+    return TEST_RESULT();
+}
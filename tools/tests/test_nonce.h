@@ -0,0 +1,52 @@
+#pragma once
+
+// Deterministic inputs for the crypto1 tests: random keys and genuine nested nonces
+
+#include <magic/protocols/gen2/crypto1.h>
+#include <nfc/helpers/nfc_util.h>
+
+static uint64_t test_random_state = 0x9e3779b97f4a7c15ULL;
+
+static inline uint64_t test_random(void) {
+    // xorshift64*, good enough to spread keys and nonces
+    test_random_state ^= test_random_state >> 12;
+    test_random_state ^= test_random_state << 25;
+    test_random_state ^= test_random_state >> 27;
+    return test_random_state * 0x2545f4914f6cdd1dULL;
+}
+
+static inline uint64_t test_random_key(void) {
+    return test_random() & 0xffffffffffffULL;
+}
+
+typedef struct {
+    uint32_t nt;
+    uint32_t nt_enc;
+    uint8_t nt_enc_parity;
+} TestNestedNonce;
+
+// Encrypt a tag nonce the way a card answers a nested auth with the given key
+static inline TestNestedNonce test_nested_nonce(uint64_t key, uint32_t cuid, uint32_t nt) {
+    TestNestedNonce nonce = {.nt = nt};
+    Crypto1 crypto;
+    crypto1_init(&crypto, key);
+
+    for(uint8_t i = 0; i < 4; i++) {
+        uint8_t nt_byte = nt >> (24 - 8 * i);
+        uint8_t cuid_byte = cuid >> (24 - 8 * i);
+        uint8_t ks = crypto1_byte(&crypto, nt_byte ^ cuid_byte, 0);
+        nonce.nt_enc |= (uint32_t)(nt_byte ^ ks) << (24 - 8 * i);
+
+        // The parity bit is encrypted with the next keystream bit, peek at it on a copy
+        Crypto1 peek = crypto;
+        uint8_t parity = nfc_util_odd_parity8(nt_byte) ^ crypto1_bit(&peek, 0, 0);
+        nonce.nt_enc_parity |= parity << i;
+    }
+
+    return nonce;
+}
+
+// Any 32 bit window of the tag PRNG once it is past its seed
+static inline uint32_t test_random_prng_nonce(void) {
+    return prng_successor(test_random(), 32 + test_random() % 65535);
+}